@@ -0,0 +1,127 @@
+/*
+ * BatchDecodeBenchmark.ino
+ *
+ * Сравнение пакетного разбора ProtocolUtils::decodeBatch (столбцы, без
+ * PacketData) с поштучным ProtocolUtils::unpackPacket.
+ * Выводит кадров/с для обоих способов.
+ *
+ * CC1101 не требуется.
+ */
+
+#include <ProtocolUtils.h>
+
+// Конфигурация
+#if defined(__AVR__)
+const size_t FRAME_COUNT = 8; // Количество кадров в буфере (мало ОЗУ)
+#else
+const size_t FRAME_COUNT = 64;
+#endif
+const uint16_t ITERATIONS = 200; // Количество проходов по буферу
+
+// Буфер кадров с префиксом длины: len, raw[len], ...
+uint8_t buffer[FRAME_COUNT * (ProtocolConstants::MAX_PACKET_SIZE + 1)];
+size_t bufferSize = 0;
+
+// Столбцы результата
+uint16_t destColumn[FRAME_COUNT];
+uint16_t srcColumn[FRAME_COUNT];
+uint8_t commandColumn[FRAME_COUNT];
+uint32_t statusColumn[FRAME_COUNT];
+uint32_t offsetColumn[FRAME_COUNT];
+uint8_t lengthColumn[FRAME_COUNT];
+uint8_t validBitmap[(FRAME_COUNT + 7) / 8];
+uint8_t dataArena[FRAME_COUNT * ProtocolConstants::MAX_DATA_SIZE];
+
+PacketData packet;
+volatile uint32_t sink = 0; // Не дает компилятору выбросить вычисления
+
+void printRate(const char *name, uint32_t elapsedUs) {
+    float const frames = static_cast<float>(FRAME_COUNT) * ITERATIONS;
+    Serial.print(name);
+    Serial.print(": ");
+    Serial.print(frames * 1000000.0f / elapsedUs, 0);
+    Serial.println(" кадров/с");
+}
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    Serial.println("=== Mirlib BatchDecodeBenchmark ===");
+
+    // Подготовка ответов ReadStatus разной длины
+    randomSeed(42);
+    for (size_t i = 0; i < FRAME_COUNT; i++) {
+        packet.params.direction = 0;
+        packet.destAddress = ProtocolConstants::ADDR_CLIENT;
+        packet.srcAddress = random(1, 0xFFFF);
+        packet.command = 0x05;
+        packet.passwordOrStatus = random(0x7FFFFFFF);
+        packet.dataSize = random(ProtocolConstants::MAX_DATA_SIZE + 1);
+        for (uint8_t j = 0; j < packet.dataSize; j++) {
+            packet.data[j] = random(256);
+        }
+
+        if (!ProtocolUtils::packPacket(packet)) {
+            Serial.println("❌ Ошибка упаковки пакета");
+            return;
+        }
+
+        buffer[bufferSize++] = packet.rawSize;
+        memcpy(buffer + bufferSize, packet.rawPacket, packet.rawSize);
+        bufferSize += packet.rawSize;
+    }
+
+    PacketBatch batch;
+    batch.destAddress = destColumn;
+    batch.srcAddress = srcColumn;
+    batch.command = commandColumn;
+    batch.passwordOrStatus = statusColumn;
+    batch.dataOffset = offsetColumn;
+    batch.dataLength = lengthColumn;
+    batch.valid = validBitmap;
+    batch.data = dataArena;
+    batch.capacity = FRAME_COUNT;
+
+    // Проверка совпадения результатов
+    ProtocolUtils::decodeBatch(buffer, bufferSize, batch);
+    size_t position = 0;
+    for (size_t i = 0; i < batch.count; i++) {
+        size_t const rawSize = buffer[position];
+        bool const ok = ProtocolUtils::unpackPacket(buffer + position + 1, rawSize, packet);
+        position += rawSize + 1;
+
+        if (ok != batch.isValid(i) ||
+            (ok && (packet.srcAddress != srcColumn[i] || packet.dataSize != lengthColumn[i] ||
+                    memcmp(packet.data, dataArena + offsetColumn[i], packet.dataSize) != 0))) {
+            Serial.println("❌ decodeBatch не совпадает с unpackPacket");
+            return;
+        }
+    }
+    Serial.print("Кадров в буфере: ");
+    Serial.print(batch.count);
+    Serial.print(", корректных: ");
+    Serial.println(batch.validCount);
+
+    // Поштучный разбор
+    uint32_t start = micros();
+    for (uint16_t n = 0; n < ITERATIONS; n++) {
+        position = 0;
+        while (position < bufferSize) {
+            size_t const rawSize = buffer[position];
+            sink += ProtocolUtils::unpackPacket(buffer + position + 1, rawSize, packet);
+            position += rawSize + 1;
+        }
+    }
+    printRate("unpackPacket", micros() - start);
+
+    // Пакетный разбор
+    start = micros();
+    for (uint16_t n = 0; n < ITERATIONS; n++) {
+        sink += ProtocolUtils::decodeBatch(buffer, bufferSize, batch);
+    }
+    printRate("decodeBatch ", micros() - start);
+}
+
+void loop() {
+}
@@ -0,0 +1,84 @@
+/*
+ * Crc8Benchmark.ino
+ *
+ * Замер производительности уровней CRC8 (Crc8Engine):
+ * побитовый, табличный и (кроме AVR) slice-by-4 / slice-by-8.
+ * Выводит байт/такт и такты/байт для каждого уровня.
+ *
+ * CC1101 не требуется.
+ */
+
+#include <Crc8Engine.h>
+
+// Конфигурация
+const size_t BUFFER_SIZE = 64; // Размер буфера (максимальный размер пакета)
+const uint16_t ITERATIONS = 2000; // Количество проходов на каждый уровень
+
+uint8_t buffer[BUFFER_SIZE];
+volatile uint8_t sink = 0; // Не дает компилятору выбросить вычисления
+
+typedef uint8_t (*Crc8Func)(uint8_t crc, const uint8_t *data, size_t length);
+
+/**
+ * @brief Текущее значение счетчика тактов
+ */
+uint32_t readCycles() {
+#if defined(ESP32)
+    return ESP.getCycleCount();
+#else
+    return micros() * (F_CPU / 1000000UL);
+#endif
+}
+
+void runTier(const char *name, Crc8Func func) {
+    uint32_t const start = readCycles();
+    for (uint16_t i = 0; i < ITERATIONS; i++) {
+        sink ^= func(0, buffer, BUFFER_SIZE);
+    }
+    uint32_t const cycles = readCycles() - start;
+
+    float const bytes = static_cast<float>(BUFFER_SIZE) * ITERATIONS;
+    Serial.print(name);
+    Serial.print(": ");
+    Serial.print(bytes / cycles, 4);
+    Serial.print(" байт/такт, ");
+    Serial.print(cycles / bytes, 2);
+    Serial.println(" тактов/байт");
+}
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    Serial.println("=== Mirlib Crc8Benchmark ===");
+
+    randomSeed(42);
+    for (size_t i = 0; i < BUFFER_SIZE; i++) {
+        buffer[i] = random(256);
+    }
+
+    // Проверка совпадения всех уровней с эталонным побитовым
+    uint8_t const reference = Crc8Engine::updateBitwise(0, buffer, BUFFER_SIZE);
+    if (Crc8Engine::updateTable(0, buffer, BUFFER_SIZE) != reference) {
+        Serial.println("❌ TABLE не совпадает с BITWISE");
+    }
+#ifdef MIRLIB_CRC8_HAS_SLICING
+    if (Crc8Engine::updateSlice4(0, buffer, BUFFER_SIZE) != reference ||
+        Crc8Engine::updateSlice8(0, buffer, BUFFER_SIZE) != reference) {
+        Serial.println("❌ SLICE не совпадает с BITWISE");
+    }
+#endif
+
+    Serial.print("Активный уровень MIRLIB_CRC8_TIER: ");
+    Serial.println(MIRLIB_CRC8_TIER);
+
+    runTier("BITWISE", Crc8Engine::updateBitwise);
+    runTier("TABLE  ", Crc8Engine::updateTable);
+#ifdef MIRLIB_CRC8_HAS_SLICING
+    runTier("SLICE4 ", Crc8Engine::updateSlice4);
+    runTier("SLICE8 ", Crc8Engine::updateSlice8);
+#endif
+}
+
+void loop() {
+}
@@ -0,0 +1,680 @@
+/*
+ * mirlib_bench.cpp
+ *
+ * Микробенчмарки горячих путей кодека для хостовой сборки (GCC):
+ * CRC8, байт-стаффинг, упаковка/разбор кадров, команды и createResponsePacket,
+ * а также обмен клиент-сервер через LoopbackRadio (без радиомодуля).
+ * Для каждого замера выводит ns/op, байт/с и число выделений памяти на операцию
+ * в формате JSON, чтобы результаты разных версий можно было сравнивать.
+ *
+ * Использование: mirlib_bench [--filter подстрока] [--min-time мс] [--repeats N] [--out файл]
+ */
+
+#include <Arduino.h>
+#include <ProtocolUtils.h>
+#include <Crc8Engine.h>
+#include <StuffingEngine.h>
+#include <FrameUnstuffer.h>
+#include <Commands/PingCommand.h>
+#include <Commands/ReadStatusCommand.h>
+#include <Commands/ReadDateTimeCommand.h>
+#include <Commands/ReadInstantValueCommand.h>
+#include <Commands/GetInfoCommand.h>
+#include <MirlibClient.h>
+#include <MirlibClientPool.h>
+#include <MirlibServer.h>
+#include <LoopbackRadio.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    // Счетчик выделений памяти (в замерах обмена работает и поток сервера)
+    std::atomic<unsigned long long> g_allocations(0);
+}
+
+#ifdef __GLIBC__
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t count, size_t size);
+extern "C" void *__libc_realloc(void *ptr, size_t size);
+
+// Перехват malloc: учитываются и operator new, и прямые вызовы malloc
+extern "C" void *malloc(size_t size) {
+    g_allocations++;
+    return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t count, size_t size) {
+    g_allocations++;
+    return __libc_calloc(count, size);
+}
+
+extern "C" void *realloc(void *ptr, size_t size) {
+    g_allocations++;
+    return __libc_realloc(ptr, size);
+}
+#else
+// Без glibc учитывается только operator new
+void *operator new(size_t size) {
+    g_allocations++;
+    void *ptr = malloc(size != 0 ? size : 1);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void *operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept {
+    free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+    free(ptr);
+}
+#endif
+
+namespace {
+    typedef std::chrono::steady_clock Clock;
+
+    /**
+     * @brief Не дает компилятору выбросить результат
+     */
+    template<typename T>
+    inline void keep(const T &value) {
+        asm volatile("" : : "r"(&value) : "memory");
+    }
+
+    struct Options {
+        std::string filter;
+        double minTimeMs;
+        int repeats;
+        std::string out;
+    };
+
+    struct Result {
+        std::string name;
+        unsigned long long iterations;
+        double nsPerOp;
+        size_t bytesPerOp;
+        double allocationsPerOp;
+    };
+
+    class Runner {
+    public:
+        explicit Runner(const Options &options) : m_options(options), m_allocations(0) {
+        }
+
+        /**
+         * @brief Замер одной операции
+         * @param name Имя замера
+         * @param bytesPerOp Байт, обрабатываемых за операцию (0 - байт/с не считается)
+         * @param op Операция
+         */
+        template<typename Op>
+        void run(const char *name, size_t bytesPerOp, Op op) {
+            if (!m_options.filter.empty() && std::string(name).find(m_options.filter) == std::string::npos) {
+                return;
+            }
+
+            // Прогрев и подбор числа итераций под минимальное время замера
+            double const minTimeNs = m_options.minTimeMs * 1e6;
+            unsigned long long iterations = 1;
+            for (;;) {
+                double const ns = measure(op, iterations);
+                if (ns >= minTimeNs || iterations >= (1ULL << 40)) {
+                    break;
+                }
+                iterations *= (ns < minTimeNs / 10) ? 10 : 2;
+            }
+
+            // Медиана по повторам, выделения считаются только внутри замеров
+            std::vector<double> samples;
+            samples.reserve(m_options.repeats);
+            m_allocations = 0;
+            for (int i = 0; i < m_options.repeats; i++) {
+                samples.push_back(measure(op, iterations) / static_cast<double>(iterations));
+            }
+            std::sort(samples.begin(), samples.end());
+
+            Result result;
+            result.name = name;
+            result.iterations = iterations;
+            result.nsPerOp = samples[samples.size() / 2];
+            result.bytesPerOp = bytesPerOp;
+            result.allocationsPerOp = static_cast<double>(m_allocations) /
+                                      (static_cast<double>(iterations) * m_options.repeats);
+            m_results.push_back(result);
+
+            fprintf(stderr, "%-44s %10.2f ns/op\n", name, result.nsPerOp);
+        }
+
+        const std::vector<Result> &results() const { return m_results; }
+
+    private:
+        template<typename Op>
+        double measure(Op &op, unsigned long long iterations) {
+            unsigned long long const allocationsBefore = g_allocations;
+            Clock::time_point const start = Clock::now();
+            for (unsigned long long i = 0; i < iterations; i++) {
+                op();
+            }
+            Clock::time_point const end = Clock::now();
+            m_allocations += g_allocations - allocationsBefore;
+            return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+        }
+
+        const Options &m_options;
+        std::vector<Result> m_results;
+        unsigned long long m_allocations;
+    };
+
+    /**
+     * @brief Запись результатов в JSON
+     */
+    void writeJson(FILE *out, const std::vector<Result> &results) {
+        fprintf(out, "{\n");
+        fprintf(out, "  \"benchmark\": \"mirlib_bench\",\n");
+        fprintf(out, "  \"compiler\": \"%s\",\n", __VERSION__);
+        fprintf(out, "  \"crc8_tier\": %d,\n", MIRLIB_CRC8_TIER);
+#ifdef MIRLIB_STUFFING_NO_SIMD
+        fprintf(out, "  \"stuffing_simd\": false,\n");
+#else
+        fprintf(out, "  \"stuffing_simd\": true,\n");
+#endif
+#ifdef MIRLIB_KEYSTREAM_NO_SIMD
+        fprintf(out, "  \"keystream_simd\": false,\n");
+#else
+        fprintf(out, "  \"keystream_simd\": true,\n");
+#endif
+        fprintf(out, "  \"results\": [\n");
+        for (size_t i = 0; i < results.size(); i++) {
+            const Result &result = results[i];
+            double const bytesPerSecond = result.bytesPerOp != 0
+                                              ? result.bytesPerOp * 1e9 / result.nsPerOp
+                                              : 0.0;
+            fprintf(out, "    {\"name\": \"%s\", \"iterations\": %llu, \"ns_per_op\": %.3f, "
+                         "\"bytes_per_op\": %zu, \"bytes_per_second\": %.0f, \"allocations_per_op\": %.3f}%s\n",
+                    result.name.c_str(), result.iterations, result.nsPerOp, result.bytesPerOp,
+                    bytesPerSecond, result.allocationsPerOp, (i + 1 < results.size()) ? "," : "");
+        }
+        fprintf(out, "  ]\n");
+        fprintf(out, "}\n");
+    }
+
+    /**
+     * @brief Типичные данные: случайные байты, изредка 0x55/0x73
+     */
+    void fillTypical(uint8_t *data, size_t size) {
+        uint32_t seed = 0x12345678;
+        for (size_t i = 0; i < size; i++) {
+            seed = seed * 1103515245u + 12345u;
+            uint8_t value = static_cast<uint8_t>(seed >> 16);
+            if (value == 0x55 || value == 0x73) {
+                value ^= 0x01;
+            }
+            data[i] = value;
+        }
+        if (size > 8) {
+            data[size / 3] = 0x55;
+            data[2 * size / 3] = 0x73;
+        }
+    }
+
+    /**
+     * @brief Худший случай: каждый байт требует стаффинга
+     */
+    void fillWorst(uint8_t *data, size_t size) {
+        for (size_t i = 0; i < size; i++) {
+            data[i] = (i & 1) ? 0x73 : 0x55;
+        }
+    }
+
+    void benchCrc(Runner &runner) {
+        static uint8_t data[ProtocolConstants::MAX_PACKET_SIZE];
+        fillTypical(data, sizeof(data));
+
+        runner.run("crc8/frame43", 43, [&]() {
+            uint8_t const crc = ProtocolUtils::calculateCRC8(data, 43);
+            keep(crc);
+        });
+        runner.run("crc8/buffer64", sizeof(data), [&]() {
+            uint8_t const crc = ProtocolUtils::calculateCRC8(data, sizeof(data));
+            keep(crc);
+        });
+    }
+
+    void benchStuffing(Runner &runner) {
+        static const size_t SIZE = ProtocolConstants::HEADER_SIZE + ProtocolConstants::MAX_DATA_SIZE + 1;
+        static uint8_t typical[SIZE];
+        static uint8_t worst[SIZE];
+        static uint8_t stuffedTypical[2 * SIZE];
+        static uint8_t stuffedWorst[2 * SIZE];
+        static uint8_t output[2 * SIZE];
+        fillTypical(typical, SIZE);
+        fillWorst(worst, SIZE);
+        size_t const typicalSize = ProtocolUtils::byteStuffing(typical, SIZE, stuffedTypical, sizeof(stuffedTypical));
+        size_t const worstSize = ProtocolUtils::byteStuffing(worst, SIZE, stuffedWorst, sizeof(stuffedWorst));
+
+        runner.run("byteStuffing/typical", SIZE, [&]() {
+            size_t const size = ProtocolUtils::byteStuffing(typical, SIZE, output, sizeof(output));
+            keep(size);
+        });
+        runner.run("byteStuffing/worst", SIZE, [&]() {
+            size_t const size = ProtocolUtils::byteStuffing(worst, SIZE, output, sizeof(output));
+            keep(size);
+        });
+        runner.run("byteUnstuffing/typical", typicalSize, [&]() {
+            size_t const size = ProtocolUtils::byteUnstuffing(stuffedTypical, typicalSize, output, sizeof(output));
+            keep(size);
+        });
+        runner.run("byteUnstuffing/worst", worstSize, [&]() {
+            size_t const size = ProtocolUtils::byteUnstuffing(stuffedWorst, worstSize, output, sizeof(output));
+            keep(size);
+        });
+    }
+
+    void makePacket(PacketData &packet, const uint8_t *data, uint8_t dataSize) {
+        packet.clear();
+        packet.params.direction = 0;
+        packet.params.dataLength = dataSize;
+        packet.destAddress = 0xFFFF;
+        packet.srcAddress = 0x1234;
+        packet.command = CMD_READ_STATUS;
+        packet.passwordOrStatus = 0;
+        packet.dataSize = dataSize;
+        memcpy(packet.data, data, dataSize);
+    }
+
+    // Наибольшие данные из 0x55/0x73, кадр с которыми помещается в MAX_PACKET_SIZE после стаффинга
+    const uint8_t WORST_DATA_SIZE = (ProtocolConstants::MAX_PACKET_SIZE - ProtocolConstants::FRAMING_SIZE -
+                                     ProtocolConstants::HEADER_SIZE - 2) / 2;
+
+    void benchPackets(Runner &runner) {
+        static uint8_t typical[ProtocolConstants::MAX_DATA_SIZE];
+        static uint8_t worst[ProtocolConstants::MAX_DATA_SIZE];
+        fillTypical(typical, sizeof(typical));
+        fillWorst(worst, sizeof(worst));
+
+        static PacketData typicalPacket;
+        static PacketData worstPacket;
+        makePacket(typicalPacket, typical, ReadStatusResponseNew::SIZE);
+        makePacket(worstPacket, worst, WORST_DATA_SIZE);
+        if (!ProtocolUtils::packPacket(typicalPacket) || !ProtocolUtils::packPacket(worstPacket)) {
+            fprintf(stderr, "packPacket failed on benchmark packets\n");
+            return;
+        }
+
+        size_t const typicalSize = ProtocolConstants::HEADER_SIZE + typicalPacket.dataSize + 1;
+        size_t const worstSize = ProtocolConstants::HEADER_SIZE + worstPacket.dataSize + 1;
+        runner.run("packPacket/typical", typicalSize, [&]() {
+            bool const ok = ProtocolUtils::packPacket(typicalPacket);
+            keep(ok);
+        });
+        runner.run("packPacket/worst", worstSize, [&]() {
+            bool const ok = ProtocolUtils::packPacket(worstPacket);
+            keep(ok);
+        });
+
+        static PacketData output;
+        runner.run("unpackPacket/typical", typicalPacket.rawSize, [&]() {
+            bool const ok = ProtocolUtils::unpackPacket(typicalPacket.rawPacket, typicalPacket.rawSize, output);
+            keep(ok);
+        });
+        runner.run("unpackPacket/worst", worstPacket.rawSize, [&]() {
+            bool const ok = ProtocolUtils::unpackPacket(worstPacket.rawPacket, worstPacket.rawSize, output);
+            keep(ok);
+        });
+
+        static uint8_t frame[ProtocolConstants::MAX_PACKET_SIZE];
+        runner.run("PacketView::decode/typical", typicalPacket.rawSize, [&]() {
+            PacketView view;
+            bool const ok = view.decode(typicalPacket.rawPacket, typicalPacket.rawSize, frame);
+            keep(ok);
+        });
+
+        static FrameUnstuffer unstuffer;
+        runner.run("FrameUnstuffer::feed/typical", typicalPacket.rawSize, [&]() {
+            size_t consumed = 0;
+            FrameUnstuffer::Result const result = unstuffer.feed(typicalPacket.rawPacket, typicalPacket.rawSize,
+                                                                 consumed);
+            keep(result);
+        });
+
+        // Ответ на запрос ReadStatus
+        static PacketData request;
+        uint8_t const requestData[1] = {ACTIVE_FORWARD};
+        ProtocolUtils::createRequestPacket(CMD_READ_STATUS, 0x1234, 0xFFFF, 0, requestData, 1, request);
+        static PacketData response;
+        runner.run("createResponsePacket/readStatus", typicalSize, [&]() {
+            bool const ok = ProtocolUtils::createResponsePacket(request, 0, typical, ReadStatusResponseNew::SIZE,
+                                                                response);
+            keep(ok);
+        });
+    }
+
+    /**
+     * @brief prepareRequest/parseResponse/handleRequest одной команды
+     * @param server Команда в роли сервера (формирует ответ)
+     * @param client Команда в роли клиента (разбирает ответ)
+     */
+    void benchCommand(Runner &runner, const char *name, BaseCommand &server, BaseCommand &client) {
+        static uint8_t request[ProtocolConstants::MAX_DATA_SIZE];
+        static uint8_t response[ProtocolConstants::MAX_DATA_SIZE];
+        size_t const requestSize = client.prepareRequest(request, sizeof(request));
+        size_t const responseSize = server.handleRequest(request, requestSize, response, sizeof(response));
+        if (responseSize == 0 || !client.parseResponse(response, responseSize)) {
+            fprintf(stderr, "%s: server response is not accepted by the client\n", name);
+            return;
+        }
+
+        std::string const prefix = std::string(name) + "/";
+        runner.run((prefix + "prepareRequest").c_str(), requestSize, [&]() {
+            size_t const size = client.prepareRequest(request, sizeof(request));
+            keep(size);
+        });
+        runner.run((prefix + "parseResponse").c_str(), responseSize, [&]() {
+            bool const ok = client.parseResponse(response, responseSize);
+            keep(ok);
+        });
+        runner.run((prefix + "handleRequest").c_str(), responseSize, [&]() {
+            size_t const size = server.handleRequest(request, requestSize, response, sizeof(response));
+            keep(size);
+        });
+    }
+
+    void benchCommands(Runner &runner) {
+        {
+            PingCommand server;
+            PingCommand client;
+            server.setServerResponse(0x0102, 0x1234);
+            benchCommand(runner, "ping", server, client);
+        }
+        {
+            ReadStatusCommand server;
+            ReadStatusCommand client;
+            server.setGeneration(BOARD_OLD_01, 0);
+            client.setGeneration(BOARD_OLD_01, 0);
+            benchCommand(runner, "readStatus/old", server, client);
+        }
+        {
+            ReadStatusCommand server;
+            ReadStatusCommand client;
+            server.setGeneration(BOARD_NEW_09, BoardCapabilities::ROLE_THRESHOLD);
+            client.setGeneration(BOARD_NEW_09, BoardCapabilities::ROLE_THRESHOLD);
+            client.setRequest(ACTIVE_FORWARD);
+            benchCommand(runner, "readStatus/new", server, client);
+        }
+        {
+            ReadDateTimeCommand server;
+            ReadDateTimeCommand client;
+            benchCommand(runner, "readDateTime", server, client);
+        }
+        {
+            ReadInstantValueCommand server;
+            ReadInstantValueCommand client;
+            server.setGeneration(BOARD_NEW_09, BoardCapabilities::ROLE_THRESHOLD);
+            client.setGeneration(BOARD_NEW_09, BoardCapabilities::ROLE_THRESHOLD);
+            client.setRequest(GROUP_BASIC);
+            benchCommand(runner, "readInstantValue/new", server, client);
+        }
+        {
+            GetInfoCommand server;
+            GetInfoCommand client;
+            server.setExpectedGeneration(BOARD_NEW_09, BoardCapabilities::ROLE_THRESHOLD);
+            client.setExpectedGeneration(BOARD_NEW_09, BoardCapabilities::ROLE_THRESHOLD);
+            benchCommand(runner, "getInfo/new", server, client);
+        }
+    }
+
+    // Режимы обмена через LoopbackRadio (флаги)
+    enum LoopbackMode {
+        LOOPBACK_POLL = 0,
+        LOOPBACK_INTERRUPT = 1, ///< Прием по прерыванию (сигнал LoopbackRadio)
+        LOOPBACK_FAST_TX = 2, ///< Быстрая передача
+        LOOPBACK_LEAN_RX = 4, ///< Экономный перезапуск приема
+        LOOPBACK_STREAM = 8, ///< Потоковый прием по порогу FIFO (включает прием по прерыванию)
+        LOOPBACK_DEAD_METER = 16, ///< Каждый цикл опроса включает неотвечающий счетчик (таймаут 100 мс)
+        LOOPBACK_EARLY_ABORT = 32 ///< Раннее прерывание ожидания ответа (окно 20 мс)
+    };
+
+    /**
+     * @brief Ping через пару LoopbackRadio, сервер обрабатывает запросы в отдельном потоке
+     * @param mode Флаги LoopbackMode (одинаковые для клиента и сервера)
+     */
+    void benchLoopback(Runner &runner, const char *name, unsigned mode) {
+        LoopbackRadio clientRadio;
+        LoopbackRadio serverRadio;
+        LoopbackRadio::connect(clientRadio, serverRadio);
+
+        MirlibServer server(0x1234, MirlibBase::NEW_GENERATION, &serverRadio);
+        MirlibClient client(0xFFFF, &clientRadio);
+        server.begin(0);
+        client.begin(0);
+        client.setTimeout((mode & LOOPBACK_DEAD_METER) != 0 ? 100 : 1000);
+        if ((mode & LOOPBACK_EARLY_ABORT) != 0) {
+            MirlibClient::ReceiveWindowPolicy policy;
+            policy.initialWindowMs = 20;
+            client.setEarlyAbort(true, policy);
+        }
+        server.setFastTransmit((mode & LOOPBACK_FAST_TX) != 0);
+        client.setFastTransmit((mode & LOOPBACK_FAST_TX) != 0);
+        server.setLeanReceive((mode & LOOPBACK_LEAN_RX) != 0);
+        client.setLeanReceive((mode & LOOPBACK_LEAN_RX) != 0);
+        client.resetRadioStats();
+        if ((mode & LOOPBACK_INTERRUPT) != 0 && (!server.enableReceiveInterrupt() || !client.enableReceiveInterrupt())) {
+            fprintf(stderr, "%s: receive interrupt is not available\n", name);
+            return;
+        }
+        if ((mode & LOOPBACK_STREAM) != 0 && (!server.enableStreamingReceive(0) || !client.enableStreamingReceive(0))) {
+            fprintf(stderr, "%s: streaming receive is not available\n", name);
+            return;
+        }
+
+        std::atomic<bool> stop(false);
+        std::thread serverThread([&]() {
+            while (!stop) {
+                server.processIncomingPackets();
+            }
+        });
+
+        unsigned long failures = 0;
+        runner.run(name, 0, [&]() {
+            uint16_t firmwareVersion = 0;
+            if (!client.ping(0x1234, &firmwareVersion)) {
+                failures++;
+            }
+            if ((mode & LOOPBACK_DEAD_METER) != 0) {
+                client.ping(0x4321);
+            }
+        });
+
+        stop = true;
+        serverThread.join();
+        if (failures != 0) {
+            fprintf(stderr, "%s: %lu requests without response\n", name, failures);
+        }
+
+        const MirlibBase::TransmitStats &stats = client.getTransmitStats();
+        if (stats.packets == 0) {
+            return;
+        }
+        fprintf(stderr, "%s: tx latency avg %lu us, max %lu us, %lu calibrations / %lu packets\n", name,
+                static_cast<unsigned long>(stats.averageLatencyUs()), static_cast<unsigned long>(stats.maxLatencyUs),
+                static_cast<unsigned long>(stats.calibrations), static_cast<unsigned long>(stats.packets));
+
+        const MirlibBase::RadioStats &radio = client.getRadioStats();
+        fprintf(stderr, "%s: %.1f strobes per ping, %lu frames missed during re-arm\n", name,
+                static_cast<double>(radio.strobes) / stats.packets,
+                static_cast<unsigned long>(radio.missedFrames));
+
+        const MirlibClient::MeterLinkStats *link = client.getMeterStats(0x1234);
+        if (link != nullptr) {
+            fprintf(stderr, "%s: rssi %d dBm, lqi %u, round trip avg %lu us\n", name,
+                    static_cast<int>(link->rssiAverageDbm), static_cast<unsigned>(link->lqiAverage),
+                    static_cast<unsigned long>(link->roundTripAverageUs));
+        }
+
+        if (client.isEarlyAbortEnabled()) {
+            const MirlibClient::EarlyAbortStats &abortStats = client.getEarlyAbortStats();
+            fprintf(stderr, "%s: %lu early aborts, %lu ms saved, %lu full timeouts\n", name,
+                    static_cast<unsigned long>(abortStats.earlyAborts), static_cast<unsigned long>(abortStats.savedMs),
+                    static_cast<unsigned long>(abortStats.fullTimeouts));
+        }
+    }
+
+    // Счетчик пула: ответ на ping через 5 мс (время обработки в счетчике)
+    bool slowPing(const PacketView &request, PacketData &response, void *context) {
+        delay(5);
+        PingCommand command;
+        command.setServerResponse(0x0100, *static_cast<const uint16_t *>(context));
+        response.dataSize = command.handleRequest(request.data(), request.dataSize(), response.data, sizeof(response.data));
+        return response.dataSize != 0;
+    }
+
+    /**
+     * @brief Опрос 8 счетчиков пулом клиентов: каждый клиент на своем канале, 8 / radios счетчиков на канале
+     * Эфир - AirMedium, кадр занимает 2 мс
+     */
+    void benchPool(Runner &runner, const char *name, uint8_t radios) {
+        static const uint8_t METERS = 8;
+
+        AirMedium air(2000);
+        std::unique_ptr<LoopbackRadio> clientRadios[MIRLIB_POOL_SIZE];
+        std::unique_ptr<MirlibClient> clients[MIRLIB_POOL_SIZE];
+        MirlibClientPool pool;
+        for (uint8_t i = 0; i < radios; i++) {
+            clientRadios[i].reset(new LoopbackRadio());
+            air.attach(*clientRadios[i]);
+            clients[i].reset(new MirlibClient(0xFFFF, clientRadios[i].get()));
+            clients[i]->begin(0);
+            clients[i]->setFastTransmit(true);
+            clients[i]->setLeanReceive(true);
+            clients[i]->enableReceiveInterrupt();
+            clients[i]->setTimeout(200);
+            clients[i]->setChannel(i);
+            pool.addClient(*clients[i]);
+        }
+
+        LoopbackRadio meterRadios[METERS];
+        uint16_t addresses[METERS];
+        std::unique_ptr<MirlibServer> meters[METERS];
+        for (uint8_t i = 0; i < METERS; i++) {
+            addresses[i] = static_cast<uint16_t>(0x0100 + i);
+            air.attach(meterRadios[i]);
+            meters[i].reset(new MirlibServer(addresses[i], MirlibBase::NEW_GENERATION, &meterRadios[i]));
+            meters[i]->begin(0);
+            meters[i]->setFastTransmit(true);
+            meters[i]->setLeanReceive(true);
+            meters[i]->enableReceiveInterrupt();
+            meters[i]->setChannel(i % radios);
+            meters[i]->registerCommandHandler(0x01, slowPing, &addresses[i]);
+        }
+
+        std::atomic<bool> stop(false);
+        std::vector<std::thread> meterThreads;
+        for (uint8_t i = 0; i < METERS; i++) {
+            MirlibServer *meter = meters[i].get();
+            meterThreads.emplace_back([meter, &stop]() {
+                while (!stop) {
+                    meter->processIncomingPackets();
+                }
+            });
+        }
+
+        PingCommand commands[METERS];
+        MirlibClientPool::Job jobs[METERS];
+        unsigned long failures = 0;
+        runner.run(name, 0, [&]() {
+            for (uint8_t i = 0; i < METERS; i++) {
+                jobs[i] = MirlibClientPool::Job(&commands[i], addresses[i], i % radios);
+            }
+            failures += METERS - pool.run(jobs, METERS);
+        });
+
+        stop = true;
+        for (size_t i = 0; i < meterThreads.size(); i++) {
+            meterThreads[i].join();
+        }
+        if (failures != 0 || air.collisions() != 0) {
+            fprintf(stderr, "%s: %lu requests without response, %lu collisions\n", name, failures, air.collisions());
+        }
+    }
+
+    void benchExchange(Runner &runner) {
+        benchLoopback(runner, "loopback/ping/poll", LOOPBACK_POLL);
+        benchLoopback(runner, "loopback/ping/interrupt", LOOPBACK_INTERRUPT);
+        benchLoopback(runner, "loopback/ping/poll/fast-tx", LOOPBACK_FAST_TX);
+        benchLoopback(runner, "loopback/ping/interrupt/fast-tx", LOOPBACK_INTERRUPT | LOOPBACK_FAST_TX);
+        benchLoopback(runner, "loopback/ping/poll/lean-rx", LOOPBACK_FAST_TX | LOOPBACK_LEAN_RX);
+        benchLoopback(runner, "loopback/ping/interrupt/lean-rx", LOOPBACK_INTERRUPT | LOOPBACK_FAST_TX | LOOPBACK_LEAN_RX);
+        benchLoopback(runner, "loopback/ping/stream", LOOPBACK_STREAM | LOOPBACK_FAST_TX | LOOPBACK_LEAN_RX);
+        benchLoopback(runner, "loopback/cycle/dead-meter", LOOPBACK_INTERRUPT | LOOPBACK_DEAD_METER);
+        benchLoopback(runner, "loopback/cycle/dead-meter/early-abort",
+                      LOOPBACK_INTERRUPT | LOOPBACK_DEAD_METER | LOOPBACK_EARLY_ABORT);
+        benchPool(runner, "loopback/pool/8-meters/1-radio", 1);
+        benchPool(runner, "loopback/pool/8-meters/2-radios", 2);
+        benchPool(runner, "loopback/pool/8-meters/4-radios", 4);
+    }
+
+    bool parseOptions(int argc, char **argv, Options &options) {
+        for (int i = 1; i < argc; i++) {
+            std::string const arg = argv[i];
+            if (i + 1 >= argc) {
+                return false;
+            }
+            if (arg == "--filter") {
+                options.filter = argv[++i];
+            } else if (arg == "--min-time") {
+                options.minTimeMs = atof(argv[++i]);
+            } else if (arg == "--repeats") {
+                options.repeats = atoi(argv[++i]);
+            } else if (arg == "--out") {
+                options.out = argv[++i];
+            } else {
+                return false;
+            }
+        }
+        return options.minTimeMs > 0 && options.repeats > 0;
+    }
+}
+
+int main(int argc, char **argv) {
+    Options options;
+    options.minTimeMs = 50.0;
+    options.repeats = 5;
+    if (!parseOptions(argc, argv, options)) {
+        fprintf(stderr, "usage: %s [--filter substring] [--min-time ms] [--repeats N] [--out file]\n", argv[0]);
+        return 2;
+    }
+
+    Runner runner(options);
+    benchCrc(runner);
+    benchStuffing(runner);
+    benchPackets(runner);
+    benchCommands(runner);
+    benchExchange(runner);
+
+    FILE *out = stdout;
+    if (!options.out.empty()) {
+        out = fopen(options.out.c_str(), "w");
+        if (out == nullptr) {
+            fprintf(stderr, "cannot open %s\n", options.out.c_str());
+            return 1;
+        }
+    }
+    writeJson(out, runner.results());
+    if (out != stdout) {
+        fclose(out);
+    }
+    return 0;
+}
@@ -0,0 +1,27 @@
+#ifndef FUZZ_TARGETS_H
+#define FUZZ_TARGETS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * Формат входа фаззера: первый байт выбирает проверку (по модулю FUZZ_TARGET_COUNT),
+ * остальные байты - ее данные.
+ */
+enum FuzzTarget {
+    FUZZ_CRC = 0, ///< Данные для CRC8
+    FUZZ_STUFF = 1, ///< Лимит выхода (1 байт), затем данные для byteStuffing
+    FUZZ_UNSTUFF = 2, ///< Лимит выхода (1 байт), затем данные для byteUnstuffing
+    FUZZ_DECODE = 3, ///< Сырой кадр со старт/стоп-байтами
+    FUZZ_PACK = 4, ///< Поля PacketData: params, dest(2), src(2), cmd, pw(4), размер данных, данные
+    FUZZ_TARGET_COUNT = 5
+};
+
+/**
+ * @brief Ключ кодирования для кадров с params.encoding = 1
+ */
+static const uint32_t FUZZ_ENCODING_KEY = 0xA1B2C3D4;
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+#endif // FUZZ_TARGETS_H
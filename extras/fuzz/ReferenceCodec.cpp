@@ -0,0 +1,288 @@
+#include "ReferenceCodec.h"
+
+namespace {
+    void uint16ToBytes(uint16_t value, uint8_t *bytes) {
+        bytes[0] = value & 0xFF;
+        bytes[1] = (value >> 8) & 0xFF;
+    }
+
+    void uint32ToBytes(uint32_t value, uint8_t *bytes) {
+        bytes[0] = value & 0xFF;
+        bytes[1] = (value >> 8) & 0xFF;
+        bytes[2] = (value >> 16) & 0xFF;
+        bytes[3] = (value >> 24) & 0xFF;
+    }
+
+    uint16_t bytesToUint16(const uint8_t *bytes) {
+        return static_cast<uint16_t>(bytes[0]) | (static_cast<uint16_t>(bytes[1]) << 8);
+    }
+
+    uint32_t bytesToUint32(const uint8_t *bytes) {
+        return static_cast<uint32_t>(bytes[0]) |
+               (static_cast<uint32_t>(bytes[1]) << 8) |
+               (static_cast<uint32_t>(bytes[2]) << 16) |
+               (static_cast<uint32_t>(bytes[3]) << 24);
+    }
+}
+
+uint8_t ReferenceCodec::calculateCRC8(const uint8_t *data, size_t length) {
+    uint8_t crc = ProtocolConstants::CRC_INITIAL;
+
+    for (size_t i = 0; i < length; i++) {
+        uint8_t dataByte = data[i];
+
+        for (int bit = 0; bit < 8; bit++) {
+            if (((dataByte ^ crc) & 0x80) == 0) {
+                crc = (crc << 1);
+            } else {
+                crc = ((crc << 1) ^ ProtocolConstants::CRC_POLYNOMIAL);
+            }
+            dataByte = (dataByte << 1);
+        }
+    }
+
+    return crc;
+}
+
+size_t ReferenceCodec::byteStuffing(const uint8_t *input, size_t inputSize, uint8_t *output, size_t outputMaxSize) {
+    if ((input == nullptr) || (output == nullptr) || inputSize == 0 || outputMaxSize == 0) {
+        return 0;
+    }
+
+    size_t outputIndex = 0;
+
+    for (size_t i = 0; i < inputSize; i++) {
+        if (outputIndex >= outputMaxSize - 1) {
+            // Reserve space for potential stuffing
+            return 0;
+        }
+
+        uint8_t const currentByte = input[i];
+
+        if (currentByte == 0x55) {
+            output[outputIndex++] = ProtocolConstants::STUFF_MARKER;
+            if (outputIndex >= outputMaxSize) {
+                return 0;
+            }
+            output[outputIndex++] = ProtocolConstants::STUFF_0x55;
+        } else if (currentByte == 0x73) {
+            output[outputIndex++] = ProtocolConstants::STUFF_MARKER;
+            if (outputIndex >= outputMaxSize) {
+                return 0;
+            }
+            output[outputIndex++] = ProtocolConstants::STUFF_0x73;
+        } else {
+            output[outputIndex++] = currentByte;
+        }
+    }
+
+    return outputIndex;
+}
+
+size_t ReferenceCodec::byteUnstuffing(const uint8_t *input, size_t inputSize, uint8_t *output, size_t outputMaxSize) {
+    if ((input == nullptr) || (output == nullptr) || inputSize == 0) {
+        return 0;
+    }
+
+    size_t outputIndex = 0;
+    size_t inputIndex = 0;
+
+    while (inputIndex < inputSize && outputIndex < outputMaxSize) {
+        uint8_t const currentByte = input[inputIndex++];
+
+        if (currentByte == ProtocolConstants::STUFF_MARKER && inputIndex < inputSize) {
+            uint8_t const nextByte = input[inputIndex++];
+
+            if (nextByte == ProtocolConstants::STUFF_0x55) {
+                output[outputIndex++] = 0x55;
+            } else if (nextByte == ProtocolConstants::STUFF_0x73) {
+                output[outputIndex++] = 0x73;
+            } else {
+                // Invalid stuffing, both bytes are kept
+                if (outputIndex < outputMaxSize - 1) {
+                    output[outputIndex++] = currentByte;
+                    output[outputIndex++] = nextByte;
+                } else {
+                    return 0;
+                }
+            }
+        } else {
+            output[outputIndex++] = currentByte;
+        }
+    }
+
+    return outputIndex;
+}
+
+void ReferenceCodec::applyKeystream(uint8_t *data, size_t size, uint32_t key) {
+    for (size_t i = 0; i < size; i++) {
+        data[i] ^= static_cast<uint8_t>(key >> (8 * (i & 0x03)));
+    }
+}
+
+bool ReferenceCodec::packPacket(PacketData &packet, uint32_t encodingKey) {
+    if (packet.dataSize > ProtocolConstants::MAX_DATA_SIZE) {
+        return false;
+    }
+
+    // Packet without start/stop bytes and without stuffing
+    uint8_t tempPacket[ProtocolConstants::MAX_PACKET_SIZE];
+    size_t tempIndex = 0;
+
+    packet.params.dataLength = packet.dataSize;
+    tempPacket[tempIndex++] = packet.params.toByte();
+    tempPacket[tempIndex++] = ProtocolConstants::RESERVE;
+    uint16ToBytes(packet.destAddress, &tempPacket[tempIndex]);
+    tempIndex += 2;
+    uint16ToBytes(packet.srcAddress, &tempPacket[tempIndex]);
+    tempIndex += 2;
+    tempPacket[tempIndex++] = packet.command;
+    uint32ToBytes(packet.passwordOrStatus, &tempPacket[tempIndex]);
+    tempIndex += 4;
+
+    if (packet.dataSize > 0) {
+        memcpy(&tempPacket[tempIndex], packet.data, packet.dataSize);
+        if (packet.params.encoding) {
+            applyKeystream(&tempPacket[tempIndex], packet.dataSize, encodingKey);
+        }
+        tempIndex += packet.dataSize;
+    }
+
+    // CRC for all bytes from Parameters to Data
+    packet.crc = calculateCRC8(tempPacket, tempIndex);
+    tempPacket[tempIndex++] = packet.crc;
+
+    uint8_t stuffedPacket[ProtocolConstants::MAX_PACKET_SIZE];
+    size_t const stuffedSize = byteStuffing(tempPacket, tempIndex, stuffedPacket, sizeof(stuffedPacket));
+
+    if (stuffedSize == 0 || stuffedSize + ProtocolConstants::FRAMING_SIZE > ProtocolConstants::MAX_PACKET_SIZE) {
+        packet.rawSize = 0;
+        return false;
+    }
+
+    packet.rawSize = 0;
+    packet.rawPacket[packet.rawSize++] = ProtocolConstants::START1;
+    packet.rawPacket[packet.rawSize++] = ProtocolConstants::START2;
+    memcpy(&packet.rawPacket[packet.rawSize], stuffedPacket, stuffedSize);
+    packet.rawSize += stuffedSize;
+    packet.rawPacket[packet.rawSize++] = ProtocolConstants::STOP;
+
+    return true;
+}
+
+bool ReferenceCodec::decodePacket(const uint8_t *rawData, size_t rawSize, PacketData &packet, uint32_t encodingKey) {
+    packet.clear();
+
+    if ((rawData == nullptr) || rawSize < ProtocolConstants::MIN_PACKET_SIZE) {
+        return false;
+    }
+
+    if (rawData[0] != ProtocolConstants::START1 ||
+        rawData[1] != ProtocolConstants::START2 ||
+        rawData[rawSize - 1] != ProtocolConstants::STOP) {
+        return false;
+    }
+
+    uint8_t unstuffedData[ProtocolConstants::MAX_PACKET_SIZE] = {0};
+    size_t const unstuffedSize = byteUnstuffing(rawData + 2, rawSize - ProtocolConstants::FRAMING_SIZE,
+                                                unstuffedData, sizeof(unstuffedData));
+
+    if (unstuffedSize < 8) {
+        return false;
+    }
+
+    size_t index = 0;
+    packet.params.fromByte(unstuffedData[index++]);
+    index++; // Reserve
+    packet.destAddress = bytesToUint16(&unstuffedData[index]);
+    index += 2;
+    packet.srcAddress = bytesToUint16(&unstuffedData[index]);
+    index += 2;
+    packet.command = unstuffedData[index++];
+    packet.passwordOrStatus = bytesToUint32(&unstuffedData[index]);
+    index += 4;
+
+    packet.dataSize = packet.params.dataLength;
+    if (packet.dataSize > 0) {
+        if (index + packet.dataSize >= unstuffedSize) {
+            return false;
+        }
+        memcpy(packet.data, &unstuffedData[index], packet.dataSize);
+        index += packet.dataSize;
+    }
+
+    if (index >= unstuffedSize) {
+        return false;
+    }
+    packet.crc = unstuffedData[index++];
+
+    if (calculateCRC8(unstuffedData, index - 1) != packet.crc) {
+        return false;
+    }
+
+    // CRC covers the transmitted (encoded) bytes
+    if (packet.params.encoding) {
+        applyKeystream(packet.data, packet.dataSize, encodingKey);
+    }
+
+    return true;
+}
+
+bool ReferenceCodec::unpackPacket(const uint8_t *rawData, size_t rawSize, PacketData &packet, uint32_t encodingKey) {
+    // The raw frame is stored in packet.rawPacket
+    if (rawSize > ProtocolConstants::MAX_PACKET_SIZE || !decodePacket(rawData, rawSize, packet, encodingKey)) {
+        return false;
+    }
+
+    memcpy(packet.rawPacket, rawData, rawSize);
+    packet.rawSize = rawSize;
+
+    return true;
+}
+
+bool ReferenceCodec::createRequestPacket(uint8_t command, uint16_t destAddr, uint16_t srcAddr, uint32_t password,
+                                         const uint8_t *data, uint8_t dataSize, PacketData &packet,
+                                         bool encoded, uint32_t encodingKey) {
+    packet.clear();
+    if (dataSize > ProtocolConstants::MAX_DATA_SIZE) {
+        return false;
+    }
+
+    packet.params.direction = 1;
+    packet.params.version = 0;
+    packet.params.encoding = encoded ? 1 : 0;
+    packet.params.dataLength = dataSize;
+    packet.destAddress = destAddr;
+    packet.srcAddress = srcAddr;
+    packet.command = command;
+    packet.passwordOrStatus = password;
+    packet.dataSize = dataSize;
+    if (dataSize > 0 && data != nullptr) {
+        memcpy(packet.data, data, dataSize);
+    }
+
+    return packPacket(packet, encodingKey);
+}
+
+bool ReferenceCodec::createResponsePacket(const PacketData &originalRequest, uint32_t status, const uint8_t *data,
+                                          uint8_t dataSize, PacketData &packet, uint32_t encodingKey) {
+    packet.clear();
+    if (dataSize > ProtocolConstants::MAX_DATA_SIZE) {
+        return false;
+    }
+
+    packet.params.direction = 0;
+    packet.params.version = originalRequest.params.version;
+    packet.params.encoding = originalRequest.params.encoding;
+    packet.params.dataLength = dataSize;
+    packet.destAddress = originalRequest.srcAddress;
+    packet.srcAddress = originalRequest.destAddress;
+    packet.command = originalRequest.command;
+    packet.passwordOrStatus = status;
+    packet.dataSize = dataSize;
+    if (dataSize > 0 && data != nullptr) {
+        memcpy(packet.data, data, dataSize);
+    }
+
+    return packPacket(packet, encodingKey);
+}
@@ -0,0 +1,66 @@
+#ifndef REFERENCE_CODEC_H
+#define REFERENCE_CODEC_H
+
+#include <Arduino.h>
+#include <ProtocolTypes.h>
+
+/**
+ * @brief Frozen reference codec for differential fuzzing
+ *
+ * Straightforward byte-at-a-time versions of the ProtocolUtils codec
+ * (bitwise CRC, two-pass pack/unpack through temporary buffers). They define
+ * the expected outputs and accept/reject decisions; do not optimize them or
+ * change them together with the library.
+ */
+class ReferenceCodec {
+public:
+    /**
+     * @brief Bit-by-bit CRC8
+     */
+    static uint8_t calculateCRC8(const uint8_t *data, size_t length);
+
+    /**
+     * @brief Byte stuffing (same contract as ProtocolUtils::byteStuffing)
+     */
+    static size_t byteStuffing(const uint8_t *input, size_t inputSize, uint8_t *output, size_t outputMaxSize);
+
+    /**
+     * @brief Byte unstuffing (same contract as ProtocolUtils::byteUnstuffing)
+     */
+    static size_t byteUnstuffing(const uint8_t *input, size_t inputSize, uint8_t *output, size_t outputMaxSize);
+
+    /**
+     * @brief Byte-at-a-time keystream (key bytes little-endian, repeated)
+     */
+    static void applyKeystream(uint8_t *data, size_t size, uint32_t key);
+
+    /**
+     * @brief Pack packet: serialize, CRC, then stuff into a temporary buffer
+     */
+    static bool packPacket(PacketData &packet, uint32_t encodingKey = 0);
+
+    /**
+     * @brief Decode fields of a raw frame of any length (raw frame is not stored)
+     */
+    static bool decodePacket(const uint8_t *rawData, size_t rawSize, PacketData &packet, uint32_t encodingKey = 0);
+
+    /**
+     * @brief Unpack packet: unstuff into a temporary buffer, then parse and check CRC
+     */
+    static bool unpackPacket(const uint8_t *rawData, size_t rawSize, PacketData &packet, uint32_t encodingKey = 0);
+
+    /**
+     * @brief Create request packet
+     */
+    static bool createRequestPacket(uint8_t command, uint16_t destAddr, uint16_t srcAddr, uint32_t password,
+                                    const uint8_t *data, uint8_t dataSize, PacketData &packet,
+                                    bool encoded = false, uint32_t encodingKey = 0);
+
+    /**
+     * @brief Create response packet
+     */
+    static bool createResponsePacket(const PacketData &originalRequest, uint32_t status, const uint8_t *data,
+                                     uint8_t dataSize, PacketData &packet, uint32_t encodingKey = 0);
+};
+
+#endif // REFERENCE_CODEC_H
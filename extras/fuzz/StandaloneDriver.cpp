@@ -0,0 +1,328 @@
+/*
+ * StandaloneDriver.cpp
+ *
+ * Запуск LLVMFuzzerTestOneInput без libFuzzer:
+ *   mirlib_fuzz_standalone файл|каталог ...       - прогон сохраненных входов (корпус, падения)
+ *   mirlib_fuzz_standalone [--runs N] [--seed S]   - случайные мутации встроенных затравок
+ *   mirlib_fuzz_standalone --make-corpus КАТАЛОГ   - запись затравочного корпуса для libFuzzer
+ *
+ * Затравки: кадры из примеров (README) и кадры, полученные упаковкой PacketData
+ * с ответами команд (запросы и ответы, с кодированием и без).
+ */
+
+#include "FuzzTargets.h"
+
+#include <ProtocolUtils.h>
+#include <Commands/PingCommand.h>
+#include <Commands/ReadStatusCommand.h>
+#include <Commands/ReadDateTimeCommand.h>
+#include <Commands/ReadInstantValueCommand.h>
+#include <Commands/GetInfoCommand.h>
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <string>
+#include <vector>
+
+namespace {
+    typedef std::vector<uint8_t> Input;
+
+    // Кадры из примера отладочного вывода в README (Ping)
+    const uint8_t EXAMPLE_REQUEST[] = {
+        0x73, 0x55, 0x20, 0x00, 0x34, 0x12, 0xFF, 0xFF, 0x01, 0x78, 0x56, 0x34, 0x12, 0xA5, 0x55
+    };
+    const uint8_t EXAMPLE_RESPONSE[] = {
+        0x73, 0x55, 0x24, 0x00, 0xFF, 0xFF, 0x34, 0x12, 0x01, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x01, 0x00, 0x34, 0x12, 0xB2, 0x55
+    };
+
+    Input withTarget(FuzzTarget target, const uint8_t *data, size_t size) {
+        Input input(1, static_cast<uint8_t>(target));
+        input.insert(input.end(), data, data + size);
+        return input;
+    }
+
+    /**
+     * @brief Затравки всех проверок для одного упакованного кадра
+     */
+    void addFrameSeeds(std::vector<Input> &seeds, const PacketData &packet) {
+        seeds.push_back(withTarget(FUZZ_DECODE, packet.rawPacket, packet.rawSize));
+
+        uint8_t fields[11 + ProtocolConstants::MAX_DATA_SIZE];
+        fields[0] = packet.params.toByte();
+        ProtocolUtils::uint16ToBytes(packet.destAddress, fields + 1);
+        ProtocolUtils::uint16ToBytes(packet.srcAddress, fields + 3);
+        fields[5] = packet.command;
+        ProtocolUtils::uint32ToBytes(packet.passwordOrStatus, fields + 6);
+        fields[10] = packet.dataSize;
+        memcpy(fields + 11, packet.data, packet.dataSize);
+        seeds.push_back(withTarget(FUZZ_PACK, fields, 11 + packet.dataSize));
+
+        // Стаффинг/CRC на теле кадра без старт/стоп-байтов
+        Input body(1, ProtocolConstants::MAX_PACKET_SIZE);
+        body.insert(body.end(), packet.rawPacket + 2, packet.rawPacket + packet.rawSize - 1);
+        seeds.push_back(withTarget(FUZZ_UNSTUFF, body.data(), body.size()));
+
+        uint8_t unstuffed[ProtocolConstants::MAX_PACKET_SIZE];
+        size_t const unstuffedSize = ProtocolUtils::byteUnstuffing(body.data() + 1, body.size() - 1, unstuffed,
+                                                                   sizeof(unstuffed));
+        Input plain(1, ProtocolConstants::MAX_PACKET_SIZE);
+        plain.insert(plain.end(), unstuffed, unstuffed + unstuffedSize);
+        seeds.push_back(withTarget(FUZZ_STUFF, plain.data(), plain.size()));
+        seeds.push_back(withTarget(FUZZ_CRC, unstuffed, unstuffedSize));
+    }
+
+    /**
+     * @brief Запрос и ответ одной команды (сервер формирует ответ из своих данных)
+     */
+    void addCommandSeeds(std::vector<Input> &seeds, BaseCommand &server, BaseCommand &client, bool encoded) {
+        uint8_t request[ProtocolConstants::MAX_DATA_SIZE];
+        uint8_t response[ProtocolConstants::MAX_DATA_SIZE];
+        size_t const requestSize = client.prepareRequest(request, sizeof(request));
+        size_t const responseSize = server.handleRequest(request, requestSize, response, sizeof(response));
+
+        PacketData requestPacket;
+        if (!ProtocolUtils::createRequestPacket(client.getCommandCode(), 0x1234, ProtocolConstants::ADDR_CLIENT,
+                                                0x12345678, request, static_cast<uint8_t>(requestSize),
+                                                requestPacket, encoded, FUZZ_ENCODING_KEY)) {
+            return;
+        }
+        addFrameSeeds(seeds, requestPacket);
+
+        PacketData responsePacket;
+        if (responseSize > 0 &&
+            ProtocolUtils::createResponsePacket(requestPacket, 0, response, static_cast<uint8_t>(responseSize),
+                                                responsePacket, FUZZ_ENCODING_KEY)) {
+            addFrameSeeds(seeds, responsePacket);
+        }
+    }
+
+    std::vector<Input> makeSeeds() {
+        std::vector<Input> seeds;
+        seeds.push_back(withTarget(FUZZ_DECODE, EXAMPLE_REQUEST, sizeof(EXAMPLE_REQUEST)));
+        seeds.push_back(withTarget(FUZZ_DECODE, EXAMPLE_RESPONSE, sizeof(EXAMPLE_RESPONSE)));
+
+        for (int encoded = 0; encoded < 2; encoded++) {
+            PingCommand pingServer;
+            PingCommand pingClient;
+            pingServer.setServerResponse(0x0155, 0x1234);
+            addCommandSeeds(seeds, pingServer, pingClient, encoded != 0);
+
+            ReadStatusCommand statusServer;
+            ReadStatusCommand statusClient;
+            statusServer.setGeneration(BOARD_NEW_09, BoardCapabilities::ROLE_THRESHOLD);
+            statusClient.setGeneration(BOARD_NEW_09, BoardCapabilities::ROLE_THRESHOLD);
+            addCommandSeeds(seeds, statusServer, statusClient, encoded != 0);
+
+            ReadStatusCommand oldStatusServer;
+            ReadStatusCommand oldStatusClient;
+            oldStatusServer.setGeneration(BOARD_OLD_01, 0);
+            oldStatusClient.setGeneration(BOARD_OLD_01, 0);
+            addCommandSeeds(seeds, oldStatusServer, oldStatusClient, encoded != 0);
+
+            ReadDateTimeCommand dateTimeServer;
+            ReadDateTimeCommand dateTimeClient;
+            addCommandSeeds(seeds, dateTimeServer, dateTimeClient, encoded != 0);
+
+            ReadInstantValueCommand instantServer;
+            ReadInstantValueCommand instantClient;
+            instantServer.setGeneration(BOARD_TRANS_07, BoardCapabilities::ROLE_THRESHOLD);
+            instantClient.setGeneration(BOARD_TRANS_07, BoardCapabilities::ROLE_THRESHOLD);
+            addCommandSeeds(seeds, instantServer, instantClient, encoded != 0);
+
+            GetInfoCommand infoServer;
+            GetInfoCommand infoClient;
+            infoServer.setExpectedGeneration(BOARD_NEW_09, BoardCapabilities::ROLE_THRESHOLD);
+            addCommandSeeds(seeds, infoServer, infoClient, encoded != 0);
+        }
+
+        // Худший случай стаффинга: данные из одних 0x55/0x73
+        uint8_t worst[ProtocolConstants::MAX_DATA_SIZE];
+        for (size_t i = 0; i < sizeof(worst); i++) {
+            worst[i] = (i & 1) ? 0x73 : 0x55;
+        }
+        for (uint8_t size = 0; size <= 24; size += 8) {
+            PacketData packet;
+            if (ProtocolUtils::createRequestPacket(CMD_READ_STATUS, 0x5573, 0x7355, 0x55735573, worst, size,
+                                                   packet)) {
+                addFrameSeeds(seeds, packet);
+            }
+        }
+
+        return seeds;
+    }
+
+    /**
+     * @brief Генератор xorshift32 (воспроизводим по --seed)
+     */
+    struct Random {
+        uint32_t state;
+
+        uint32_t next() {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return state;
+        }
+
+        size_t below(size_t limit) { return limit != 0 ? next() % limit : 0; }
+    };
+
+    /**
+     * @brief Мутации с уклоном в байты протокола (маркеры стаффинга, старт/стоп)
+     */
+    void mutate(Input &input, Random &random) {
+        static const uint8_t INTERESTING[] = {0x55, 0x73, 0x11, 0x22, 0x00, 0xFF, 0x1F, 0x20, 0x80};
+
+        size_t const count = 1 + random.below(4);
+        for (size_t n = 0; n < count; n++) {
+            size_t const position = input.size() > 1 ? 1 + random.below(input.size() - 1) : 1;
+            switch (random.below(7)) {
+                case 0: // Инверсия бита
+                    if (position < input.size()) input[position] ^= static_cast<uint8_t>(1u << random.below(8));
+                    break;
+                case 1: // Случайный байт
+                    if (position < input.size()) input[position] = static_cast<uint8_t>(random.next());
+                    break;
+                case 2: // Байт протокола
+                    if (position < input.size()) input[position] = INTERESTING[random.below(sizeof(INTERESTING))];
+                    break;
+                case 3: // Вставка байта протокола
+                    input.insert(input.begin() + (position < input.size() ? position : input.size()),
+                                 INTERESTING[random.below(sizeof(INTERESTING))]);
+                    break;
+                case 4: // Удаление байта
+                    if (position < input.size()) input.erase(input.begin() + position);
+                    break;
+                case 5: // Обрезка
+                    if (position < input.size()) input.resize(position);
+                    break;
+                default: // Другая проверка на тех же данных
+                    input[0] = static_cast<uint8_t>(random.below(FUZZ_TARGET_COUNT));
+                    break;
+            }
+        }
+    }
+
+    bool readFile(const std::string &path, Input &input) {
+        FILE *const file = fopen(path.c_str(), "rb");
+        if (file == nullptr) {
+            return false;
+        }
+        input.clear();
+        uint8_t buffer[4096];
+        size_t read = 0;
+        while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+            input.insert(input.end(), buffer, buffer + read);
+        }
+        fclose(file);
+        return true;
+    }
+
+    /**
+     * @brief Прогон файла или всех файлов каталога
+     * @return Число прогнанных входов
+     */
+    size_t runPath(const std::string &path) {
+        struct stat info;
+        if (stat(path.c_str(), &info) != 0) {
+            fprintf(stderr, "cannot open %s\n", path.c_str());
+            return 0;
+        }
+
+        if (S_ISDIR(info.st_mode)) {
+            size_t count = 0;
+            DIR *const dir = opendir(path.c_str());
+            if (dir == nullptr) {
+                return 0;
+            }
+            while (struct dirent *entry = readdir(dir)) {
+                if (entry->d_name[0] != '.') {
+                    count += runPath(path + "/" + entry->d_name);
+                }
+            }
+            closedir(dir);
+            return count;
+        }
+
+        Input input;
+        if (!readFile(path, input)) {
+            fprintf(stderr, "cannot read %s\n", path.c_str());
+            return 0;
+        }
+        LLVMFuzzerTestOneInput(input.data(), input.size());
+        return 1;
+    }
+
+    int makeCorpus(const std::string &dir) {
+        mkdir(dir.c_str(), 0755);
+        std::vector<Input> const seeds = makeSeeds();
+        for (size_t i = 0; i < seeds.size(); i++) {
+            char name[32];
+            snprintf(name, sizeof(name), "/seed-%03zu", i);
+            FILE *const file = fopen((dir + name).c_str(), "wb");
+            if (file == nullptr) {
+                fprintf(stderr, "cannot write %s%s\n", dir.c_str(), name);
+                return 1;
+            }
+            fwrite(seeds[i].data(), 1, seeds[i].size(), file);
+            fclose(file);
+        }
+        fprintf(stderr, "%zu seeds written to %s\n", seeds.size(), dir.c_str());
+        return 0;
+    }
+}
+
+int main(int argc, char **argv) {
+    unsigned long runs = 100000;
+    Random random;
+    random.state = 0x4D49524C; // "MIRL"
+    std::vector<std::string> paths;
+
+    for (int i = 1; i < argc; i++) {
+        std::string const arg = argv[i];
+        if (arg == "--runs" && i + 1 < argc) {
+            runs = strtoul(argv[++i], nullptr, 0);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            random.state = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 0)) | 1;
+        } else if (arg == "--make-corpus" && i + 1 < argc) {
+            return makeCorpus(argv[++i]);
+        } else if (arg.compare(0, 2, "--") == 0) {
+            fprintf(stderr, "usage: %s [--runs N] [--seed S] [--make-corpus DIR] [file|dir ...]\n", argv[0]);
+            return 2;
+        } else {
+            paths.push_back(arg);
+        }
+    }
+
+    if (!paths.empty()) {
+        size_t count = 0;
+        for (size_t i = 0; i < paths.size(); i++) {
+            count += runPath(paths[i]);
+        }
+        fprintf(stderr, "%zu inputs passed\n", count);
+        return 0;
+    }
+
+    std::vector<Input> const seeds = makeSeeds();
+    for (size_t i = 0; i < seeds.size(); i++) {
+        LLVMFuzzerTestOneInput(seeds[i].data(), seeds[i].size());
+    }
+
+    for (unsigned long run = 0; run < runs; run++) {
+        Input input = seeds[random.below(seeds.size())];
+        mutate(input, random);
+
+        // Иногда - полностью случайный вход
+        if (random.below(16) == 0) {
+            input.resize(1 + random.below(80));
+            for (size_t i = 0; i < input.size(); i++) {
+                input[i] = static_cast<uint8_t>(random.next());
+            }
+        }
+        LLVMFuzzerTestOneInput(input.data(), input.size());
+    }
+
+    fprintf(stderr, "%zu seeds and %lu mutated inputs passed\n", seeds.size(), runs);
+    return 0;
+}
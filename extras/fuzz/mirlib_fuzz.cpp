@@ -0,0 +1,417 @@
+/*
+ * mirlib_fuzz.cpp
+ *
+ * Дифференциальный фаззинг кодека: одни и те же входы подаются замороженной
+ * эталонной реализации (ReferenceCodec) и оптимизированным путям библиотеки
+ * (уровни CRC8, ядра StuffingEngine, однопроходный разбор, PacketView,
+ * FrameUnstuffer, decodeBatch, matchHeader). Любое расхождение в выходе или в
+ * решении принять/отклонить кадр завершает процесс через abort().
+ *
+ * Точка входа совместима с libFuzzer; без libFuzzer собирается вместе с
+ * StandaloneDriver.cpp.
+ */
+
+#include "FuzzTargets.h"
+#include "ReferenceCodec.h"
+
+#include <ProtocolUtils.h>
+#include <Crc8Engine.h>
+#include <StuffingEngine.h>
+#include <FrameUnstuffer.h>
+#include <PacketView.h>
+#include <PacketFilter.h>
+
+namespace {
+    const uint8_t *g_input = nullptr;
+    size_t g_inputSize = 0;
+
+    /**
+     * @brief Проверка условия, при нарушении печатает вход и завершает процесс
+     */
+    void expect(bool condition, const char *what) {
+        if (condition) {
+            return;
+        }
+
+        fprintf(stderr, "mirlib_fuzz: mismatch: %s\ninput (%zu bytes):", what, g_inputSize);
+        for (size_t i = 0; i < g_inputSize; i++) {
+            fprintf(stderr, " %02X", g_input[i]);
+        }
+        fprintf(stderr, "\n");
+        abort();
+    }
+
+    /**
+     * @brief Сравнение разобранных полей (и сырого кадра, если он сохранен)
+     */
+    void expectSamePacket(const PacketData &expected, const PacketData &actual, bool compareRaw, const char *what) {
+        expect(expected.params.toByte() == actual.params.toByte(), what);
+        expect(expected.destAddress == actual.destAddress, what);
+        expect(expected.srcAddress == actual.srcAddress, what);
+        expect(expected.command == actual.command, what);
+        expect(expected.passwordOrStatus == actual.passwordOrStatus, what);
+        expect(expected.dataSize == actual.dataSize, what);
+        expect(memcmp(expected.data, actual.data, expected.dataSize) == 0, what);
+        expect(expected.crc == actual.crc, what);
+        if (compareRaw) {
+            expect(expected.rawSize == actual.rawSize, what);
+            expect(memcmp(expected.rawPacket, actual.rawPacket, expected.rawSize) == 0, what);
+        }
+    }
+
+    void fuzzCrc(const uint8_t *data, size_t size) {
+        uint8_t const expected = ReferenceCodec::calculateCRC8(data, size);
+
+        expect(ProtocolUtils::calculateCRC8(data, size) == expected, "calculateCRC8");
+        expect(Crc8Engine::updateBitwise(ProtocolConstants::CRC_INITIAL, data, size) == expected, "CRC8 BITWISE");
+        expect(Crc8Engine::updateTable(ProtocolConstants::CRC_INITIAL, data, size) == expected, "CRC8 TABLE");
+#ifdef MIRLIB_CRC8_HAS_SLICING
+        expect(Crc8Engine::updateSlice4(ProtocolConstants::CRC_INITIAL, data, size) == expected, "CRC8 SLICE4");
+        expect(Crc8Engine::updateSlice8(ProtocolConstants::CRC_INITIAL, data, size) == expected, "CRC8 SLICE8");
+#endif
+
+        // Побайтно, затем пачкой
+        Crc8Accumulator accumulator;
+        size_t const split = size / 3;
+        for (size_t i = 0; i < split; i++) {
+            accumulator.add(data[i]);
+        }
+        accumulator.add(data + split, size - split);
+        expect(accumulator.value() == expected, "Crc8Accumulator");
+    }
+
+    /**
+     * @brief Сравнение ядра стаффинга/снятия стаффинга с эталоном
+     */
+    void expectSameKernel(StuffingEngine::KernelFunc kernel, const uint8_t *input, size_t inputSize,
+                          size_t outputMaxSize, size_t expectedSize, const uint8_t *expected, const char *what) {
+        // Буфер ровно outputMaxSize байт: выход за его границу поймает ASan
+        uint8_t *const output = new uint8_t[outputMaxSize != 0 ? outputMaxSize : 1];
+        size_t const actualSize = kernel(input, inputSize, output, outputMaxSize);
+        bool const same = actualSize == expectedSize && memcmp(output, expected, expectedSize) == 0;
+        delete[] output;
+        expect(same, what);
+    }
+
+    void fuzzStuffing(const uint8_t *data, size_t size, bool unstuff) {
+        if (size == 0) {
+            return;
+        }
+
+        size_t const outputMaxSize = data[0];
+        const uint8_t *const input = data + 1;
+        size_t const inputSize = size - 1;
+
+        uint8_t expected[256];
+        size_t const expectedSize = unstuff
+                                        ? ReferenceCodec::byteUnstuffing(input, inputSize, expected, outputMaxSize)
+                                        : ReferenceCodec::byteStuffing(input, inputSize, expected, outputMaxSize);
+
+        if (unstuff) {
+            expectSameKernel(ProtocolUtils::byteUnstuffing, input, inputSize, outputMaxSize, expectedSize, expected,
+                             "byteUnstuffing");
+            expectSameKernel(StuffingEngine::unstuffScalar, input, inputSize, outputMaxSize, expectedSize, expected,
+                             "unstuffScalar");
+#ifdef MIRLIB_STUFFING_HAS_X86
+            expectSameKernel(StuffingEngine::unstuffSse2, input, inputSize, outputMaxSize, expectedSize, expected,
+                             "unstuffSse2");
+            if (StuffingEngine::hasAvx2()) {
+                expectSameKernel(StuffingEngine::unstuffAvx2, input, inputSize, outputMaxSize, expectedSize, expected,
+                                 "unstuffAvx2");
+            }
+#endif
+#ifdef MIRLIB_STUFFING_HAS_NEON
+            expectSameKernel(StuffingEngine::unstuffNeon, input, inputSize, outputMaxSize, expectedSize, expected,
+                             "unstuffNeon");
+#endif
+
+            // Снятие стаффинга на месте
+            if (inputSize > 0) {
+                uint8_t *const buffer = new uint8_t[inputSize];
+                memcpy(buffer, input, inputSize);
+                size_t const inPlaceSize = StuffingEngine::unstuff(buffer, inputSize, buffer, outputMaxSize);
+                bool const same = inPlaceSize == expectedSize && memcmp(buffer, expected, expectedSize) == 0;
+                delete[] buffer;
+                expect(same, "unstuff in place");
+            }
+        } else {
+            expectSameKernel(ProtocolUtils::byteStuffing, input, inputSize, outputMaxSize, expectedSize, expected,
+                             "byteStuffing");
+            expectSameKernel(StuffingEngine::stuffScalar, input, inputSize, outputMaxSize, expectedSize, expected,
+                             "stuffScalar");
+#ifdef MIRLIB_STUFFING_HAS_X86
+            expectSameKernel(StuffingEngine::stuffSse2, input, inputSize, outputMaxSize, expectedSize, expected,
+                             "stuffSse2");
+            if (StuffingEngine::hasAvx2()) {
+                expectSameKernel(StuffingEngine::stuffAvx2, input, inputSize, outputMaxSize, expectedSize, expected,
+                                 "stuffAvx2");
+            }
+#endif
+#ifdef MIRLIB_STUFFING_HAS_NEON
+            expectSameKernel(StuffingEngine::stuffNeon, input, inputSize, outputMaxSize, expectedSize, expected,
+                             "stuffNeon");
+#endif
+        }
+    }
+
+    void fuzzDecode(const uint8_t *raw, size_t rawSize) {
+        // unpackPacket: кадр не длиннее MAX_PACKET_SIZE, сырой кадр сохраняется
+        PacketData expected;
+        bool const expectedOk = ReferenceCodec::unpackPacket(raw, rawSize, expected, FUZZ_ENCODING_KEY);
+        PacketData actual;
+        bool const actualOk = ProtocolUtils::unpackPacket(raw, rawSize, actual, FUZZ_ENCODING_KEY);
+        expect(expectedOk == actualOk, "unpackPacket accept/reject");
+        if (expectedOk) {
+            expectSamePacket(expected, actual, true, "unpackPacket fields");
+        }
+
+        // decodePacket без копии сырого кадра: длина не ограничена
+        PacketData decoded;
+        bool const decodedOk = ReferenceCodec::decodePacket(raw, rawSize, decoded, FUZZ_ENCODING_KEY);
+        PacketData fast;
+        bool const fastOk = ProtocolUtils::decodePacket(raw, rawSize, fast, false, FUZZ_ENCODING_KEY);
+        expect(decodedOk == fastOk, "decodePacket accept/reject");
+        if (decodedOk) {
+            expectSamePacket(decoded, fast, false, "decodePacket fields");
+        }
+
+        uint8_t frame[ProtocolConstants::MAX_PACKET_SIZE];
+        size_t frameSize = 0;
+        bool const frameOk = ProtocolUtils::unstuffFrame(raw, rawSize, frame, frameSize);
+        expect(frameOk == decodedOk, "unstuffFrame accept/reject");
+        if (frameOk) {
+            expect(frameSize == ProtocolConstants::HEADER_SIZE + decoded.dataSize + 1, "unstuffFrame size");
+        }
+
+        PacketView view;
+        bool const viewOk = view.decode(raw, rawSize, frame, FUZZ_ENCODING_KEY);
+        expect(viewOk == decodedOk, "PacketView::decode accept/reject");
+        if (viewOk) {
+            PacketData fromView;
+            bool const rebuiltOk = view.toPacketData(fromView, FUZZ_ENCODING_KEY);
+            expectSamePacket(decoded, fromView, false, "PacketView fields");
+            // Сырой кадр - принятый кадр, снова прошедший стаффинг: те же поля и CRC,
+            // тот же байт резерва
+            if (rawSize <= ProtocolConstants::MAX_PACKET_SIZE) {
+                PacketData rebuilt;
+                expect(rebuiltOk && fromView.isValid() &&
+                       ProtocolUtils::unpackPacket(fromView.rawPacket, fromView.rawSize, rebuilt, FUZZ_ENCODING_KEY),
+                       "PacketView::toPacketData raw frame");
+                expectSamePacket(decoded, rebuilt, false, "PacketView::toPacketData raw frame fields");
+
+                uint8_t frame[ProtocolConstants::MAX_PACKET_SIZE];
+                size_t frameSize = 0;
+                expect(ProtocolUtils::unstuffFrame(fromView.rawPacket, fromView.rawSize, frame, frameSize) &&
+                       frameSize == view.frameSize() &&
+                       memcmp(frame, view.frame(), ProtocolConstants::HEADER_SIZE) == 0 &&
+                       frame[frameSize - 1] == view.frame()[frameSize - 1],
+                       "PacketView::toPacketData reserve and CRC");
+            }
+        }
+
+        // Разбор на месте, как в MirlibBase::receiveFrame
+        size_t const bufferSize = rawSize > ProtocolConstants::MAX_PACKET_SIZE ? rawSize
+                                                                                : ProtocolConstants::MAX_PACKET_SIZE;
+        uint8_t *const buffer = new uint8_t[bufferSize];
+        memcpy(buffer, raw, rawSize);
+        PacketView inPlace;
+        bool const inPlaceOk = inPlace.decode(buffer, rawSize, buffer, FUZZ_ENCODING_KEY);
+        bool inPlaceSame = inPlaceOk == decodedOk;
+        if (inPlaceOk && inPlaceSame) {
+            PacketData fromView;
+            inPlace.toPacketData(fromView, FUZZ_ENCODING_KEY);
+            inPlaceSame = memcmp(fromView.data, decoded.data, decoded.dataSize) == 0 &&
+                          fromView.passwordOrStatus == decoded.passwordOrStatus && fromView.crc == decoded.crc;
+        }
+        delete[] buffer;
+        expect(inPlaceSame, "PacketView::decode in place");
+
+        // Фильтр заголовка никогда не отбрасывает корректный кадр со своими полями
+        if (decodedOk) {
+            PacketFilter filter;
+            filter.dest = AddressFilter::single(decoded.destAddress);
+            filter.src = AddressFilter::single(decoded.srcAddress);
+            filter.setCommand(decoded.command);
+            expect(ProtocolUtils::matchHeader(raw, rawSize, filter), "matchHeader rejected a valid frame");
+        }
+
+        // decodeBatch: одна запись `len, raw`, кадры не декодируются ключом
+        if (rawSize <= 0xFF) {
+            uint8_t *const record = new uint8_t[rawSize + 1];
+            record[0] = static_cast<uint8_t>(rawSize);
+            memcpy(record + 1, raw, rawSize);
+
+            uint16_t dest = 0;
+            uint16_t src = 0;
+            uint8_t command = 0;
+            uint32_t status = 0;
+            uint32_t offset = 0;
+            uint8_t length = 0;
+            uint8_t valid = 0;
+            uint8_t batchData[ProtocolConstants::MAX_DATA_SIZE];
+            PacketBatch batch;
+            batch.destAddress = &dest;
+            batch.srcAddress = &src;
+            batch.command = &command;
+            batch.passwordOrStatus = &status;
+            batch.dataOffset = &offset;
+            batch.dataLength = &length;
+            batch.valid = &valid;
+            batch.data = batchData;
+            batch.capacity = 1;
+            size_t const count = ProtocolUtils::decodeBatch(record, rawSize + 1, batch);
+            delete[] record;
+
+            PacketData plain;
+            bool const plainOk = ReferenceCodec::unpackPacket(raw, rawSize, plain);
+            expect(count == 1, "decodeBatch count");
+            expect(batch.isValid(0) == plainOk, "decodeBatch accept/reject");
+            if (plainOk) {
+                expect(dest == plain.destAddress && src == plain.srcAddress && command == plain.command &&
+                       status == plain.passwordOrStatus && length == plain.dataSize &&
+                       memcmp(batchData + offset, plain.data, plain.dataSize) == 0, "decodeBatch fields");
+            }
+        }
+
+        // FrameUnstuffer: только кадры без 0x55 внутри (в потоке первый 0x55 - стоп-байт)
+        bool streamable = rawSize >= ProtocolConstants::FRAMING_SIZE &&
+                          raw[0] == ProtocolConstants::START1 && raw[1] == ProtocolConstants::START2 &&
+                          raw[rawSize - 1] == ProtocolConstants::STOP;
+        for (size_t i = 2; streamable && i + 1 < rawSize; i++) {
+            streamable = raw[i] != ProtocolConstants::STOP;
+        }
+        if (streamable) {
+            FrameUnstuffer unstuffer;
+            FrameUnstuffer::Result result = FrameUnstuffer::RESULT_PENDING;
+            size_t position = 0;
+            size_t burst = 1;
+            while (position < rawSize && result == FrameUnstuffer::RESULT_PENDING) {
+                size_t const chunk = (burst < rawSize - position) ? burst : rawSize - position;
+                size_t consumed = 0;
+                result = unstuffer.feed(raw + position, chunk, consumed);
+                position += consumed;
+                burst = (burst * 3 + rawSize) % 17 + 1;
+            }
+            expect(position == rawSize, "FrameUnstuffer stopped early");
+            expect((result == FrameUnstuffer::RESULT_VALID) == decodedOk, "FrameUnstuffer accept/reject");
+            if (decodedOk) {
+                PacketView streamed;
+                expect(unstuffer.attach(streamed, FUZZ_ENCODING_KEY), "FrameUnstuffer::attach");
+                PacketData fromStream;
+                streamed.toPacketData(fromStream, FUZZ_ENCODING_KEY);
+                expectSamePacket(decoded, fromStream, false, "FrameUnstuffer fields");
+            }
+        }
+    }
+
+    void fuzzPack(const uint8_t *data, size_t size) {
+        uint8_t fields[11 + 256];
+        memset(fields, 0, sizeof(fields));
+        memcpy(fields, data, size < sizeof(fields) ? size : sizeof(fields));
+
+        PacketData expected;
+        expected.clear();
+        expected.params.fromByte(fields[0]);
+        expected.destAddress = ProtocolUtils::bytesToUint16(fields + 1);
+        expected.srcAddress = ProtocolUtils::bytesToUint16(fields + 3);
+        expected.command = fields[5];
+        expected.passwordOrStatus = ProtocolUtils::bytesToUint32(fields + 6);
+        uint8_t const dataSize = fields[10];
+        const uint8_t *const payload = fields + 11;
+        expected.dataSize = dataSize <= ProtocolConstants::MAX_DATA_SIZE ? dataSize : 0;
+        memcpy(expected.data, payload, expected.dataSize);
+        if (dataSize > ProtocolConstants::MAX_DATA_SIZE) {
+            expected.dataSize = dataSize; // Rejected by both without touching data
+        }
+
+        PacketData actual = expected;
+        bool const expectedOk = ReferenceCodec::packPacket(expected, FUZZ_ENCODING_KEY);
+        bool const actualOk = ProtocolUtils::packPacket(actual, FUZZ_ENCODING_KEY);
+        expect(expectedOk == actualOk, "packPacket accept/reject");
+        if (expectedOk) {
+            expectSamePacket(expected, actual, true, "packPacket output");
+
+            // Упакованный кадр разбирается обратно в те же поля
+            PacketData decoded;
+            expect(ProtocolUtils::unpackPacket(actual.rawPacket, actual.rawSize, decoded, FUZZ_ENCODING_KEY),
+                   "packPacket round trip");
+            expectSamePacket(actual, decoded, true, "packPacket round trip fields");
+        }
+
+        bool const encoded = (fields[0] & 0x80) != 0;
+        PacketData expectedRequest;
+        PacketData actualRequest;
+        bool const requestOk = ReferenceCodec::createRequestPacket(
+            fields[5], expected.destAddress, expected.srcAddress, expected.passwordOrStatus, payload, dataSize,
+            expectedRequest, encoded, FUZZ_ENCODING_KEY);
+        expect(requestOk == ProtocolUtils::createRequestPacket(
+                   fields[5], expected.destAddress, expected.srcAddress, expected.passwordOrStatus, payload, dataSize,
+                   actualRequest, encoded, FUZZ_ENCODING_KEY), "createRequestPacket accept/reject");
+        if (!requestOk) {
+            return;
+        }
+        expectSamePacket(expectedRequest, actualRequest, true, "createRequestPacket output");
+
+        // Ответ на этот запрос: данные ответа - те же байты в обратном порядке
+        uint8_t const responseSize = static_cast<uint8_t>(dataSize ^ fields[0]) % (ProtocolConstants::MAX_DATA_SIZE + 1);
+        uint8_t response[ProtocolConstants::MAX_DATA_SIZE];
+        for (uint8_t i = 0; i < responseSize; i++) {
+            response[i] = payload[responseSize - 1 - i];
+        }
+
+        PacketData expectedResponse;
+        PacketData actualResponse;
+        bool const responseOk = ReferenceCodec::createResponsePacket(expectedRequest, expected.passwordOrStatus, response,
+                                                                     responseSize, expectedResponse, FUZZ_ENCODING_KEY);
+        expect(responseOk == ProtocolUtils::createResponsePacket(actualRequest, expected.passwordOrStatus, response,
+                                                                 responseSize, actualResponse, FUZZ_ENCODING_KEY),
+               "createResponsePacket accept/reject");
+        if (!responseOk) {
+            return;
+        }
+        expectSamePacket(expectedResponse, actualResponse, true, "createResponsePacket output");
+
+        // Перегрузка для PacketView дает тот же кадр
+        uint8_t frame[ProtocolConstants::MAX_PACKET_SIZE];
+        PacketView view;
+        expect(view.decode(actualRequest.rawPacket, actualRequest.rawSize, frame, FUZZ_ENCODING_KEY),
+               "request view decode");
+        PacketData viewResponse;
+        expect(ProtocolUtils::createResponsePacket(view, expected.passwordOrStatus, response, responseSize,
+                                                   viewResponse, FUZZ_ENCODING_KEY), "createResponsePacket(view)");
+        expectSamePacket(expectedResponse, viewResponse, true, "createResponsePacket(view) output");
+    }
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    if (size == 0) {
+        return 0;
+    }
+
+    g_input = data;
+    g_inputSize = size;
+
+    const uint8_t *const payload = data + 1;
+    size_t const payloadSize = size - 1;
+
+    switch (data[0] % FUZZ_TARGET_COUNT) {
+        case FUZZ_CRC:
+            fuzzCrc(payload, payloadSize);
+            break;
+        case FUZZ_STUFF:
+            fuzzStuffing(payload, payloadSize > 256 ? 256 : payloadSize, false);
+            break;
+        case FUZZ_UNSTUFF:
+            fuzzStuffing(payload, payloadSize > 256 ? 256 : payloadSize, true);
+            break;
+        case FUZZ_DECODE:
+            fuzzDecode(payload, payloadSize);
+            break;
+        case FUZZ_PACK:
+        default:
+            fuzzPack(payload, payloadSize);
+            break;
+    }
+
+    return 0;
+}
@@ -0,0 +1,71 @@
+#ifndef MIRLIB_HOST_ARDUINO_H
+#define MIRLIB_HOST_ARDUINO_H
+
+/*
+ * Минимальная замена Arduino.h для хостовых утилит (бенчмарк, фаззинг).
+ * Содержит только то, что используют модули библиотеки; MirlibBase/Client/Server
+ * собираются с ней без драйвера CC1101 (MIRLIB_NO_ELECHOUSE) и работают через
+ * LoopbackRadio.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <thread>
+
+typedef uint8_t byte;
+
+#define HEX 16
+#define DEC 10
+#define F(x) (x)
+
+inline unsigned long micros() {
+    static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    return static_cast<unsigned long>(
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
+inline unsigned long millis() {
+    return micros() / 1000UL;
+}
+
+inline void delay(unsigned long ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+inline void delayMicroseconds(unsigned int us) {
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+inline void yield() {
+    std::this_thread::yield();
+}
+
+/**
+ * @brief Вывод Serial в stderr (stdout остается для результатов утилит)
+ */
+struct HostSerial {
+    void begin(unsigned long) {}
+    void print(const char *text) { fputs(text, stderr); }
+    void print(char value) { fputc(value, stderr); }
+    void print(unsigned long value, int base = DEC) { fprintf(stderr, base == HEX ? "%lX" : "%lu", value); }
+    void print(long value) { fprintf(stderr, "%ld", value); }
+    void print(int value, int base = DEC) {
+        if (base == HEX) print(static_cast<unsigned long>(static_cast<unsigned>(value)), HEX);
+        else print(static_cast<long>(value));
+    }
+    void print(unsigned value, int base = DEC) { print(static_cast<unsigned long>(value), base); }
+    void print(double value, int digits = 2) { fprintf(stderr, "%.*f", digits, value); }
+    void println() { fputc('\n', stderr); }
+    template<typename T>
+    void println(T value) { print(value); println(); }
+    template<typename T>
+    void println(T value, int format) { print(value, format); println(); }
+};
+
+static HostSerial Serial __attribute__((unused));
+
+#endif // MIRLIB_HOST_ARDUINO_H
@@ -0,0 +1,491 @@
+#include "LoopbackRadio.h"
+
+namespace {
+    // CC1101 registers and strobes
+    const uint8_t REG_FIFOTHR = 0x03;
+    const uint8_t REG_CHANNR = 0x0A;
+    const uint8_t REG_PKTCTRL1 = 0x07;
+    const uint8_t REG_MCSM1 = 0x17;
+    const uint8_t REG_PATABLE = 0x3E;
+    const uint8_t REG_FIFO = 0x3F;
+    const uint8_t STATUS_MARCSTATE = 0x35;
+    const uint8_t STATUS_TXBYTES = 0x3A;
+    const uint8_t STATUS_RXBYTES = 0x3B;
+
+    const uint8_t SRES = 0x30;
+    const uint8_t SCAL = 0x33;
+    const uint8_t SRX = 0x34;
+    const uint8_t STX = 0x35;
+    const uint8_t SIDLE = 0x36;
+    const uint8_t SFRX = 0x3A;
+
+    const uint8_t MARCSTATE_IDLE = 0x01;
+    const uint8_t MARCSTATE_RX = 0x0D;
+    const uint8_t MARCSTATE_RXFIFO_OVERFLOW = 0x11;
+    const uint8_t MARCSTATE_TX = 0x13;
+
+    class Lock {
+    public:
+        explicit Lock(pthread_mutex_t &mutex) : m_mutex(mutex) { pthread_mutex_lock(&m_mutex); }
+        ~Lock() { pthread_mutex_unlock(&m_mutex); }
+
+    private:
+        pthread_mutex_t &m_mutex;
+    };
+}
+
+bool LoopbackRadio::Queue::push(const uint8_t *data, uint8_t size, const uint8_t status[2]) {
+    if (count >= QUEUE_SIZE || size > ProtocolConstants::MAX_PACKET_SIZE) {
+        return false;
+    }
+
+    Frame &frame = frames[(head + count) % QUEUE_SIZE];
+    frame.size = size;
+    frame.status[0] = status[0];
+    frame.status[1] = status[1];
+    memcpy(frame.bytes, data, size);
+    count++;
+    return true;
+}
+
+LoopbackRadio::LoopbackRadio()
+    : m_peer(nullptr)
+      , m_medium(nullptr)
+      , m_state(STATE_IDLE)
+      , m_paTable(0)
+      , m_overflow(false)
+      , m_fifoOffset(0)
+      , m_handler(nullptr)
+      , m_context(nullptr)
+      , m_fifoHandler(nullptr)
+      , m_fifoContext(nullptr)
+      , m_framesSent(0)
+      , m_framesReceived(0)
+      , m_framesDropped(0)
+      , m_strobes(0)
+{
+    pthread_mutex_init(&m_mutex, nullptr);
+    memset(m_registers, 0, sizeof(m_registers));
+    // -60 dBm, LQI 4, CRC_OK
+    m_signal[0] = 0x1C;
+    m_signal[1] = 0x84;
+    flushFifo();
+    m_air.clear();
+}
+
+LoopbackRadio::~LoopbackRadio() {
+    pthread_mutex_destroy(&m_mutex);
+}
+
+void LoopbackRadio::connect(LoopbackRadio &a, LoopbackRadio &b) {
+    a.m_peer = &b;
+    b.m_peer = &a;
+}
+
+uint8_t LoopbackRadio::channel() {
+    Lock lock(m_mutex);
+    return m_registers[REG_CHANNR];
+}
+
+void LoopbackRadio::setSignal(uint8_t rssi, uint8_t lqi) {
+    Lock lock(m_mutex);
+    m_signal[0] = rssi;
+    m_signal[1] = lqi;
+}
+
+bool LoopbackRadio::begin(int) {
+    return true;
+}
+
+void LoopbackRadio::strobe(uint8_t command) {
+    uint8_t arrived = 0;
+    {
+        Lock lock(m_mutex);
+        m_strobes++;
+
+        switch (command) {
+            case SRES:
+                memset(m_registers, 0, sizeof(m_registers));
+                flushFifo();
+                m_overflow = false;
+                m_state = STATE_IDLE;
+                break;
+            case SCAL:
+            case SIDLE:
+                m_state = STATE_IDLE;
+                break;
+            case SRX:
+                if (!m_overflow) {
+                    arrived = enterRx();
+                }
+                break;
+            case STX:
+                m_state = STATE_TX;
+                break;
+            case SFRX:
+                flushFifo();
+                if (m_overflow) {
+                    m_overflow = false;
+                    m_state = STATE_IDLE;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    signalFrames(arrived);
+}
+
+void LoopbackRadio::writeRegister(uint8_t address, uint8_t value) {
+    Lock lock(m_mutex);
+    if (address == REG_PATABLE) {
+        m_paTable = value;
+    } else if (address < REGISTER_COUNT) {
+        m_registers[address] = value;
+    }
+}
+
+void LoopbackRadio::writeBurst(uint8_t address, const uint8_t *data, uint8_t size) {
+    Lock lock(m_mutex);
+    for (uint8_t i = 0; i < size && address + i < REGISTER_COUNT; i++) {
+        m_registers[address + i] = data[i];
+    }
+}
+
+uint8_t LoopbackRadio::readRegister(uint8_t address) {
+    Lock lock(m_mutex);
+    if (address == REG_PATABLE) {
+        return m_paTable;
+    }
+    return address < REGISTER_COUNT ? m_registers[address] : 0;
+}
+
+uint8_t LoopbackRadio::readStatus(uint8_t address) {
+    Lock lock(m_mutex);
+    switch (address & REG_FIFO) {
+        case STATUS_MARCSTATE:
+            if (m_overflow) {
+                return MARCSTATE_RXFIFO_OVERFLOW;
+            }
+            return m_state == STATE_RX ? MARCSTATE_RX : (m_state == STATE_TX ? MARCSTATE_TX : MARCSTATE_IDLE);
+        case STATUS_RXBYTES:
+            return static_cast<uint8_t>(fifoBytes() | (m_overflow ? 0x80 : 0x00));
+        case STATUS_TXBYTES:
+            return 0;
+        default:
+            return 0;
+    }
+}
+
+void LoopbackRadio::send(const uint8_t *data, uint8_t size) {
+    LoopbackRadio *peer;
+    AirMedium *medium;
+    uint8_t channel;
+    uint8_t signal[2];
+    {
+        Lock lock(m_mutex);
+        m_state = STATE_TX;
+        m_framesSent++;
+        peer = m_peer;
+        medium = m_medium;
+        channel = m_registers[REG_CHANNR];
+        signal[0] = m_signal[0];
+        signal[1] = m_signal[1];
+    }
+
+    if (medium != nullptr) {
+        medium->transmit(this, channel, data, size, signal);
+    } else if (peer != nullptr) {
+        peer->deliver(data, size, signal);
+    }
+
+    uint8_t arrived = 0;
+    {
+        Lock lock(m_mutex);
+        // TXOFF_MODE 11 returns to RX, other modes are modelled as IDLE
+        if ((m_registers[REG_MCSM1] & 0x03) == 0x03) {
+            arrived = enterRx();
+        } else {
+            m_state = STATE_IDLE;
+        }
+    }
+    signalFrames(arrived);
+}
+
+bool LoopbackRadio::receiveReady() {
+    uint8_t arrived = 0;
+    bool ready;
+    {
+        // Like CheckReceiveFlag: enter RX if not there yet
+        Lock lock(m_mutex);
+        if (m_state != STATE_RX) {
+            arrived = enterRx();
+        }
+        ready = m_fifo.count > 0;
+    }
+    signalFrames(arrived);
+    return ready;
+}
+
+int LoopbackRadio::receive(uint8_t *buffer, uint8_t status[2]) {
+    uint8_t arrived = 0;
+    int size = 0;
+    {
+        // Like ReceiveData: read the first frame, then SFRX and SRX
+        Lock lock(m_mutex);
+        if (m_fifo.count > 0) {
+            const Frame &frame = m_fifo.frames[m_fifo.head];
+            memcpy(buffer, frame.bytes, frame.size);
+            status[0] = frame.status[0];
+            status[1] = frame.status[1];
+            size = frame.size;
+            m_framesReceived++;
+        }
+        flushFifo();
+        m_overflow = false;
+        m_strobes += 2;
+        arrived = enterRx();
+    }
+    signalFrames(arrived);
+    return size;
+}
+
+int LoopbackRadio::readFrame(uint8_t *buffer, uint8_t status[2]) {
+    Lock lock(m_mutex);
+    if (m_fifo.count == 0) {
+        return 0;
+    }
+    if (m_fifoOffset != 0) {
+        // Frame partly read by readFifo(), its length byte is gone
+        return -1;
+    }
+
+    const Frame &frame = m_fifo.frames[m_fifo.head];
+    memcpy(buffer, frame.bytes, frame.size);
+    status[0] = frame.status[0];
+    status[1] = frame.status[1];
+    m_fifo.head = static_cast<uint8_t>((m_fifo.head + 1) % QUEUE_SIZE);
+    m_fifo.count--;
+    m_framesReceived++;
+    return frame.size;
+}
+
+void LoopbackRadio::readFifo(uint8_t *buffer, uint8_t count) {
+    Lock lock(m_mutex);
+    for (uint8_t i = 0; i < count; i++) {
+        if (m_fifo.count == 0) {
+            buffer[i] = 0; // Underflow reads garbage on the chip
+            continue;
+        }
+
+        // Length byte, frame bytes, status bytes
+        const Frame &frame = m_fifo.frames[m_fifo.head];
+        if (m_fifoOffset == 0) {
+            buffer[i] = frame.size;
+        } else if (m_fifoOffset <= frame.size) {
+            buffer[i] = frame.bytes[m_fifoOffset - 1];
+        } else {
+            buffer[i] = frame.status[m_fifoOffset - frame.size - 1];
+        }
+        if (++m_fifoOffset > frame.size + statusBytes()) {
+            m_fifo.head = static_cast<uint8_t>((m_fifo.head + 1) % QUEUE_SIZE);
+            m_fifo.count--;
+            m_fifoOffset = 0;
+            m_framesReceived++;
+        }
+    }
+}
+
+bool LoopbackRadio::attachFifoSignal(int, ReceiveSignalHandler handler, void *context) {
+    Lock lock(m_mutex);
+    if (handler == nullptr || (m_fifoHandler != nullptr && m_fifoContext != context)) {
+        return false;
+    }
+    m_fifoHandler = handler;
+    m_fifoContext = context;
+    return true;
+}
+
+void LoopbackRadio::detachFifoSignal() {
+    Lock lock(m_mutex);
+    m_fifoHandler = nullptr;
+    m_fifoContext = nullptr;
+}
+
+bool LoopbackRadio::attachReceiveSignal(ReceiveSignalHandler handler, void *context) {
+    Lock lock(m_mutex);
+    if (handler == nullptr || (m_handler != nullptr && m_context != context)) {
+        return false;
+    }
+    m_handler = handler;
+    m_context = context;
+    return true;
+}
+
+void LoopbackRadio::detachReceiveSignal() {
+    Lock lock(m_mutex);
+    m_handler = nullptr;
+    m_context = nullptr;
+}
+
+void LoopbackRadio::deliver(const uint8_t *data, uint8_t size, const uint8_t status[2]) {
+    uint8_t arrived = 0;
+    {
+        Lock lock(m_mutex);
+        if (m_state == STATE_RX) {
+            if (!m_overflow && m_fifo.push(data, size, status)) {
+                arrived = 1;
+            } else {
+                m_overflow = true;
+                m_framesDropped++;
+            }
+        } else if (!m_air.push(data, size, status)) {
+            m_framesDropped++;
+        }
+    }
+    signalFrames(arrived);
+}
+
+uint8_t LoopbackRadio::enterRx() {
+    m_state = STATE_RX;
+
+    uint8_t arrived = 0;
+    while (m_air.count > 0) {
+        const Frame &frame = m_air.frames[m_air.head];
+        if (!m_overflow && m_fifo.push(frame.bytes, frame.size, frame.status)) {
+            arrived++;
+        } else {
+            m_overflow = true;
+            m_framesDropped++;
+        }
+        m_air.head = static_cast<uint8_t>((m_air.head + 1) % QUEUE_SIZE);
+        m_air.count--;
+    }
+    return arrived;
+}
+
+void LoopbackRadio::signalFrames(uint8_t count) {
+    for (uint8_t i = 0; i < count; i++) {
+        ReceiveSignalHandler handler;
+        void *context;
+        ReceiveSignalHandler fifoHandler;
+        void *fifoContext;
+        bool threshold;
+        {
+            Lock lock(m_mutex);
+            handler = m_handler;
+            context = m_context;
+            fifoHandler = m_fifoHandler;
+            fifoContext = m_fifoContext;
+            // FIFO_THR n: RX threshold 4 * (n + 1) bytes
+            threshold = fifoBytes() >= 4 * ((m_registers[REG_FIFOTHR] & 0x0F) + 1);
+        }
+        if (handler == nullptr) {
+            return;
+        }
+        handler(context, true);
+        if (threshold && fifoHandler != nullptr) {
+            fifoHandler(fifoContext, true);
+        }
+        handler(context, false);
+    }
+}
+
+uint8_t LoopbackRadio::fifoBytes() const {
+    // Length byte, frame bytes and status bytes
+    unsigned bytes = 0;
+    for (uint8_t i = 0; i < m_fifo.count; i++) {
+        bytes += 1 + m_fifo.frames[(m_fifo.head + i) % QUEUE_SIZE].size + statusBytes();
+    }
+    bytes -= m_fifoOffset;
+    return static_cast<uint8_t>(bytes > 0x7F ? 0x7F : bytes);
+}
+
+uint8_t LoopbackRadio::statusBytes() const {
+    return (m_registers[REG_PKTCTRL1] & 0x04) != 0 ? 2 : 0;
+}
+
+void LoopbackRadio::flushFifo() {
+    m_fifo.clear();
+    m_fifoOffset = 0;
+}
+
+AirMedium::AirMedium(uint32_t airtimeUs)
+    : m_count(0)
+      , m_airtimeUs(airtimeUs)
+      , m_framesSent(0)
+      , m_collisions(0)
+{
+    pthread_mutex_init(&m_mutex, nullptr);
+    memset(m_transmissions, 0, sizeof(m_transmissions));
+}
+
+AirMedium::~AirMedium() {
+    pthread_mutex_destroy(&m_mutex);
+}
+
+bool AirMedium::attach(LoopbackRadio &radio) {
+    Lock lock(m_mutex);
+    if (m_count >= MAX_RADIOS) {
+        return false;
+    }
+
+    m_radios[m_count++] = &radio;
+    radio.m_medium = this;
+    radio.m_peer = nullptr;
+    return true;
+}
+
+void AirMedium::transmit(LoopbackRadio *sender, uint8_t channel, const uint8_t *data, uint8_t size,
+                         const uint8_t status[2]) {
+    LoopbackRadio *radios[MAX_RADIOS];
+    uint8_t count;
+    bool collided = false;
+    {
+        Lock lock(m_mutex);
+        m_framesSent++;
+        count = m_count;
+        memcpy(radios, m_radios, sizeof(radios));
+    }
+
+    if (m_airtimeUs != 0) {
+        uint8_t slot = 0;
+        {
+            Lock lock(m_mutex);
+            while (slot < m_count && m_radios[slot] != sender) {
+                slot++;
+            }
+
+            // Every frame already on this channel and the new one are lost
+            Transmission &own = m_transmissions[slot];
+            own.active = true;
+            own.collided = false;
+            own.channel = channel;
+            for (uint8_t i = 0; i < m_count; i++) {
+                Transmission &other = m_transmissions[i];
+                if (i != slot && other.active && other.channel == channel) {
+                    other.collided = true;
+                    own.collided = true;
+                }
+            }
+        }
+
+        delayMicroseconds(m_airtimeUs);
+
+        Lock lock(m_mutex);
+        collided = m_transmissions[slot].collided;
+        m_transmissions[slot].active = false;
+        if (collided) {
+            m_collisions++;
+        }
+    }
+
+    if (collided) {
+        return;
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        if (radios[i] != sender && radios[i]->channel() == channel) {
+            radios[i]->deliver(data, size, status);
+        }
+    }
+}
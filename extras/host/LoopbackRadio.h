@@ -0,0 +1,206 @@
+#ifndef MIRLIB_LOOPBACK_RADIO_H
+#define MIRLIB_LOOPBACK_RADIO_H
+
+#include <RadioBackend.h>
+
+#include <pthread.h>
+
+class AirMedium;
+
+/**
+ * @brief In-memory CC1101 for host builds: frames sent by one radio arrive at its peer
+ *
+ * Models what MirlibBase relies on: IDLE/RX/TX states driven by strobes and
+ * MCSM1 TXOFF_MODE (the radio stays in RX after a packet, RXOFF_MODE 11),
+ * an RX FIFO flushed by SFRX that overflows when full, registers, PATABLE,
+ * the RXBYTES/TXBYTES/MARCSTATE status registers, the GDO0 receive signal and
+ * the GDO2 FIFO threshold signal (FIFOTHR) and the RSSI/LQI status bytes
+ * appended with PKTCTRL1.APPEND_STATUS. Frames land in the FIFO whole, so
+ * GDO0 is never seen high and the threshold signal precedes end of packet.
+ * Signal handlers run on the sending thread, like an interrupt.
+ *
+ * The air is lossless: a frame sent while the peer is not in RX is held
+ * and delivered when the peer enters RX, so ping-pong benchmarks do not
+ * depend on thread scheduling.
+ *
+ * Instead of a peer a radio can be attached to an AirMedium shared by
+ * several radios; then frames only reach radios on the same channel (CHANNR).
+ */
+class LoopbackRadio : public RadioBackend {
+public:
+    LoopbackRadio();
+    ~LoopbackRadio() override;
+
+    LoopbackRadio(const LoopbackRadio &) = delete;
+    LoopbackRadio &operator=(const LoopbackRadio &) = delete;
+
+    /**
+     * @brief Connect two radios in both directions
+     */
+    static void connect(LoopbackRadio &a, LoopbackRadio &b);
+
+    /**
+     * @brief Channel the radio is tuned to (CHANNR)
+     */
+    uint8_t channel();
+
+    /**
+     * @brief Status bytes appended to frames of this radio at the receivers
+     * @param rssi Raw RSSI (dBm = rssi / 2 - 74)
+     * @param lqi LQI | CRC_OK
+     */
+    void setSignal(uint8_t rssi, uint8_t lqi);
+
+    bool begin(int gdo0Pin) override;
+    void strobe(uint8_t command) override;
+    void writeRegister(uint8_t address, uint8_t value) override;
+    void writeBurst(uint8_t address, const uint8_t *data, uint8_t size) override;
+    uint8_t readRegister(uint8_t address) override;
+    uint8_t readStatus(uint8_t address) override;
+    void send(const uint8_t *data, uint8_t size) override;
+    bool receiveReady() override;
+    int receive(uint8_t *buffer, uint8_t status[2]) override;
+    int readFrame(uint8_t *buffer, uint8_t status[2]) override;
+    void readFifo(uint8_t *buffer, uint8_t count) override;
+    bool attachFifoSignal(int gdo2Pin, ReceiveSignalHandler handler, void *context) override;
+    void detachFifoSignal() override;
+    bool attachReceiveSignal(ReceiveSignalHandler handler, void *context) override;
+    void detachReceiveSignal() override;
+
+    unsigned long framesSent() const { return m_framesSent; }
+    unsigned long framesReceived() const { return m_framesReceived; }
+    unsigned long framesDropped() const { return m_framesDropped; }
+    unsigned long strobeCount() const { return m_strobes; }
+
+private:
+    friend class AirMedium;
+
+    enum State {
+        STATE_IDLE,
+        STATE_RX,
+        STATE_TX
+    };
+
+    static const uint8_t QUEUE_SIZE = 4;
+    static const uint8_t REGISTER_COUNT = 0x2F;
+
+    struct Frame {
+        uint8_t size;
+        uint8_t status[2]; ///< RSSI, LQI | CRC_OK of the sender
+        uint8_t bytes[ProtocolConstants::MAX_PACKET_SIZE];
+    };
+
+    struct Queue {
+        Frame frames[QUEUE_SIZE];
+        uint8_t head;
+        uint8_t count;
+
+        bool push(const uint8_t *data, uint8_t size, const uint8_t status[2]);
+        void clear() { head = 0; count = 0; }
+    };
+
+    pthread_mutex_t m_mutex;
+    LoopbackRadio *m_peer;
+    AirMedium *m_medium;
+    State m_state;
+    uint8_t m_registers[REGISTER_COUNT];
+    uint8_t m_paTable;
+    Queue m_fifo; ///< RX FIFO
+    Queue m_air; ///< Frames sent while this radio was not in RX
+    bool m_overflow; ///< RX FIFO overflowed, cleared by SFRX
+    uint8_t m_fifoOffset; ///< Bytes of the first FIFO frame already read by readFifo() (length byte included)
+    uint8_t m_signal[2]; ///< Status bytes of frames sent by this radio
+    ReceiveSignalHandler m_handler;
+    void *m_context;
+    ReceiveSignalHandler m_fifoHandler;
+    void *m_fifoContext;
+
+    unsigned long m_framesSent;
+    unsigned long m_framesReceived;
+    unsigned long m_framesDropped;
+    unsigned long m_strobes;
+
+    /**
+     * @brief Frame arrives from the peer (peer thread)
+     */
+    void deliver(const uint8_t *data, uint8_t size, const uint8_t status[2]);
+
+    /**
+     * @brief Enter RX and move held frames into the FIFO (mutex held)
+     * @return Number of frames moved, signal is raised for each by the caller
+     */
+    uint8_t enterRx();
+
+    /**
+     * @brief Raise frame start and end of packet for each arrived frame (mutex released)
+     */
+    void signalFrames(uint8_t count);
+
+    uint8_t fifoBytes() const;
+
+    /**
+     * @brief Status bytes per frame in the FIFO: 2 with PKTCTRL1.APPEND_STATUS (mutex held)
+     */
+    uint8_t statusBytes() const;
+
+    /**
+     * @brief Drop all FIFO content (mutex held)
+     */
+    void flushFifo();
+};
+
+/**
+ * @brief Shared air for several LoopbackRadio: frames reach every other radio on the sender's channel
+ *
+ * With a non-zero airtime, send() takes that long and frames that overlap
+ * on one channel are lost (collision), so polling several meters on one
+ * channel has to be time-separated. With zero airtime frames are delivered
+ * at once and never collide.
+ */
+class AirMedium {
+public:
+    static const uint8_t MAX_RADIOS = 16;
+
+    /**
+     * @param airtimeUs Time on air of one frame
+     */
+    explicit AirMedium(uint32_t airtimeUs = 0);
+    ~AirMedium();
+
+    AirMedium(const AirMedium &) = delete;
+    AirMedium &operator=(const AirMedium &) = delete;
+
+    /**
+     * @brief Attach a radio (replaces a peer set by LoopbackRadio::connect)
+     * @return false if MAX_RADIOS radios are attached
+     */
+    bool attach(LoopbackRadio &radio);
+
+    unsigned long framesSent() const { return m_framesSent; }
+    unsigned long collisions() const { return m_collisions; }
+
+private:
+    friend class LoopbackRadio;
+
+    struct Transmission {
+        bool active;
+        bool collided;
+        uint8_t channel;
+    };
+
+    pthread_mutex_t m_mutex;
+    LoopbackRadio *m_radios[MAX_RADIOS];
+    uint8_t m_count;
+    Transmission m_transmissions[MAX_RADIOS]; ///< Frames on air, one per sending radio
+    uint32_t m_airtimeUs;
+    unsigned long m_framesSent;
+    unsigned long m_collisions;
+
+    /**
+     * @brief Put a frame on air and deliver it to radios on the channel (sender thread)
+     */
+    void transmit(LoopbackRadio *sender, uint8_t channel, const uint8_t *data, uint8_t size,
+                  const uint8_t status[2]);
+};
+
+#endif // MIRLIB_LOOPBACK_RADIO_H
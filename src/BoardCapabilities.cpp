@@ -0,0 +1,125 @@
+#include "BoardCapabilities.h"
+#include "Commands/ReadStatusCommand.h"
+#include "Commands/ReadInstantValueCommand.h"
+#include "Commands/GetInfoCommand.h"
+
+namespace {
+    struct BoardRow {
+        uint8_t boardId;
+        BoardGeneration generation;
+    };
+
+    // Known boards, one row per board ID
+    constexpr BoardRow BOARD_ROWS[] = {
+        {BOARD_OLD_01, BOARD_GENERATION_OLD},
+        {BOARD_OLD_02, BOARD_GENERATION_OLD},
+        {BOARD_OLD_03, BOARD_GENERATION_OLD},
+        {BOARD_OLD_04, BOARD_GENERATION_OLD},
+        {BOARD_OLD_0C, BOARD_GENERATION_OLD},
+        {BOARD_OLD_0D, BOARD_GENERATION_OLD},
+        {BOARD_OLD_11, BOARD_GENERATION_OLD},
+        {BOARD_OLD_12, BOARD_GENERATION_OLD},
+        {BOARD_TRANS_07, BOARD_GENERATION_TRANSITION},
+        {BOARD_TRANS_08, BOARD_GENERATION_TRANSITION},
+        {BOARD_TRANS_0A, BOARD_GENERATION_TRANSITION},
+        {BOARD_TRANS_0B, BOARD_GENERATION_TRANSITION},
+        {BOARD_NEW_09, BOARD_GENERATION_NEW},
+        {BOARD_NEW_0E, BOARD_GENERATION_NEW},
+        {BOARD_NEW_0F, BOARD_GENERATION_NEW},
+        {BOARD_NEW_10, BOARD_GENERATION_NEW},
+        {BOARD_NEW_20, BOARD_GENERATION_NEW},
+        {BOARD_NEW_21, BOARD_GENERATION_NEW},
+        {BOARD_NEW_22, BOARD_GENERATION_NEW},
+    };
+
+    constexpr size_t BOARD_ROW_COUNT = sizeof(BOARD_ROWS) / sizeof(BOARD_ROWS[0]);
+
+    constexpr uint8_t boardGenerationAt(unsigned boardId, size_t row) {
+        return row == BOARD_ROW_COUNT
+                   ? static_cast<uint8_t>(BOARD_GENERATION_UNKNOWN)
+                   : BOARD_ROWS[row].boardId == boardId
+                         ? static_cast<uint8_t>(BOARD_ROWS[row].generation)
+                         : boardGenerationAt(boardId, row + 1);
+    }
+
+    const uint8_t ALL_COMMANDS = BoardCapabilities::commandBit(CMD_PING) |
+                                 BoardCapabilities::commandBit(CMD_READ_STATUS) |
+                                 BoardCapabilities::commandBit(CMD_READ_DATE_TIME) |
+                                 BoardCapabilities::commandBit(CMD_READ_INSTANT_VALUE) |
+                                 BoardCapabilities::commandBit(CMD_GET_INFO);
+}
+
+// Table initializer expanded from constexpr lookups (no STL, works with PROGMEM)
+#define MIRLIB_BOARD_ROW4(n) \
+    boardGenerationAt((n), 0), boardGenerationAt((n) + 1, 0), \
+    boardGenerationAt((n) + 2, 0), boardGenerationAt((n) + 3, 0)
+#define MIRLIB_BOARD_ROW16(n) \
+    MIRLIB_BOARD_ROW4(n), MIRLIB_BOARD_ROW4((n) + 4), \
+    MIRLIB_BOARD_ROW4((n) + 8), MIRLIB_BOARD_ROW4((n) + 12)
+#define MIRLIB_BOARD_ROW64(n) \
+    MIRLIB_BOARD_ROW16(n), MIRLIB_BOARD_ROW16((n) + 16), \
+    MIRLIB_BOARD_ROW16((n) + 32), MIRLIB_BOARD_ROW16((n) + 48)
+
+const uint8_t BoardCapabilities::GENERATIONS[256] PROGMEM = {
+    MIRLIB_BOARD_ROW64(0), MIRLIB_BOARD_ROW64(64), MIRLIB_BOARD_ROW64(128), MIRLIB_BOARD_ROW64(192)
+};
+
+const BoardProfile BoardCapabilities::PROFILES[4] = {
+    // Unknown boards: nothing is rejected, any response size of a known generation is accepted
+    {
+        BOARD_GENERATION_UNKNOWN,
+        ALL_COMMANDS,
+        0,
+        0,
+        ReadStatusResponseOld::SIZE,
+        ReadStatusResponseNew::SIZE_EXTENDED,
+        ReadInstantValueResponseTransition::SIZE,
+        ReadInstantValueResponseNewBasic::SIZE,
+        GetInfoResponseBase::SIZE,
+        GetInfoResponseBase::SIZE_BATTERY,
+        0,
+        "Unknown"
+    },
+    {
+        BOARD_GENERATION_OLD,
+        static_cast<uint8_t>(ALL_COMMANDS & ~commandBit(CMD_READ_INSTANT_VALUE)),
+        0,
+        BOARD_OLD_01,
+        ReadStatusResponseOld::SIZE,
+        ReadStatusResponseOld::SIZE,
+        0,
+        0,
+        GetInfoResponseBase::SIZE,
+        GetInfoResponseBase::SIZE,
+        0,
+        "Old"
+    },
+    {
+        BOARD_GENERATION_TRANSITION,
+        ALL_COMMANDS,
+        ROLE_THRESHOLD,
+        BOARD_TRANS_07,
+        ReadStatusResponseNew::SIZE,
+        ReadStatusResponseNew::SIZE_EXTENDED,
+        ReadInstantValueResponseTransition::SIZE,
+        ReadInstantValueResponseTransition::SIZE_100A,
+        GetInfoResponseBase::SIZE,
+        GetInfoResponseBase::SIZE,
+        ReadInstantValueResponseTransition::CURRENT_WIDTH_100A,
+        "Transition"
+    },
+    {
+        BOARD_GENERATION_NEW,
+        ALL_COMMANDS,
+        ROLE_THRESHOLD,
+        BOARD_NEW_09,
+        ReadStatusResponseNew::SIZE,
+        ReadStatusResponseNew::SIZE_EXTENDED,
+        ReadInstantValueResponseNewBasic::SIZE,
+        ReadInstantValueResponseNewBasic::SIZE,
+        GetInfoResponseBase::SIZE_SHORT,
+        GetInfoResponseBase::SIZE_BATTERY,
+        ReadInstantValueResponseNewBasic::CURRENT_WIDTH,
+        "New"
+    }
+};
@@ -0,0 +1,122 @@
+#ifndef BOARD_CAPABILITIES_H
+#define BOARD_CAPABILITIES_H
+
+#include <Arduino.h>
+#include "ProtocolTypes.h"
+#include "MirlibDebug.h"
+
+#ifdef MIRLIB_PLATFORM_GCC
+  #ifndef PROGMEM
+    #define PROGMEM
+  #endif
+  #ifndef pgm_read_byte
+    #define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+  #endif
+#endif
+
+/**
+ * @brief Device generation of a board (same order as MirlibBase::Generation)
+ */
+enum BoardGeneration : uint8_t {
+    BOARD_GENERATION_UNKNOWN = 0,
+    BOARD_GENERATION_OLD = 1,
+    BOARD_GENERATION_TRANSITION = 2,
+    BOARD_GENERATION_NEW = 3
+};
+
+/**
+ * @brief Capabilities shared by all boards of a generation
+ */
+struct BoardProfile {
+    BoardGeneration generation; ///< Generation
+    uint8_t commands; ///< Supported commands (BoardCapabilities::commandBit)
+    uint8_t minRole; ///< Role threshold, boards with a lower role are treated as unknown
+    uint8_t referenceBoardId; ///< Board ID assumed when only the generation is known
+    uint8_t statusSize; ///< Smallest ReadStatus response
+    uint8_t statusSizeMax; ///< Largest ReadStatus response
+    uint8_t instantSize; ///< ReadInstantValue (group 0x00) response size, 0 if not supported
+    uint8_t instantSize100A; ///< ReadInstantValue response size with 100A support
+    uint8_t infoSize; ///< Smallest GetInfo response
+    uint8_t infoSizeMax; ///< Largest GetInfo response (with battery voltage)
+    uint8_t currentWidth100A; ///< Width of phase currents with 100A support, bytes (0 - no 100A form)
+    const char *name; ///< Generation name ("Old", "Transition", "New", "Unknown")
+};
+
+/**
+ * @brief Board capability lookup
+ *
+ * Board ID -> generation is a 256-byte table (PROGMEM on AVR) generated at
+ * compile time from the board list in BoardCapabilities.cpp; the generation
+ * then selects a BoardProfile row. Adding a board is one row in that list.
+ */
+class BoardCapabilities {
+public:
+    static const uint8_t ROLE_THRESHOLD = 0x32; ///< Minimum role of transition/new generation boards
+
+    /**
+     * @brief Bit of a command in BoardProfile::commands (0 for unknown commands)
+     */
+    static constexpr uint8_t commandBit(uint8_t command) {
+        return command == CMD_PING ? 0x01
+             : command == CMD_READ_STATUS ? 0x02
+             : command == CMD_READ_DATE_TIME ? 0x04
+             : command == CMD_READ_INSTANT_VALUE ? 0x08
+             : command == CMD_GET_INFO ? 0x10
+             : 0x00;
+    }
+
+    /**
+     * @brief Generation of a board, ignoring the role
+     */
+    static BoardGeneration boardGeneration(uint8_t boardId) {
+        return static_cast<BoardGeneration>(pgm_read_byte(&GENERATIONS[boardId]));
+    }
+
+    /**
+     * @brief Generation of a board with the given role
+     * @return BOARD_GENERATION_UNKNOWN if the role is below the generation threshold
+     */
+    static BoardGeneration generation(uint8_t boardId, uint8_t role) {
+        BoardGeneration const result = boardGeneration(boardId);
+        return role >= PROFILES[result].minRole ? result : BOARD_GENERATION_UNKNOWN;
+    }
+
+    /**
+     * @brief Profile of a generation
+     */
+    static const BoardProfile &profile(BoardGeneration generation) {
+        return PROFILES[generation];
+    }
+
+    /**
+     * @brief Profile of a board with the given role
+     */
+    static const BoardProfile &profile(uint8_t boardId, uint8_t role) {
+        return PROFILES[generation(boardId, role)];
+    }
+
+    /**
+     * @brief Check if a board supports a command
+     */
+    static bool supportsCommand(uint8_t boardId, uint8_t role, uint8_t command) {
+        return (profile(boardId, role).commands & commandBit(command)) != 0;
+    }
+
+    /**
+     * @brief Fill GenerationInfo for a generation
+     */
+    static GenerationInfo generationInfo(BoardGeneration generation, uint8_t boardId, uint8_t role) {
+        GenerationInfo info = {};
+        info.boardId = boardId;
+        info.role = role;
+        info.isOldGeneration = generation == BOARD_GENERATION_OLD;
+        info.isTransitionGeneration = generation == BOARD_GENERATION_TRANSITION;
+        info.isNewGeneration = generation == BOARD_GENERATION_NEW;
+        return info;
+    }
+
+    static const uint8_t GENERATIONS[256]; ///< Board ID -> BoardGeneration (PROGMEM on AVR)
+    static const BoardProfile PROFILES[4]; ///< Indexed by BoardGeneration
+};
+
+#endif // BOARD_CAPABILITIES_H
@@ -3,6 +3,7 @@
 
 #include <Arduino.h>
 #include "../ProtocolTypes.h"
+#include "../BoardCapabilities.h"
 
 /**
  * @brief Base class for all protocol commands
@@ -3,6 +3,7 @@
 
 #include "BaseCommand.h"
 #include "../ProtocolUtils.h"
+#include "../FieldSchema.h"
 
 /**
  * @brief GetInfo command request structure (empty)
@@ -34,6 +35,41 @@ struct GetInfoResponseBase {
     uint8_t interface4Type; ///< Interface 4 type (new generation only)
     uint16_t batteryVoltage; ///< Battery voltage (new generation only)
 
+    typedef GetInfoResponseBase Self;
+
+    /**
+     * @brief Wire layout: common fields, new generation interfaces, battery voltage
+     */
+    typedef FieldSchema<
+        Field<Self, uint8_t, &Self::boardId, 1>,
+        Field<Self, uint16_t, &Self::firmwareVersion, 2>,
+        Field<Self, uint16_t, &Self::firmwareCRC, 2>,
+        Field<Self, uint32_t, &Self::workTime, 4>,
+        Field<Self, uint32_t, &Self::sleepTime, 4>,
+        Field<Self, uint8_t, &Self::groupId, 1>,
+        Field<Self, uint8_t, &Self::flags, 1>,
+        Field<Self, uint16_t, &Self::activeTariffCRC, 2>,
+        Field<Self, uint16_t, &Self::plannedTariffCRC, 2>,
+        Field<Self, uint32_t, &Self::timeSinceCorrection, 4>,
+        Field<Self, uint16_t, &Self::reserve, 2>,
+        Field<Self, uint8_t, &Self::interface1Type, 1>,
+        Field<Self, uint8_t, &Self::interface2Type, 1>
+    > CommonSchema;
+
+    typedef FieldSchema<
+        Field<Self, uint8_t, &Self::interface3Type, 1>,
+        Field<Self, uint8_t, &Self::interface4Type, 1>
+    > InterfacesSchema;
+
+    typedef FieldSchema<
+        Field<Self, uint16_t, &Self::batteryVoltage, 2>
+    > BatterySchema;
+
+    static const size_t SIZE = CommonSchema::SIZE; ///< Old/transition response size (27 bytes)
+    static const size_t SIZE_SHORT = SIZE + 1; ///< New generation short form, third interface only (28 bytes)
+    static const size_t SIZE_NEW = SIZE + InterfacesSchema::SIZE; ///< New generation response size (29 bytes)
+    static const size_t SIZE_BATTERY = SIZE_NEW + BatterySchema::SIZE; ///< New generation with battery voltage (31 bytes)
+
     /**
      * @brief Parse common fields from byte array
      * @param data Data array
@@ -42,70 +78,24 @@ struct GetInfoResponseBase {
      * @return true if parsing successful
      */
     bool fromBytes(const uint8_t *data, size_t size, bool isNewGeneration) {
-        if (size < 27) return false;
-
-        size_t index = 0;
-
-        // Board ID
-        boardId = data[index++];
-
-        // Firmware version
-        firmwareVersion = ProtocolUtils::bytesToUint16(&data[index]);
-        index += 2;
-
-        // Firmware CRC
-        firmwareCRC = ProtocolUtils::bytesToUint16(&data[index]);
-        index += 2;
+        if (size < SIZE) return false;
 
-        // Work time
-        workTime = ProtocolUtils::bytesToUint32(&data[index]);
-        index += 4;
+        CommonSchema::decode(*this, data);
 
-        // Sleep time
-        sleepTime = ProtocolUtils::bytesToUint32(&data[index]);
-        index += 4;
-
-        // Group ID
-        groupId = data[index++];
-
-        // Flags
-        flags = data[index++];
-
-        // Active tariff CRC
-        activeTariffCRC = ProtocolUtils::bytesToUint16(&data[index]);
-        index += 2;
-
-        // Planned tariff CRC
-        plannedTariffCRC = ProtocolUtils::bytesToUint16(&data[index]);
-        index += 2;
-
-        // Time since correction
-        timeSinceCorrection = ProtocolUtils::bytesToUint32(&data[index]);
-        index += 4;
-
-        // Reserve
-        reserve = ProtocolUtils::bytesToUint16(&data[index]);
-        index += 2;
-
-        // Interface types
-        interface1Type = data[index++];
-        interface2Type = data[index++];
+        interface3Type = 0;
+        interface4Type = 0;
+        batteryVoltage = 0;
 
         // New generation additional fields
-        if (isNewGeneration && size >= 28) {
-            interface3Type = data[index++];
-            interface4Type = data[index++];
-
-            if (size >= 31) {
-                batteryVoltage = ProtocolUtils::bytesToUint16(&data[index]);
-                index += 2;
-            } else {
-                batteryVoltage = 0;
+        if (isNewGeneration && size >= SIZE_NEW) {
+            InterfacesSchema::decode(*this, data + SIZE);
+
+            if (size >= SIZE_BATTERY) {
+                BatterySchema::decode(*this, data + SIZE_NEW);
             }
-        } else {
-            interface3Type = 0;
-            interface4Type = 0;
-            batteryVoltage = 0;
+        } else if (isNewGeneration && size >= SIZE_SHORT) {
+            // Short 28-byte form: only the third interface is present
+            interface3Type = data[SIZE];
         }
 
         return true;
@@ -119,65 +109,20 @@ struct GetInfoResponseBase {
      * @return Number of bytes written
      */
     size_t toBytes(uint8_t *data, bool isNewGeneration, bool includeBattery = false) const {
-        size_t index = 0;
-
-        // Board ID
-        data[index++] = boardId;
-
-        // Firmware version
-        ProtocolUtils::uint16ToBytes(firmwareVersion, &data[index]);
-        index += 2;
-
-        // Firmware CRC
-        ProtocolUtils::uint16ToBytes(firmwareCRC, &data[index]);
-        index += 2;
-
-        // Work time
-        ProtocolUtils::uint32ToBytes(workTime, &data[index]);
-        index += 4;
-
-        // Sleep time
-        ProtocolUtils::uint32ToBytes(sleepTime, &data[index]);
-        index += 4;
-
-        // Group ID
-        data[index++] = groupId;
-
-        // Flags
-        data[index++] = flags;
+        CommonSchema::encode(*this, data);
 
-        // Active tariff CRC
-        ProtocolUtils::uint16ToBytes(activeTariffCRC, &data[index]);
-        index += 2;
-
-        // Planned tariff CRC
-        ProtocolUtils::uint16ToBytes(plannedTariffCRC, &data[index]);
-        index += 2;
-
-        // Time since correction
-        ProtocolUtils::uint32ToBytes(timeSinceCorrection, &data[index]);
-        index += 4;
-
-        // Reserve
-        ProtocolUtils::uint16ToBytes(reserve, &data[index]);
-        index += 2;
-
-        // Interface types
-        data[index++] = interface1Type;
-        data[index++] = interface2Type;
+        if (!isNewGeneration) {
+            return SIZE;
+        }
 
-        // New generation additional fields
-        if (isNewGeneration) {
-            data[index++] = interface3Type;
-            data[index++] = interface4Type;
+        InterfacesSchema::encode(*this, data + SIZE);
 
-            if (includeBattery) {
-                ProtocolUtils::uint16ToBytes(batteryVoltage, &data[index]);
-                index += 2;
-            }
+        if (!includeBattery) {
+            return SIZE_NEW;
         }
 
-        return index;
+        BatterySchema::encode(*this, data + SIZE_NEW);
+        return SIZE_BATTERY;
     }
 
     /**
@@ -234,7 +179,9 @@ public:
     /**
      * @brief Constructor
      */
-    GetInfoCommand() : TypedCommand(CMD_GET_INFO), m_generation(0), m_isNewGeneration(false) {
+    GetInfoCommand()
+        : TypedCommand(CMD_GET_INFO), m_generation(0), m_boardGeneration(BOARD_GENERATION_UNKNOWN),
+          m_isNewGeneration(false) {
     }
 
     /**
@@ -246,6 +193,7 @@ public:
         GenerationInfo const info = ProtocolUtils::determineGeneration(boardId, role);
         m_isNewGeneration = info.isNewGeneration;
         m_generation = boardId;
+        m_boardGeneration = BoardCapabilities::generation(boardId, role);
     }
 
     /**
@@ -268,11 +216,7 @@ public:
     bool parseResponse(const uint8_t *responseData, size_t dataSize) override {
         // Try to auto-detect generation from response size if not set
         if (m_generation == 0) {
-            if (dataSize >= 28) {
-                m_isNewGeneration = true;
-            } else {
-                m_isNewGeneration = false;
-            }
+            m_isNewGeneration = dataSize > BoardCapabilities::profile(BOARD_GENERATION_OLD).infoSizeMax;
         }
 
         return m_response.fromBytes(responseData, dataSize, m_isNewGeneration);
@@ -289,7 +233,10 @@ public:
     size_t handleRequest(const uint8_t *requestData, size_t dataSize,
                          uint8_t *responseData, size_t maxResponseSize) override {
         // Determine response size based on generation
-        size_t requiredSize = m_isNewGeneration ? (m_response.batteryVoltage != 0 ? 31 : 28) : 27;
+        size_t requiredSize = m_isNewGeneration
+                                  ? (m_response.batteryVoltage != 0 ? GetInfoResponseBase::SIZE_BATTERY
+                                                                    : GetInfoResponseBase::SIZE_NEW)
+                                  : GetInfoResponseBase::SIZE;
 
         if (maxResponseSize < requiredSize) {
             return 0;
@@ -311,10 +258,10 @@ public:
      * @brief Check if command is valid for device generation
      * @param boardId Board ID
      * @param role Role value
-     * @return true (GetInfo is supported by all generations)
+     * @return true if the board profile lists GetInfo
      */
     bool isValidForGeneration(uint8_t boardId, uint8_t role) const override {
-        return true; // Supported by all generations
+        return BoardCapabilities::supportsCommand(boardId, role, CMD_GET_INFO);
     }
 
     /**
@@ -326,13 +273,14 @@ public:
     }
 
     /**
-     * @brief Get expected response size range
-     * @param minSize Minimum response size (27 bytes)
-     * @param maxSize Maximum response size (31 bytes)
+     * @brief Get expected response size range (from the board profile)
+     * @param minSize Minimum response size (27 bytes until the generation is known)
+     * @param maxSize Maximum response size (31 bytes until the generation is known)
      */
     void getResponseSizeRange(size_t &minSize, size_t &maxSize) const override {
-        minSize = 27;
-        maxSize = 31;
+        const BoardProfile &profile = BoardCapabilities::profile(m_boardGeneration);
+        minSize = profile.infoSize;
+        maxSize = profile.infoSizeMax;
     }
 
     /**
@@ -357,7 +305,7 @@ public:
      */
     GenerationInfo getGenerationInfo() const {
         // For GetInfo, we don't have role, so we determine by board ID only
-        return ProtocolUtils::determineGeneration(m_response.boardId, 0x32);
+        return ProtocolUtils::determineGeneration(m_response.boardId, BoardCapabilities::ROLE_THRESHOLD);
     }
 
     /**
@@ -384,8 +332,9 @@ public:
         m_response = response;
 
         // Auto-detect generation from board ID
-        GenerationInfo info = ProtocolUtils::determineGeneration(response.boardId, 0x32);
+        GenerationInfo info = ProtocolUtils::determineGeneration(response.boardId, BoardCapabilities::ROLE_THRESHOLD);
         m_isNewGeneration = info.isNewGeneration;
+        m_boardGeneration = BoardCapabilities::generation(response.boardId, BoardCapabilities::ROLE_THRESHOLD);
     }
 
     /**
@@ -398,6 +347,7 @@ public:
 
 private:
     uint8_t m_generation;
+    BoardGeneration m_boardGeneration;
     bool m_isNewGeneration;
 };
 
@@ -3,6 +3,7 @@
 
 #include "BaseCommand.h"
 #include "../ProtocolUtils.h"
+#include "../FieldSchema.h"
 
 /**
  * @brief Ping command request structure (empty)
@@ -18,19 +19,25 @@ struct PingResponse {
     uint16_t firmwareVersion; ///< Firmware version (2 bytes)
     uint16_t deviceAddress; ///< Device address (2 bytes)
 
+    typedef PingResponse Self;
+
+    /**
+     * @brief Wire layout
+     */
+    typedef FieldSchema<
+        Field<Self, uint16_t, &Self::firmwareVersion, 2>,
+        Field<Self, uint16_t, &Self::deviceAddress, 2>
+    > Schema;
+
+    static const size_t SIZE = Schema::SIZE; ///< Response size (4 bytes)
+
     /**
      * @brief Parse from byte array
      * @param data Data array (4 bytes)
      * @return true if parsing successful
      */
     bool fromBytes(const uint8_t *data, size_t size) {
-        if (size < 4) {
-            return false;
-        }
-
-        firmwareVersion = ProtocolUtils::bytesToUint16(&data[0]);
-        deviceAddress = ProtocolUtils::bytesToUint16(&data[2]);
-        return true;
+        return Schema::fromBytes(*this, data, size);
     }
 
     /**
@@ -39,9 +46,7 @@ struct PingResponse {
      * @return Number of bytes written
      */
     size_t toBytes(uint8_t *data) const {
-        ProtocolUtils::uint16ToBytes(firmwareVersion, &data[0]);
-        ProtocolUtils::uint16ToBytes(deviceAddress, &data[2]);
-        return 4;
+        return Schema::toBytes(*this, data);
     }
 };
 
@@ -90,7 +95,7 @@ public:
      */
     size_t handleRequest(const uint8_t *requestData, size_t dataSize,
                          uint8_t *responseData, size_t maxResponseSize) override {
-        if (maxResponseSize < 4) {
+        if (maxResponseSize < PingResponse::SIZE) {
             return 0;
         }
 
@@ -115,7 +120,7 @@ public:
      */
     bool isValidForGeneration(uint8_t boardId, uint8_t role) const override {
         // Ping is supported by all generations
-        return true;
+        return BoardCapabilities::supportsCommand(boardId, role, CMD_PING);
     }
 
     /**
@@ -132,8 +137,8 @@ public:
      * @param maxSize Maximum response size (4 bytes)
      */
     void getResponseSizeRange(size_t &minSize, size_t &maxSize) const override {
-        minSize = 4;
-        maxSize = 4;
+        minSize = PingResponse::SIZE;
+        maxSize = PingResponse::SIZE;
     }
 
     /**
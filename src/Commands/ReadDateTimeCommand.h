@@ -3,6 +3,7 @@
 
 #include "BaseCommand.h"
 #include "../ProtocolUtils.h"
+#include "../FieldSchema.h"
 
 /**
  * @brief ReadDateTime command request structure
@@ -37,6 +38,23 @@ struct ReadDateTimeResponse {
     uint8_t month; ///< Месяц (1-12)
     uint8_t year; ///< Год (последние 2 цифры, например 24 для 2024)
 
+    typedef ReadDateTimeResponse Self;
+
+    /**
+     * @brief Wire layout
+     */
+    typedef FieldSchema<
+        Field<Self, uint8_t, &Self::seconds, 1>,
+        Field<Self, uint8_t, &Self::minutes, 1>,
+        Field<Self, uint8_t, &Self::hours, 1>,
+        Field<Self, uint8_t, &Self::dayOfWeek, 1>,
+        Field<Self, uint8_t, &Self::day, 1>,
+        Field<Self, uint8_t, &Self::month, 1>,
+        Field<Self, uint8_t, &Self::year, 1>
+    > Schema;
+
+    static const size_t SIZE = Schema::SIZE; ///< Response size (7 байт)
+
     /**
      * @brief Parse from byte array (7 байт)
      * @param data Data array
@@ -44,16 +62,9 @@ struct ReadDateTimeResponse {
      * @return true if parsing successful
      */
     bool fromBytes(const uint8_t *data, size_t size) {
-        if (size != 7) return false;
-
-        seconds = data[0];
-        minutes = data[1];
-        hours = data[2];
-        dayOfWeek = data[3];
-        day = data[4];
-        month = data[5];
-        year = data[6];
+        if (size != SIZE) return false;
 
+        Schema::decode(*this, data);
         return true;
     }
 
@@ -63,15 +74,7 @@ struct ReadDateTimeResponse {
      * @return Number of bytes written (always 7)
      */
     size_t toBytes(uint8_t *data) const {
-        data[0] = seconds;
-        data[1] = minutes;
-        data[2] = hours;
-        data[3] = dayOfWeek;
-        data[4] = day;
-        data[5] = month;
-        data[6] = year;
-
-        return 7;
+        return Schema::toBytes(*this, data);
     }
 
     /**
@@ -166,7 +169,7 @@ public:
         }
 
         // Проверяем что есть место для ответа
-        if (maxResponseSize < 7) {
+        if (maxResponseSize < ReadDateTimeResponse::SIZE) {
             return 0;
         }
 
@@ -190,7 +193,7 @@ public:
      */
     bool isValidForGeneration(uint8_t boardId, uint8_t role) const override {
         // Поддерживается всеми поколениями!
-        return true;
+        return BoardCapabilities::supportsCommand(boardId, role, CMD_READ_DATE_TIME);
     }
 
     /**
@@ -207,8 +210,8 @@ public:
      * @param maxSize Maximum response size (7 bytes)
      */
     void getResponseSizeRange(size_t &minSize, size_t &maxSize) const override {
-        minSize = 7;
-        maxSize = 7;
+        minSize = ReadDateTimeResponse::SIZE;
+        maxSize = ReadDateTimeResponse::SIZE;
     }
 
     /**
@@ -3,6 +3,7 @@
 
 #include "BaseCommand.h"
 #include "../ProtocolUtils.h"
+#include "../FieldSchema.h"
 
 /**
  * @brief Parameter groups for ReadInstantValue
@@ -69,6 +70,38 @@ struct ReadInstantValueResponseTransition {
     uint32_t currentC; ///< Current phase C (2 or 3 bytes, divide by 1000 for A)
     bool is100ASupport; ///< True if 3-byte currents (100A support)
 
+    typedef ReadInstantValueResponseTransition Self;
+
+    static const size_t CURRENT_WIDTH = 2; ///< Width of phase currents, bytes
+    static const size_t CURRENT_WIDTH_100A = 3; ///< Width of phase currents with 100A support, bytes
+
+    /**
+     * @brief Wire layout: common part, then currents of 2 or 3 bytes
+     */
+    typedef FieldSchema<
+        Field<Self, ParameterGroup, &Self::group, 1>,
+        Field<Self, uint16_t, &Self::voltageTransformCoeff, 2>,
+        Field<Self, uint16_t, &Self::currentTransformCoeff, 2>,
+        Field<Self, uint16_t, &Self::activePower, 2>,
+        Field<Self, uint16_t, &Self::reactivePower, 2>,
+        Field<Self, uint16_t, &Self::frequency, 2>,
+        Field<Self, uint16_t, &Self::cosPhi, 2>,
+        Field<Self, uint16_t, &Self::voltageA, 2>,
+        Field<Self, uint16_t, &Self::voltageB, 2>,
+        Field<Self, uint16_t, &Self::voltageC, 2>
+    > CommonSchema;
+
+    template<size_t Width>
+    struct CurrentsSchema : FieldSchema<
+        Field<Self, uint32_t, &Self::currentA, Width>,
+        Field<Self, uint32_t, &Self::currentB, Width>,
+        Field<Self, uint32_t, &Self::currentC, Width>
+    > {
+    };
+
+    static const size_t SIZE = CommonSchema::SIZE + CurrentsSchema<CURRENT_WIDTH>::SIZE; ///< Response size (25 bytes)
+    static const size_t SIZE_100A = CommonSchema::SIZE + CurrentsSchema<CURRENT_WIDTH_100A>::SIZE; ///< Response size with 100A support (28 bytes)
+
     /**
      * @brief Parse from byte array
      * @param data Data array
@@ -76,52 +109,16 @@ struct ReadInstantValueResponseTransition {
      * @return true if parsing successful
      */
     bool fromBytes(const uint8_t *data, size_t size) {
-        if (size < 25) return false;
-
-        is100ASupport = (size == 28);
-        size_t index = 0;
-
-        group = static_cast<ParameterGroup>(data[index++]);
-        voltageTransformCoeff = ProtocolUtils::bytesToUint16(&data[index]);
-        index += 2;
-        currentTransformCoeff = ProtocolUtils::bytesToUint16(&data[index]);
-        index += 2;
-        activePower = ProtocolUtils::bytesToUint16(&data[index]);
-        index += 2;
-        reactivePower = ProtocolUtils::bytesToUint16(&data[index]);
-        index += 2;
-        frequency = ProtocolUtils::bytesToUint16(&data[index]);
-        index += 2;
-        cosPhi = ProtocolUtils::bytesToUint16(&data[index]);
-        index += 2;
-        voltageA = ProtocolUtils::bytesToUint16(&data[index]);
-        index += 2;
-        voltageB = ProtocolUtils::bytesToUint16(&data[index]);
-        index += 2;
-        voltageC = ProtocolUtils::bytesToUint16(&data[index]);
-        index += 2;
+        const BoardProfile &profile = BoardCapabilities::profile(BOARD_GENERATION_TRANSITION);
+        if (size < profile.instantSize) return false;
+
+        is100ASupport = profile.currentWidth100A != 0 && size == profile.instantSize100A;
+        CommonSchema::decode(*this, data);
 
         if (is100ASupport) {
-            // 3-byte currents for 100A support
-            // FIXED: explicit cast to uint32_t to avoid shift overflow warning
-            currentA = (uint32_t)data[index] |
-                      ((uint32_t)data[index + 1] << 8) |
-                      ((uint32_t)data[index + 2] << 16);
-            index += 3;
-            currentB = (uint32_t)data[index] |
-                      ((uint32_t)data[index + 1] << 8) |
-                      ((uint32_t)data[index + 2] << 16);
-            index += 3;
-            currentC = (uint32_t)data[index] |
-                      ((uint32_t)data[index + 1] << 8) |
-                      ((uint32_t)data[index + 2] << 16);
+            CurrentsSchema<CURRENT_WIDTH_100A>::decode(*this, data + CommonSchema::SIZE);
         } else {
-            // 2-byte currents
-            currentA = ProtocolUtils::bytesToUint16(&data[index]);
-            index += 2;
-            currentB = ProtocolUtils::bytesToUint16(&data[index]);
-            index += 2;
-            currentC = ProtocolUtils::bytesToUint16(&data[index]);
+            CurrentsSchema<CURRENT_WIDTH>::decode(*this, data + CommonSchema::SIZE);
         }
 
         return true;
@@ -133,50 +130,15 @@ struct ReadInstantValueResponseTransition {
      * @return Number of bytes written
      */
     size_t toBytes(uint8_t *data) const {
-        size_t index = 0;
-
-        data[index++] = static_cast<uint8_t>(group);
-        ProtocolUtils::uint16ToBytes(voltageTransformCoeff, &data[index]);
-        index += 2;
-        ProtocolUtils::uint16ToBytes(currentTransformCoeff, &data[index]);
-        index += 2;
-        ProtocolUtils::uint16ToBytes(activePower, &data[index]);
-        index += 2;
-        ProtocolUtils::uint16ToBytes(reactivePower, &data[index]);
-        index += 2;
-        ProtocolUtils::uint16ToBytes(frequency, &data[index]);
-        index += 2;
-        ProtocolUtils::uint16ToBytes(cosPhi, &data[index]);
-        index += 2;
-        ProtocolUtils::uint16ToBytes(voltageA, &data[index]);
-        index += 2;
-        ProtocolUtils::uint16ToBytes(voltageB, &data[index]);
-        index += 2;
-        ProtocolUtils::uint16ToBytes(voltageC, &data[index]);
-        index += 2;
+        CommonSchema::encode(*this, data);
 
         if (is100ASupport) {
-            // 3-byte currents
-            data[index++] = currentA & 0xFF;
-            data[index++] = (currentA >> 8) & 0xFF;
-            data[index++] = (currentA >> 16) & 0xFF;
-            data[index++] = currentB & 0xFF;
-            data[index++] = (currentB >> 8) & 0xFF;
-            data[index++] = (currentB >> 16) & 0xFF;
-            data[index++] = currentC & 0xFF;
-            data[index++] = (currentC >> 8) & 0xFF;
-            data[index++] = (currentC >> 16) & 0xFF;
-        } else {
-            // 2-byte currents
-            ProtocolUtils::uint16ToBytes(currentA, &data[index]);
-            index += 2;
-            ProtocolUtils::uint16ToBytes(currentB, &data[index]);
-            index += 2;
-            ProtocolUtils::uint16ToBytes(currentC, &data[index]);
-            index += 2;
+            CurrentsSchema<CURRENT_WIDTH_100A>::encode(*this, data + CommonSchema::SIZE);
+            return SIZE_100A;
         }
 
-        return index;
+        CurrentsSchema<CURRENT_WIDTH>::encode(*this, data + CommonSchema::SIZE);
+        return SIZE;
     }
 
     /**
@@ -232,6 +194,31 @@ struct ReadInstantValueResponseNewBasic {
     uint32_t currentB; ///< Current phase B (divide by 1000 for A)
     uint32_t currentC; ///< Current phase C (divide by 1000 for A)
 
+    typedef ReadInstantValueResponseNewBasic Self;
+
+    static const size_t CURRENT_WIDTH = 3; ///< Width of phase currents, bytes
+
+    /**
+     * @brief Wire layout
+     */
+    typedef FieldSchema<
+        Field<Self, ParameterGroup, &Self::group, 1>,
+        Field<Self, uint16_t, &Self::voltageTransformCoeff, 2>,
+        Field<Self, uint16_t, &Self::currentTransformCoeff, 2>,
+        Field<Self, uint32_t, &Self::activePower, 3>,
+        Field<Self, uint32_t, &Self::reactivePower, 3>,
+        Field<Self, uint16_t, &Self::frequency, 2>,
+        Field<Self, uint16_t, &Self::cosPhi, 2>,
+        Field<Self, uint16_t, &Self::voltageA, 2>,
+        Field<Self, uint16_t, &Self::voltageB, 2>,
+        Field<Self, uint16_t, &Self::voltageC, 2>,
+        Field<Self, uint32_t, &Self::currentA, CURRENT_WIDTH>,
+        Field<Self, uint32_t, &Self::currentB, CURRENT_WIDTH>,
+        Field<Self, uint32_t, &Self::currentC, CURRENT_WIDTH>
+    > Schema;
+
+    static const size_t SIZE = Schema::SIZE; ///< Response size (30 bytes)
+
     /**
      * @brief Parse from byte array
      * @param data Data array (30 bytes)
@@ -239,54 +226,7 @@ struct ReadInstantValueResponseNewBasic {
      * @return true if parsing successful
      */
     bool fromBytes(const uint8_t *data, size_t size) {
-        if (size < 30) return false;
-
-        size_t index = 0;
-
-        group = static_cast<ParameterGroup>(data[index++]);
-        voltageTransformCoeff = ProtocolUtils::bytesToUint16(&data[index]);
-        index += 2;
-        currentTransformCoeff = ProtocolUtils::bytesToUint16(&data[index]);
-        index += 2;
-
-        // 3-byte values for power
-        // FIXED: explicit cast to uint32_t to avoid shift overflow warning
-        activePower = (uint32_t)data[index] |
-                     ((uint32_t)data[index + 1] << 8) |
-                     ((uint32_t)data[index + 2] << 16);
-        index += 3;
-        reactivePower = (uint32_t)data[index] |
-                       ((uint32_t)data[index + 1] << 8) |
-                       ((uint32_t)data[index + 2] << 16);
-        index += 3;
-
-        frequency = ProtocolUtils::bytesToUint16(&data[index]);
-        index += 2;
-        cosPhi = ProtocolUtils::bytesToUint16(&data[index]);
-        index += 2;
-        voltageA = ProtocolUtils::bytesToUint16(&data[index]);
-        index += 2;
-        voltageB = ProtocolUtils::bytesToUint16(&data[index]);
-        index += 2;
-        voltageC = ProtocolUtils::bytesToUint16(&data[index]);
-        index += 2;
-
-        // 3-byte currents
-        // FIXED: explicit cast to uint32_t to avoid shift overflow warning
-        currentA = (uint32_t)data[index] |
-                  ((uint32_t)data[index + 1] << 8) |
-                  ((uint32_t)data[index + 2] << 16);
-        index += 3;
-        currentB = (uint32_t)data[index] |
-                  ((uint32_t)data[index + 1] << 8) |
-                  ((uint32_t)data[index + 2] << 16);
-        index += 3;
-        currentC = (uint32_t)data[index] |
-                  ((uint32_t)data[index + 1] << 8) |
-                  ((uint32_t)data[index + 2] << 16);
-        index += 3;
-
-        return true;
+        return Schema::fromBytes(*this, data, size);
     }
 
     /**
@@ -295,45 +235,7 @@ struct ReadInstantValueResponseNewBasic {
      * @return Number of bytes written (30)
      */
     size_t toBytes(uint8_t *data) const {
-        size_t index = 0;
-
-        data[index++] = static_cast<uint8_t>(group);
-        ProtocolUtils::uint16ToBytes(voltageTransformCoeff, &data[index]);
-        index += 2;
-        ProtocolUtils::uint16ToBytes(currentTransformCoeff, &data[index]);
-        index += 2;
-
-        // 3-byte power values
-        data[index++] = activePower & 0xFF;
-        data[index++] = (activePower >> 8) & 0xFF;
-        data[index++] = (activePower >> 16) & 0xFF;
-        data[index++] = reactivePower & 0xFF;
-        data[index++] = (reactivePower >> 8) & 0xFF;
-        data[index++] = (reactivePower >> 16) & 0xFF;
-
-        ProtocolUtils::uint16ToBytes(frequency, &data[index]);
-        index += 2;
-        ProtocolUtils::uint16ToBytes(cosPhi, &data[index]);
-        index += 2;
-        ProtocolUtils::uint16ToBytes(voltageA, &data[index]);
-        index += 2;
-        ProtocolUtils::uint16ToBytes(voltageB, &data[index]);
-        index += 2;
-        ProtocolUtils::uint16ToBytes(voltageC, &data[index]);
-        index += 2;
-
-        // 3-byte currents
-        data[index++] = currentA & 0xFF;
-        data[index++] = (currentA >> 8) & 0xFF;
-        data[index++] = (currentA >> 16) & 0xFF;
-        data[index++] = currentB & 0xFF;
-        data[index++] = (currentB >> 8) & 0xFF;
-        data[index++] = (currentB >> 16) & 0xFF;
-        data[index++] = currentC & 0xFF;
-        data[index++] = (currentC >> 8) & 0xFF;
-        data[index++] = (currentC >> 16) & 0xFF;
-
-        return 30;
+        return Schema::toBytes(*this, data);
     }
 
     /**
@@ -375,6 +277,47 @@ struct ReadInstantValueResponseNewBasic {
     float getReactivePowerKvar() const { return reactivePower / 1000.0f; }
 };
 
+/**
+ * @brief Lazy view over a new generation ReadInstantValue (group 0x00) response (decodes fields on access)
+ */
+class InstantValueNewView : public ResponseView<ReadInstantValueResponseNewBasic> {
+public:
+    typedef ReadInstantValueResponseNewBasic Response;
+
+    ParameterGroup group() const { return get<ParameterGroup, &Response::group>(); }
+    uint16_t voltageTransformCoeff() const { return get<uint16_t, &Response::voltageTransformCoeff>(); }
+    uint16_t currentTransformCoeff() const { return get<uint16_t, &Response::currentTransformCoeff>(); }
+    uint32_t activePower() const { return get<uint32_t, &Response::activePower>(); }
+    uint32_t reactivePower() const { return get<uint32_t, &Response::reactivePower>(); }
+    uint16_t frequency() const { return get<uint16_t, &Response::frequency>(); }
+    uint16_t cosPhi() const { return get<uint16_t, &Response::cosPhi>(); }
+    uint16_t voltageA() const { return get<uint16_t, &Response::voltageA>(); }
+    uint16_t voltageB() const { return get<uint16_t, &Response::voltageB>(); }
+    uint16_t voltageC() const { return get<uint16_t, &Response::voltageC>(); }
+    uint32_t currentA() const { return get<uint32_t, &Response::currentA>(); }
+    uint32_t currentB() const { return get<uint32_t, &Response::currentB>(); }
+    uint32_t currentC() const { return get<uint32_t, &Response::currentC>(); }
+
+    /**
+     * @brief Get voltage values in volts
+     */
+    float getVoltageA() const { return voltageA() / 100.0f; }
+    float getVoltageB() const { return voltageB() / 100.0f; }
+    float getVoltageC() const { return voltageC() / 100.0f; }
+
+    /**
+     * @brief Get current values in amperes
+     */
+    float getCurrentA() const { return currentA() / 1000.0f; }
+    float getCurrentB() const { return currentB() / 1000.0f; }
+    float getCurrentC() const { return currentC() / 1000.0f; }
+
+    /**
+     * @brief Get frequency in Hz
+     */
+    float getFrequencyHz() const { return frequency() / 100.0f; }
+};
+
 /**
  * @brief ReadInstantValue command implementation
  */
@@ -383,7 +326,9 @@ public:
     /**
      * @brief Constructor
      */
-    ReadInstantValueCommand() : BaseCommand(CMD_READ_INSTANT_VALUE), m_generation(0), m_isOldGeneration(true) {
+    ReadInstantValueCommand()
+        : BaseCommand(CMD_READ_INSTANT_VALUE), m_generation(0), m_boardGeneration(BOARD_GENERATION_OLD),
+          m_isOldGeneration(true) {
     }
 
     /**
@@ -397,6 +342,7 @@ public:
         m_isTransitionGeneration = info.isTransitionGeneration;
         m_isNewGeneration = info.isNewGeneration;
         m_generation = boardId;
+        m_boardGeneration = BoardCapabilities::generation(boardId, role);
     }
 
     /**
@@ -453,10 +399,13 @@ public:
         }
 
         if (m_isTransitionGeneration) {
-            if (maxResponseSize < 25) return 0;
+            const BoardProfile &profile = BoardCapabilities::profile(m_boardGeneration);
+            size_t const requiredSize = m_responseTransition.is100ASupport ? profile.instantSize100A
+                                                                           : profile.instantSize;
+            if (maxResponseSize < requiredSize) return 0;
             return m_responseTransition.toBytes(responseData);
         } else if (m_isNewGeneration) {
-            if (maxResponseSize < 30) return 0;
+            if (maxResponseSize < ReadInstantValueResponseNewBasic::SIZE) return 0;
             return m_responseNewBasic.toBytes(responseData);
         }
 
@@ -474,8 +423,7 @@ public:
      * @brief Check if command is valid for device generation
      */
     bool isValidForGeneration(uint8_t boardId, uint8_t role) const override {
-        GenerationInfo info = ProtocolUtils::determineGeneration(boardId, role);
-        return !info.isOldGeneration; // Not supported by old generation
+        return BoardCapabilities::supportsCommand(boardId, role, CMD_READ_INSTANT_VALUE);
     }
 
     /**
@@ -486,19 +434,12 @@ public:
     }
 
     /**
-     * @brief Get expected response size range
+     * @brief Get expected response size range (from the board profile)
      */
     void getResponseSizeRange(size_t &minSize, size_t &maxSize) const override {
-        if (m_isOldGeneration) {
-            minSize = 0;
-            maxSize = 0;
-        } else if (m_isTransitionGeneration) {
-            minSize = 25;
-            maxSize = 28;
-        } else {
-            minSize = 30;
-            maxSize = 30;
-        }
+        const BoardProfile &profile = BoardCapabilities::profile(m_boardGeneration);
+        minSize = profile.instantSize;
+        maxSize = profile.instantSize100A;
     }
 
     /**
@@ -535,6 +476,7 @@ private:
     ReadInstantValueResponseTransition m_responseTransition;
     ReadInstantValueResponseNewBasic m_responseNewBasic;
     uint8_t m_generation;
+    BoardGeneration m_boardGeneration;
     bool m_isOldGeneration;
     bool m_isTransitionGeneration;
     bool m_isNewGeneration;
@@ -3,6 +3,7 @@
 
 #include "BaseCommand.h"
 #include "../ProtocolUtils.h"
+#include "../FieldSchema.h"
 
 /**
  * @brief Read Status command request structure
@@ -68,6 +69,22 @@ struct ReadStatusResponseOld {
     uint32_t multiplicationCoeff; ///< Multiplication coefficient (3 bytes, always = 1)
     uint32_t tariffValues[4]; ///< Tariff values (16 bytes)
 
+    typedef ReadStatusResponseOld Self;
+
+    /**
+     * @brief Wire layout
+     */
+    typedef FieldSchema<
+        Field<Self, uint32_t, &Self::totalEnergy, 4>,
+        Field<Self, ConfigByte, &Self::configByte, 1>,
+        Field<Self, uint8_t, &Self::divisionCoeff, 1>,
+        Field<Self, uint8_t, &Self::roleCode, 1>,
+        Field<Self, uint32_t, &Self::multiplicationCoeff, 3>,
+        Field<Self, uint32_t[4], &Self::tariffValues, 4>
+    > Schema;
+
+    static const size_t SIZE = Schema::SIZE; ///< Response size (26 bytes)
+
     /**
      * @brief Parse from byte array
      * @param data Data array (26 bytes)
@@ -75,37 +92,7 @@ struct ReadStatusResponseOld {
      * @return true if parsing successful
      */
     bool fromBytes(const uint8_t *data, size_t size) {
-        if (size < 26) return false;
-
-        size_t index = 0;
-
-        // Total energy (4 bytes)
-        totalEnergy = ProtocolUtils::bytesToUint32(&data[index]);
-        index += 4;
-
-        // Configuration byte
-        configByte.fromByte(data[index++]);
-
-        // Division coefficient
-        divisionCoeff = data[index++];
-
-        // Role code
-        roleCode = data[index++];
-
-        // Multiplication coefficient (3 bytes, but we store as uint32_t)
-        // FIXED: explicit cast to uint32_t to avoid shift overflow warning
-        multiplicationCoeff = (uint32_t)data[index] |
-                             ((uint32_t)data[index + 1] << 8) |
-                             ((uint32_t)data[index + 2] << 16);
-        index += 3;
-
-        // Tariff values (16 bytes = 4 x 4 bytes)
-        for (int i = 0; i < 4; i++) {
-            tariffValues[i] = ProtocolUtils::bytesToUint32(&data[index]);
-            index += 4;
-        }
-
-        return true;
+        return Schema::fromBytes(*this, data, size);
     }
 
     /**
@@ -114,34 +101,28 @@ struct ReadStatusResponseOld {
      * @return Number of bytes written
      */
     size_t toBytes(uint8_t *data) const {
-        size_t index = 0;
-
-        // Total energy (4 bytes)
-        ProtocolUtils::uint32ToBytes(totalEnergy, &data[index]);
-        index += 4;
-
-        // Configuration byte
-        data[index++] = configByte.toByte();
-
-        // Division coefficient
-        data[index++] = divisionCoeff;
-
-        // Role code
-        data[index++] = roleCode;
+        return Schema::toBytes(*this, data);
+    }
+};
 
-        // Multiplication coefficient (3 bytes)
-        data[index++] = multiplicationCoeff & 0xFF;
-        data[index++] = (multiplicationCoeff >> 8) & 0xFF;
-        data[index++] = (multiplicationCoeff >> 16) & 0xFF;
+/**
+ * @brief Lazy view over an old generation ReadStatus response (decodes fields on access)
+ */
+class ReadStatusOldView : public ResponseView<ReadStatusResponseOld> {
+public:
+    typedef ReadStatusResponseOld Response;
 
-        // Tariff values (16 bytes = 4 x 4 bytes)
-        for (int i = 0; i < 4; i++) {
-            ProtocolUtils::uint32ToBytes(tariffValues[i], &data[index]);
-            index += 4;
-        }
+    uint32_t totalEnergy() const { return get<uint32_t, &Response::totalEnergy>(); }
+    ConfigByte configByte() const { return get<ConfigByte, &Response::configByte>(); }
+    uint8_t divisionCoeff() const { return get<uint8_t, &Response::divisionCoeff>(); }
+    uint8_t roleCode() const { return get<uint8_t, &Response::roleCode>(); }
+    uint32_t multiplicationCoeff() const { return get<uint32_t, &Response::multiplicationCoeff>(); }
 
-        return 26;
-    }
+    /**
+     * @brief Tariff value
+     * @param index Tariff index (0-3)
+     */
+    uint32_t tariffValue(size_t index) const { return element<uint32_t, 4, &Response::tariffValues>(index); }
 };
 
 /**
@@ -156,6 +137,24 @@ struct ReadStatusResponseNew {
     uint32_t totalActive; ///< Total active sum (4 bytes)
     uint32_t tariffValues[4]; ///< Tariff values (16 bytes)
 
+    typedef ReadStatusResponseNew Self;
+
+    /**
+     * @brief Wire layout
+     */
+    typedef FieldSchema<
+        Field<Self, EnergyType, &Self::energyType, 1>,
+        Field<Self, ConfigByte, &Self::configByte, 1>,
+        Field<Self, uint16_t, &Self::voltageTransformCoeff, 2>,
+        Field<Self, uint16_t, &Self::currentTransformCoeff, 2>,
+        Field<Self, uint32_t, &Self::totalFull, 4>,
+        Field<Self, uint32_t, &Self::totalActive, 4>,
+        Field<Self, uint32_t[4], &Self::tariffValues, 4>
+    > Schema;
+
+    static const size_t SIZE = Schema::SIZE; ///< Response size (30 bytes)
+    static const size_t SIZE_EXTENDED = SIZE + 1; ///< New generation may append one more byte (31 bytes)
+
     /**
      * @brief Parse from byte array
      * @param data Data array (30 or 31 bytes for new generation)
@@ -163,39 +162,7 @@ struct ReadStatusResponseNew {
      * @return true if parsing successful
      */
     bool fromBytes(const uint8_t *data, size_t size) {
-        if (size < 30) return false;
-
-        size_t index = 0;
-
-        // Energy type
-        energyType = static_cast<EnergyType>(data[index++]);
-
-        // Configuration byte
-        configByte.fromByte(data[index++]);
-
-        // Voltage transformation coefficient
-        voltageTransformCoeff = ProtocolUtils::bytesToUint16(&data[index]);
-        index += 2;
-
-        // Current transformation coefficient
-        currentTransformCoeff = ProtocolUtils::bytesToUint16(&data[index]);
-        index += 2;
-
-        // Total full sum
-        totalFull = ProtocolUtils::bytesToUint32(&data[index]);
-        index += 4;
-
-        // Total active sum
-        totalActive = ProtocolUtils::bytesToUint32(&data[index]);
-        index += 4;
-
-        // Tariff values (16 bytes = 4 x 4 bytes)
-        for (int i = 0; i < 4; i++) {
-            tariffValues[i] = ProtocolUtils::bytesToUint32(&data[index]);
-            index += 4;
-        }
-
-        return true;
+        return Schema::fromBytes(*this, data, size);
     }
 
     /**
@@ -204,38 +171,29 @@ struct ReadStatusResponseNew {
      * @return Number of bytes written
      */
     size_t toBytes(uint8_t *data) const {
-        size_t index = 0;
-
-        // Energy type
-        data[index++] = static_cast<uint8_t>(energyType);
-
-        // Configuration byte
-        data[index++] = configByte.toByte();
-
-        // Voltage transformation coefficient
-        ProtocolUtils::uint16ToBytes(voltageTransformCoeff, &data[index]);
-        index += 2;
-
-        // Current transformation coefficient
-        ProtocolUtils::uint16ToBytes(currentTransformCoeff, &data[index]);
-        index += 2;
-
-        // Total full sum
-        ProtocolUtils::uint32ToBytes(totalFull, &data[index]);
-        index += 4;
+        return Schema::toBytes(*this, data);
+    }
+};
 
-        // Total active sum
-        ProtocolUtils::uint32ToBytes(totalActive, &data[index]);
-        index += 4;
+/**
+ * @brief Lazy view over a transition/new generation ReadStatus response (decodes fields on access)
+ */
+class ReadStatusNewView : public ResponseView<ReadStatusResponseNew> {
+public:
+    typedef ReadStatusResponseNew Response;
 
-        // Tariff values (16 bytes = 4 x 4 bytes)
-        for (int i = 0; i < 4; i++) {
-            ProtocolUtils::uint32ToBytes(tariffValues[i], &data[index]);
-            index += 4;
-        }
+    EnergyType energyType() const { return get<EnergyType, &Response::energyType>(); }
+    ConfigByte configByte() const { return get<ConfigByte, &Response::configByte>(); }
+    uint16_t voltageTransformCoeff() const { return get<uint16_t, &Response::voltageTransformCoeff>(); }
+    uint16_t currentTransformCoeff() const { return get<uint16_t, &Response::currentTransformCoeff>(); }
+    uint32_t totalFull() const { return get<uint32_t, &Response::totalFull>(); }
+    uint32_t totalActive() const { return get<uint32_t, &Response::totalActive>(); }
 
-        return 30;
-    }
+    /**
+     * @brief Tariff value
+     * @param index Tariff index (0-3)
+     */
+    uint32_t tariffValue(size_t index) const { return element<uint32_t, 4, &Response::tariffValues>(index); }
 };
 
 /**
@@ -249,7 +207,9 @@ public:
     /**
      * @brief Constructor
      */
-    ReadStatusCommand() : BaseCommand(CMD_READ_STATUS), m_generation(0), m_isOldGeneration(true) {
+    ReadStatusCommand()
+        : BaseCommand(CMD_READ_STATUS), m_generation(0), m_boardGeneration(BOARD_GENERATION_OLD),
+          m_isOldGeneration(true) {
     }
 
     /**
@@ -261,6 +221,7 @@ public:
         GenerationInfo info = ProtocolUtils::determineGeneration(boardId, role);
         m_isOldGeneration = info.isOldGeneration;
         m_generation = boardId;
+        m_boardGeneration = BoardCapabilities::generation(boardId, role);
     }
 
     /**
@@ -313,10 +274,10 @@ public:
 
         // Generate response based on generation
         if (m_isOldGeneration) {
-            if (maxResponseSize < 26) return 0;
+            if (maxResponseSize < ReadStatusResponseOld::SIZE) return 0;
             return m_responseOld.toBytes(responseData);
         } else {
-            if (maxResponseSize < 30) return 0;
+            if (maxResponseSize < ReadStatusResponseNew::SIZE) return 0;
             return m_responseNew.toBytes(responseData);
         }
     }
@@ -333,10 +294,10 @@ public:
      * @brief Check if command is valid for device generation
      * @param boardId Board ID
      * @param role Role value
-     * @return true (ReadStatus is supported by all generations)
+     * @return true if the board profile lists ReadStatus
      */
     bool isValidForGeneration(uint8_t boardId, uint8_t role) const override {
-        return true; // Supported by all generations
+        return BoardCapabilities::supportsCommand(boardId, role, CMD_READ_STATUS);
     }
 
     /**
@@ -348,18 +309,14 @@ public:
     }
 
     /**
-     * @brief Get expected response size range
+     * @brief Get expected response size range (from the board profile)
      * @param minSize Minimum response size
      * @param maxSize Maximum response size
      */
     void getResponseSizeRange(size_t &minSize, size_t &maxSize) const override {
-        if (m_isOldGeneration) {
-            minSize = 26;
-            maxSize = 26;
-        } else {
-            minSize = 30;
-            maxSize = 31; // New generation can have 31 bytes
-        }
+        const BoardProfile &profile = BoardCapabilities::profile(m_boardGeneration);
+        minSize = profile.statusSize;
+        maxSize = profile.statusSizeMax;
     }
 
     /**
@@ -405,6 +362,7 @@ private:
     ReadStatusResponseOld m_responseOld;
     ReadStatusResponseNew m_responseNew;
     uint8_t m_generation;
+    BoardGeneration m_boardGeneration;
     bool m_isOldGeneration;
 };
 
@@ -0,0 +1,96 @@
+#include "Crc8Engine.h"
+
+// Table initializers expanded from constexpr entries (no STL, works with PROGMEM)
+#define MIRLIB_CRC8_ROW4(s, n) \
+    Crc8Engine::tableEntry((n), (s)), Crc8Engine::tableEntry((n) + 1, (s)), \
+    Crc8Engine::tableEntry((n) + 2, (s)), Crc8Engine::tableEntry((n) + 3, (s))
+#define MIRLIB_CRC8_ROW16(s, n) \
+    MIRLIB_CRC8_ROW4(s, n), MIRLIB_CRC8_ROW4(s, (n) + 4), \
+    MIRLIB_CRC8_ROW4(s, (n) + 8), MIRLIB_CRC8_ROW4(s, (n) + 12)
+#define MIRLIB_CRC8_ROW64(s, n) \
+    MIRLIB_CRC8_ROW16(s, n), MIRLIB_CRC8_ROW16(s, (n) + 16), \
+    MIRLIB_CRC8_ROW16(s, (n) + 32), MIRLIB_CRC8_ROW16(s, (n) + 48)
+#define MIRLIB_CRC8_TABLE(s) \
+    MIRLIB_CRC8_ROW64(s, 0), MIRLIB_CRC8_ROW64(s, 64), \
+    MIRLIB_CRC8_ROW64(s, 128), MIRLIB_CRC8_ROW64(s, 192)
+
+const uint8_t Crc8Engine::TABLE[256] PROGMEM = {MIRLIB_CRC8_TABLE(0)};
+
+#ifdef MIRLIB_CRC8_HAS_SLICING
+const uint8_t Crc8Engine::SLICE_TABLES[8][256] = {
+    {MIRLIB_CRC8_TABLE(0)},
+    {MIRLIB_CRC8_TABLE(1)},
+    {MIRLIB_CRC8_TABLE(2)},
+    {MIRLIB_CRC8_TABLE(3)},
+    {MIRLIB_CRC8_TABLE(4)},
+    {MIRLIB_CRC8_TABLE(5)},
+    {MIRLIB_CRC8_TABLE(6)},
+    {MIRLIB_CRC8_TABLE(7)},
+};
+#endif
+
+// Compile-time spot checks against the bitwise definition
+static_assert(Crc8Engine::tableEntry(0x00, 0) == 0x00, "CRC8 table entry 0x00");
+static_assert(Crc8Engine::tableEntry(0x01, 0) == ProtocolConstants::CRC_POLYNOMIAL, "CRC8 table entry 0x01");
+
+uint8_t Crc8Engine::updateBitwise(uint8_t crc, const uint8_t *data, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        uint8_t dataByte = data[i];
+
+        for (int bit = 0; bit < 8; bit++) {
+            if (((dataByte ^ crc) & 0x80) == 0) {
+                crc = (crc << 1);
+            } else {
+                crc = ((crc << 1) ^ ProtocolConstants::CRC_POLYNOMIAL);
+            }
+            dataByte = (dataByte << 1);
+        }
+    }
+
+    return crc;
+}
+
+uint8_t Crc8Engine::updateTable(uint8_t crc, const uint8_t *data, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        crc = pgm_read_byte(&TABLE[crc ^ data[i]]);
+    }
+
+    return crc;
+}
+
+#ifdef MIRLIB_CRC8_HAS_SLICING
+uint8_t Crc8Engine::updateSlice4(uint8_t crc, const uint8_t *data, size_t length) {
+    while (length >= 4) {
+        crc = SLICE_TABLES[3][crc ^ data[0]] ^
+              SLICE_TABLES[2][data[1]] ^
+              SLICE_TABLES[1][data[2]] ^
+              SLICE_TABLES[0][data[3]];
+        data += 4;
+        length -= 4;
+    }
+
+    while (length-- > 0) {
+        crc = SLICE_TABLES[0][crc ^ *data++];
+    }
+
+    return crc;
+}
+
+uint8_t Crc8Engine::updateSlice8(uint8_t crc, const uint8_t *data, size_t length) {
+    while (length >= 8) {
+        crc = SLICE_TABLES[7][crc ^ data[0]] ^
+              SLICE_TABLES[6][data[1]] ^
+              SLICE_TABLES[5][data[2]] ^
+              SLICE_TABLES[4][data[3]] ^
+              SLICE_TABLES[3][data[4]] ^
+              SLICE_TABLES[2][data[5]] ^
+              SLICE_TABLES[1][data[6]] ^
+              SLICE_TABLES[0][data[7]];
+        data += 8;
+        length -= 8;
+    }
+
+    // Tail shorter than a full slice
+    return updateSlice4(crc, data, length);
+}
+#endif
@@ -0,0 +1,191 @@
+#ifndef CRC8_ENGINE_H
+#define CRC8_ENGINE_H
+
+#include <Arduino.h>
+#include "ProtocolTypes.h"
+#include "MirlibDebug.h"
+
+/**
+ * @brief CRC8 engine tiers
+ *
+ * BITWISE - original bit-by-bit loop (no tables)
+ * TABLE   - one 256-byte lookup table (PROGMEM on AVR)
+ * SLICE4  - slice-by-4, 4 x 256-byte tables (not available on AVR)
+ * SLICE8  - slice-by-8, 8 x 256-byte tables (not available on AVR)
+ */
+#define MIRLIB_CRC8_TIER_BITWISE 0
+#define MIRLIB_CRC8_TIER_TABLE 1
+#define MIRLIB_CRC8_TIER_SLICE4 2
+#define MIRLIB_CRC8_TIER_SLICE8 3
+
+// Tier selection by platform (can be overridden with -DMIRLIB_CRC8_TIER=...)
+#ifndef MIRLIB_CRC8_TIER
+  #if defined(MIRLIB_PLATFORM_GCC)
+    #define MIRLIB_CRC8_TIER MIRLIB_CRC8_TIER_SLICE8
+  #else
+    #define MIRLIB_CRC8_TIER MIRLIB_CRC8_TIER_TABLE
+  #endif
+#endif
+
+#ifndef MIRLIB_PLATFORM_AVR
+  #define MIRLIB_CRC8_HAS_SLICING
+#endif
+
+#if MIRLIB_CRC8_TIER >= MIRLIB_CRC8_TIER_SLICE4 && !defined(MIRLIB_CRC8_HAS_SLICING)
+  #error "Mirlib: slice-by-N CRC8 is not available on this platform"
+#endif
+
+#ifdef MIRLIB_PLATFORM_GCC
+  #ifndef PROGMEM
+    #define PROGMEM
+  #endif
+  #ifndef pgm_read_byte
+    #define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+  #endif
+#endif
+
+/**
+ * @brief CRC8 (poly 0xA9, init 0x00, MSB first) with compile-time generated tables
+ *
+ * All tiers produce identical results; calculate() uses the tier selected
+ * by MIRLIB_CRC8_TIER.
+ */
+class Crc8Engine {
+public:
+    /**
+     * @brief Shift CRC register through a number of zero bits
+     * @param crc Current CRC value
+     * @param bits Number of bits to shift
+     * @return CRC value after shifting
+     */
+    static constexpr uint8_t shiftBits(uint8_t crc, uint8_t bits) {
+        return bits == 0
+                   ? crc
+                   : shiftBits((crc & 0x80) != 0
+                                   ? static_cast<uint8_t>((crc << 1) ^ ProtocolConstants::CRC_POLYNOMIAL)
+                                   : static_cast<uint8_t>(crc << 1),
+                               bits - 1);
+    }
+
+    /**
+     * @brief Compute lookup table entry
+     * @param index Table index (CRC register xor input byte)
+     * @param slice Number of trailing zero bytes (0 for the basic table)
+     * @return Table entry value
+     */
+    static constexpr uint8_t tableEntry(uint8_t index, uint8_t slice) {
+        return slice == 0 ? shiftBits(index, 8) : shiftBits(tableEntry(index, slice - 1), 8);
+    }
+
+    /**
+     * @brief Feed a single byte into the CRC
+     * @param crc Current CRC value
+     * @param value Input byte
+     * @return Updated CRC value
+     */
+    static uint8_t updateByte(uint8_t crc, uint8_t value) {
+        return pgm_read_byte(&TABLE[crc ^ value]);
+    }
+
+    /**
+     * @brief Calculate CRC8 with the configured tier
+     * @param data Pointer to data
+     * @param length Data length
+     * @return CRC8 value
+     */
+    static uint8_t calculate(const uint8_t *data, size_t length) {
+        return update(ProtocolConstants::CRC_INITIAL, data, length);
+    }
+
+    /**
+     * @brief Continue CRC8 calculation with the configured tier
+     * @param crc Current CRC value
+     * @param data Pointer to data
+     * @param length Data length
+     * @return Updated CRC value
+     */
+    static uint8_t update(uint8_t crc, const uint8_t *data, size_t length) {
+#if MIRLIB_CRC8_TIER == MIRLIB_CRC8_TIER_SLICE8
+        return updateSlice8(crc, data, length);
+#elif MIRLIB_CRC8_TIER == MIRLIB_CRC8_TIER_SLICE4
+        return updateSlice4(crc, data, length);
+#elif MIRLIB_CRC8_TIER == MIRLIB_CRC8_TIER_TABLE
+        return updateTable(crc, data, length);
+#else
+        return updateBitwise(crc, data, length);
+#endif
+    }
+
+    /**
+     * @brief Bit-by-bit CRC8 (reference implementation, no tables)
+     */
+    static uint8_t updateBitwise(uint8_t crc, const uint8_t *data, size_t length);
+
+    /**
+     * @brief Table-driven CRC8 (one lookup per byte)
+     */
+    static uint8_t updateTable(uint8_t crc, const uint8_t *data, size_t length);
+
+#ifdef MIRLIB_CRC8_HAS_SLICING
+    /**
+     * @brief Slice-by-4 CRC8 (4 independent lookups per 4 bytes)
+     */
+    static uint8_t updateSlice4(uint8_t crc, const uint8_t *data, size_t length);
+
+    /**
+     * @brief Slice-by-8 CRC8 (8 independent lookups per 8 bytes)
+     */
+    static uint8_t updateSlice8(uint8_t crc, const uint8_t *data, size_t length);
+#endif
+
+    static const uint8_t TABLE[256]; ///< Basic lookup table (PROGMEM on AVR)
+
+#ifdef MIRLIB_CRC8_HAS_SLICING
+    static const uint8_t SLICE_TABLES[8][256]; ///< Slice tables, [k] = byte followed by k zero bytes
+#endif
+};
+
+/**
+ * @brief Running CRC8 fed one byte or one burst at a time
+ *
+ * Produces the same value as Crc8Engine::calculate over the concatenated
+ * input, so a frame can be checked while it is still arriving.
+ */
+class Crc8Accumulator {
+public:
+    /**
+     * @brief Constructor (initial CRC value)
+     */
+    Crc8Accumulator() : m_crc(ProtocolConstants::CRC_INITIAL) {
+    }
+
+    /**
+     * @brief Restart from the initial CRC value
+     */
+    void reset() { m_crc = ProtocolConstants::CRC_INITIAL; }
+
+    /**
+     * @brief Feed a single byte
+     */
+    void add(uint8_t value) { m_crc = Crc8Engine::updateByte(m_crc, value); }
+
+    /**
+     * @brief Feed a burst of bytes with the configured tier
+     */
+    void add(const uint8_t *data, size_t length) { m_crc = Crc8Engine::update(m_crc, data, length); }
+
+    /**
+     * @brief CRC of all bytes fed so far
+     */
+    uint8_t value() const { return m_crc; }
+
+    /**
+     * @brief Check a received CRC byte against the bytes fed so far
+     */
+    bool matches(uint8_t crc) const { return m_crc == crc; }
+
+private:
+    uint8_t m_crc;
+};
+
+#endif // CRC8_ENGINE_H
@@ -0,0 +1,160 @@
+#include "ElechouseRadio.h"
+
+// Without the driver (MIRLIB_NO_ELECHOUSE) the adapter is not built
+#ifndef MIRLIB_NO_ELECHOUSE
+
+#include <ELECHOUSE_CC1101_SRC_DRV.h>
+
+ReceiveSignalHandler volatile ElechouseRadio::s_handler = nullptr;
+void *volatile ElechouseRadio::s_context = nullptr;
+volatile int ElechouseRadio::s_signalPin = -1;
+ReceiveSignalHandler volatile ElechouseRadio::s_fifoHandler = nullptr;
+void *volatile ElechouseRadio::s_fifoContext = nullptr;
+volatile int ElechouseRadio::s_fifoPin = -1;
+
+ElechouseRadio::ElechouseRadio() : m_gdo0Pin(-1) {
+}
+
+ElechouseRadio &ElechouseRadio::instance() {
+    static ElechouseRadio radio;
+    return radio;
+}
+
+bool ElechouseRadio::begin(int gdo0Pin) {
+    m_gdo0Pin = gdo0Pin;
+    ELECHOUSE_cc1101.setGDO0(gdo0Pin);
+    return ELECHOUSE_cc1101.getCC1101();
+}
+
+void ElechouseRadio::strobe(uint8_t command) {
+    ELECHOUSE_cc1101.SpiStrobe(command);
+}
+
+void ElechouseRadio::writeRegister(uint8_t address, uint8_t value) {
+    ELECHOUSE_cc1101.SpiWriteReg(address, value);
+}
+
+void ElechouseRadio::writeBurst(uint8_t address, const uint8_t *data, uint8_t size) {
+    ELECHOUSE_cc1101.SpiWriteBurstReg(address, const_cast<byte *>(data), size);
+}
+
+uint8_t ElechouseRadio::readRegister(uint8_t address) {
+    return ELECHOUSE_cc1101.SpiReadReg(address);
+}
+
+uint8_t ElechouseRadio::readStatus(uint8_t address) {
+    return ELECHOUSE_cc1101.SpiReadStatus(address);
+}
+
+void ElechouseRadio::send(const uint8_t *data, uint8_t size) {
+    ELECHOUSE_cc1101.SendData(const_cast<byte *>(data), size);
+}
+
+bool ElechouseRadio::receiveReady() {
+    return ELECHOUSE_cc1101.CheckReceiveFlag();
+}
+
+int ElechouseRadio::receive(uint8_t *buffer, uint8_t status[2]) {
+    // Same SPI sequence as ReceiveData(), which reads the status bytes and drops them
+    int size = 0;
+    if (ELECHOUSE_cc1101.SpiReadStatus(0x3B) & 0x7F) { // RXBYTES
+        size = ELECHOUSE_cc1101.SpiReadReg(0x3F); // RX FIFO, length byte
+        if (size > 0 && static_cast<size_t>(size) <= ProtocolConstants::MAX_PACKET_SIZE) {
+            ELECHOUSE_cc1101.SpiReadBurstReg(0x3F, buffer, size);
+            ELECHOUSE_cc1101.SpiReadBurstReg(0x3F, status, 2);
+        } else {
+            size = 0;
+        }
+    }
+
+    ELECHOUSE_cc1101.SpiStrobe(0x3A); // SFRX
+    ELECHOUSE_cc1101.SpiStrobe(0x34); // SRX
+    return size;
+}
+
+int ElechouseRadio::readFrame(uint8_t *buffer, uint8_t status[2]) {
+    const uint8_t available = ELECHOUSE_cc1101.SpiReadStatus(0x3B) & 0x7F; // RXBYTES
+    if (available == 0) {
+        return 0;
+    }
+
+    // Length byte, frame and two status bytes
+    const uint8_t size = ELECHOUSE_cc1101.SpiReadReg(0x3F); // RX FIFO, length byte
+    if (size == 0 || size > ProtocolConstants::MAX_PACKET_SIZE || size + 3 > available) {
+        return -1;
+    }
+
+    uint8_t raw[ProtocolConstants::MAX_PACKET_SIZE + 2];
+    ELECHOUSE_cc1101.SpiReadBurstReg(0x3F, raw, size + 2);
+    memcpy(buffer, raw, size);
+    status[0] = raw[size];
+    status[1] = raw[size + 1];
+    return size;
+}
+
+void ElechouseRadio::readFifo(uint8_t *buffer, uint8_t count) {
+    ELECHOUSE_cc1101.SpiReadBurstReg(0x3F, buffer, count); // RX FIFO
+}
+
+bool ElechouseRadio::attachFifoSignal(int gdo2Pin, ReceiveSignalHandler handler, void *context) {
+    if (gdo2Pin < 0 || handler == nullptr || (s_fifoHandler != nullptr && s_fifoContext != context)) {
+        return false;
+    }
+
+    detachFifoSignal();
+    s_fifoContext = context;
+    s_fifoHandler = handler;
+    s_fifoPin = gdo2Pin;
+    pinMode(gdo2Pin, INPUT);
+    attachInterrupt(digitalPinToInterrupt(gdo2Pin), gdo2Isr, RISING);
+
+    return true;
+}
+
+void ElechouseRadio::detachFifoSignal() {
+    if (s_fifoPin >= 0) {
+        detachInterrupt(digitalPinToInterrupt(s_fifoPin));
+        s_fifoPin = -1;
+    }
+    s_fifoHandler = nullptr;
+    s_fifoContext = nullptr;
+}
+
+bool ElechouseRadio::attachReceiveSignal(ReceiveSignalHandler handler, void *context) {
+    if (m_gdo0Pin < 0 || handler == nullptr || (s_handler != nullptr && s_context != context)) {
+        return false;
+    }
+
+    detachReceiveSignal();
+    s_context = context;
+    s_handler = handler;
+    s_signalPin = m_gdo0Pin;
+    attachInterrupt(digitalPinToInterrupt(m_gdo0Pin), gdo0Isr, CHANGE);
+
+    return true;
+}
+
+void ElechouseRadio::detachReceiveSignal() {
+    if (s_signalPin >= 0) {
+        detachInterrupt(digitalPinToInterrupt(s_signalPin));
+        s_signalPin = -1;
+    }
+    s_handler = nullptr;
+    s_context = nullptr;
+}
+
+void MIRLIB_ISR_ATTR ElechouseRadio::gdo0Isr() {
+    ReceiveSignalHandler const handler = s_handler;
+    if (handler != nullptr) {
+        handler(s_context, digitalRead(s_signalPin) != 0);
+    }
+}
+
+void MIRLIB_ISR_ATTR ElechouseRadio::gdo2Isr() {
+    ReceiveSignalHandler const handler = s_fifoHandler;
+    if (handler != nullptr) {
+        handler(s_fifoContext, true);
+    }
+}
+
+#endif // MIRLIB_NO_ELECHOUSE
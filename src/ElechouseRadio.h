@@ -0,0 +1,53 @@
+#ifndef ELECHOUSE_RADIO_H
+#define ELECHOUSE_RADIO_H
+
+#include <Arduino.h>
+#include "RadioBackend.h"
+
+/**
+ * @brief RadioBackend over the ELECHOUSE_cc1101 driver (default backend)
+ *
+ * The driver is a global singleton, so is the adapter. The receive signal
+ * is a CHANGE interrupt on GDO0 (IOCFG0 = 0x06: high from sync word to end
+ * of packet), the FIFO signal a RISING interrupt on GDO2.
+ */
+class ElechouseRadio : public RadioBackend {
+public:
+    /**
+     * @brief The adapter of the global ELECHOUSE_cc1101 instance
+     */
+    static ElechouseRadio &instance();
+
+    bool begin(int gdo0Pin) override;
+    void strobe(uint8_t command) override;
+    void writeRegister(uint8_t address, uint8_t value) override;
+    void writeBurst(uint8_t address, const uint8_t *data, uint8_t size) override;
+    uint8_t readRegister(uint8_t address) override;
+    uint8_t readStatus(uint8_t address) override;
+    void send(const uint8_t *data, uint8_t size) override;
+    bool receiveReady() override;
+    int receive(uint8_t *buffer, uint8_t status[2]) override;
+    int readFrame(uint8_t *buffer, uint8_t status[2]) override;
+    void readFifo(uint8_t *buffer, uint8_t count) override;
+    bool attachFifoSignal(int gdo2Pin, ReceiveSignalHandler handler, void *context) override;
+    void detachFifoSignal() override;
+    bool attachReceiveSignal(ReceiveSignalHandler handler, void *context) override;
+    void detachReceiveSignal() override;
+
+private:
+    ElechouseRadio();
+
+    int m_gdo0Pin;
+
+    static ReceiveSignalHandler volatile s_handler;
+    static void *volatile s_context;
+    static volatile int s_signalPin;
+    static ReceiveSignalHandler volatile s_fifoHandler;
+    static void *volatile s_fifoContext;
+    static volatile int s_fifoPin;
+
+    static void gdo0Isr();
+    static void gdo2Isr();
+};
+
+#endif // ELECHOUSE_RADIO_H
@@ -0,0 +1,300 @@
+#ifndef FIELD_SCHEMA_H
+#define FIELD_SCHEMA_H
+
+#include <Arduino.h>
+#include "ProtocolTypes.h"
+
+/**
+ * @brief Field accessors are always inlined so that a schema compiles to
+ * straight-line code even with -Os (default for AVR/ESP32 builds)
+ */
+#define MIRLIB_FIELD_INLINE inline __attribute__((always_inline))
+
+/**
+ * @brief Unrolled little-endian integer of Width bytes
+ */
+template<size_t Width>
+struct LittleEndian {
+    MIRLIB_FIELD_INLINE static uint32_t read(const uint8_t *data) {
+        return LittleEndian<Width - 1>::read(data) |
+               (static_cast<uint32_t>(data[Width - 1]) << (8 * (Width - 1)));
+    }
+
+    MIRLIB_FIELD_INLINE static void write(uint32_t value, uint8_t *data) {
+        LittleEndian<Width - 1>::write(value, data);
+        data[Width - 1] = static_cast<uint8_t>(value >> (8 * (Width - 1)));
+    }
+};
+
+template<>
+struct LittleEndian<0> {
+    MIRLIB_FIELD_INLINE static uint32_t read(const uint8_t *) { return 0; }
+    MIRLIB_FIELD_INLINE static void write(uint32_t, uint8_t *) {}
+};
+
+/**
+ * @brief Wire codec of one field value
+ *
+ * Integers and enums are little-endian with a width of 1..4 bytes
+ * (3-byte values are stored in uint32_t); arrays repeat the element codec.
+ * @tparam T Member type
+ * @tparam Width Width of one value on the wire, in bytes
+ */
+template<typename T, size_t Width>
+struct FieldCodec {
+    static_assert(Width >= 1 && Width <= 4 && Width <= sizeof(T), "Mirlib: field width must be 1..4 bytes and fit the member");
+
+    static const size_t SIZE = Width;
+
+    MIRLIB_FIELD_INLINE static void read(T &value, const uint8_t *data) {
+        value = static_cast<T>(LittleEndian<Width>::read(data));
+    }
+
+    MIRLIB_FIELD_INLINE static void write(const T &value, uint8_t *data) {
+        LittleEndian<Width>::write(static_cast<uint32_t>(value), data);
+    }
+};
+
+template<size_t Width>
+struct FieldCodec<ConfigByte, Width> {
+    static_assert(Width == 1, "Mirlib: ConfigByte is a single byte");
+
+    static const size_t SIZE = 1;
+
+    MIRLIB_FIELD_INLINE static void read(ConfigByte &value, const uint8_t *data) {
+        value.fromByte(data[0]);
+    }
+
+    MIRLIB_FIELD_INLINE static void write(const ConfigByte &value, uint8_t *data) {
+        data[0] = value.toByte();
+    }
+};
+
+template<typename T, size_t N, size_t Width>
+struct FieldCodec<T[N], Width> {
+    typedef FieldCodec<T, Width> Element;
+
+    static const size_t SIZE = N * Element::SIZE;
+
+    MIRLIB_FIELD_INLINE static void read(T (&value)[N], const uint8_t *data) {
+        for (size_t i = 0; i < N; i++) {
+            Element::read(value[i], data + i * Element::SIZE);
+        }
+    }
+
+    MIRLIB_FIELD_INLINE static void write(const T (&value)[N], uint8_t *data) {
+        for (size_t i = 0; i < N; i++) {
+            Element::write(value[i], data + i * Element::SIZE);
+        }
+    }
+};
+
+/**
+ * @brief One struct member in a wire layout
+ * @tparam Owner Struct type
+ * @tparam T Member type
+ * @tparam Member Pointer to the member
+ * @tparam Width Width of one value on the wire (element width for arrays)
+ */
+template<typename Owner, typename T, T Owner::*Member, size_t Width>
+struct Field {
+    typedef FieldCodec<T, Width> Codec;
+
+    static const size_t SIZE = Codec::SIZE;
+
+    MIRLIB_FIELD_INLINE static void decode(Owner &owner, const uint8_t *data) {
+        Codec::read(owner.*Member, data);
+    }
+
+    MIRLIB_FIELD_INLINE static void encode(const Owner &owner, uint8_t *data) {
+        Codec::write(owner.*Member, data);
+    }
+};
+
+/**
+ * @brief Wire layout of consecutive fields
+ *
+ * Field offsets are the running sum of the preceding widths and SIZE is a
+ * compile-time constant, so decode()/encode() compile to straight-line
+ * loads and stores. Bounds are checked once by the caller (or by
+ * fromBytes), never per field.
+ * @code
+ * typedef FieldSchema<
+ *     Field<PingResponse, uint16_t, &PingResponse::firmwareVersion, 2>,
+ *     Field<PingResponse, uint16_t, &PingResponse::deviceAddress, 2>
+ * > Schema; // Schema::SIZE == 4
+ * @endcode
+ */
+template<typename... Fields>
+struct FieldSchema;
+
+template<>
+struct FieldSchema<> {
+    static const size_t SIZE = 0;
+
+    template<typename Owner>
+    MIRLIB_FIELD_INLINE static void decode(Owner &, const uint8_t *) {}
+
+    template<typename Owner>
+    MIRLIB_FIELD_INLINE static void encode(const Owner &, uint8_t *) {}
+};
+
+template<typename First, typename... Rest>
+struct FieldSchema<First, Rest...> {
+    typedef FieldSchema<Rest...> Next;
+
+    static const size_t SIZE = First::SIZE + Next::SIZE; ///< Total wire size
+
+    /**
+     * @brief Decode all fields (data must hold at least SIZE bytes)
+     */
+    template<typename Owner>
+    MIRLIB_FIELD_INLINE static void decode(Owner &owner, const uint8_t *data) {
+        First::decode(owner, data);
+        Next::decode(owner, data + First::SIZE);
+    }
+
+    /**
+     * @brief Encode all fields (data must hold at least SIZE bytes)
+     */
+    template<typename Owner>
+    MIRLIB_FIELD_INLINE static void encode(const Owner &owner, uint8_t *data) {
+        First::encode(owner, data);
+        Next::encode(owner, data + First::SIZE);
+    }
+
+    /**
+     * @brief Decode with a single length check
+     * @return false if size < SIZE
+     */
+    template<typename Owner>
+    MIRLIB_FIELD_INLINE static bool fromBytes(Owner &owner, const uint8_t *data, size_t size) {
+        if (size < SIZE) return false;
+        decode(owner, data);
+        return true;
+    }
+
+    /**
+     * @brief Encode and return SIZE
+     */
+    template<typename Owner>
+    MIRLIB_FIELD_INLINE static size_t toBytes(const Owner &owner, uint8_t *data) {
+        encode(owner, data);
+        return SIZE;
+    }
+};
+
+/**
+ * @brief Compile-time offset and codec of a member in a schema
+ *
+ * Fails to compile if the member is not part of the schema.
+ */
+template<typename Schema, typename Owner, typename T, T Owner::*Member>
+struct FieldLocator;
+
+template<typename Owner, typename T, T Owner::*Member, size_t Width, typename... Rest>
+struct FieldLocator<FieldSchema<Field<Owner, T, Member, Width>, Rest...>, Owner, T, Member> {
+    typedef FieldCodec<T, Width> Codec;
+
+    static const size_t OFFSET = 0;
+};
+
+template<typename First, typename... Rest, typename Owner, typename T, T Owner::*Member>
+struct FieldLocator<FieldSchema<First, Rest...>, Owner, T, Member> {
+    typedef FieldLocator<FieldSchema<Rest...>, Owner, T, Member> Next;
+    typedef typename Next::Codec Codec;
+
+    static const size_t OFFSET = First::SIZE + Next::OFFSET;
+};
+
+/**
+ * @brief Non-owning view over response data laid out by a schema
+ *
+ * Fields are decoded on access from the underlying buffer, which must
+ * outlive the view. Derived views add named accessors.
+ * @tparam Response Response struct
+ * @tparam Schema Wire layout (Response::Schema by default)
+ */
+template<typename Response, typename Schema = typename Response::Schema>
+class ResponseView {
+public:
+    static const size_t SIZE = Schema::SIZE; ///< Minimum data size
+
+    /**
+     * @brief Constructor (empty view)
+     */
+    ResponseView() : m_data(nullptr), m_size(0) {
+    }
+
+    /**
+     * @brief Attach to response data
+     * @param data Response data
+     * @param size Response data size
+     * @return false if data is shorter than the schema
+     */
+    bool attach(const uint8_t *data, size_t size) {
+        if (data == nullptr || size < SIZE) {
+            reset();
+            return false;
+        }
+
+        m_data = data;
+        m_size = size;
+        return true;
+    }
+
+    /**
+     * @brief Detach from the data
+     */
+    void reset() {
+        m_data = nullptr;
+        m_size = 0;
+    }
+
+    /**
+     * @brief Check if view is attached to data
+     */
+    bool isAttached() const { return m_data != nullptr; }
+
+    /**
+     * @brief Underlying data
+     */
+    const uint8_t *data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+    /**
+     * @brief Decode all fields into the response struct
+     */
+    void decode(Response &response) const {
+        Schema::decode(response, m_data);
+    }
+
+protected:
+    /**
+     * @brief Decode one member
+     */
+    template<typename T, T Response::*Member>
+    T get() const {
+        typedef FieldLocator<Schema, Response, T, Member> Locator;
+        T value;
+        Locator::Codec::read(value, m_data + Locator::OFFSET);
+        return value;
+    }
+
+    /**
+     * @brief Decode one element of an array member
+     */
+    template<typename T, size_t N, T (Response::*Member)[N]>
+    T element(size_t index) const {
+        typedef FieldLocator<Schema, Response, T[N], Member> Locator;
+        typedef typename Locator::Codec::Element Element;
+        T value;
+        Element::read(value, m_data + Locator::OFFSET + index * Element::SIZE);
+        return value;
+    }
+
+    const uint8_t *m_data;
+    size_t m_size;
+};
+
+#endif // FIELD_SCHEMA_H
@@ -0,0 +1,133 @@
+#ifndef FRAME_RING_H
+#define FRAME_RING_H
+
+#include <Arduino.h>
+#include "ProtocolTypes.h"
+#include "MirlibDebug.h"
+
+#ifndef MIRLIB_RX_RING_SIZE
+  #if defined(MIRLIB_PLATFORM_AVR)
+    #define MIRLIB_RX_RING_SIZE 2
+  #else
+    #define MIRLIB_RX_RING_SIZE 8
+  #endif
+#endif
+
+// Orders slot writes before index publication (single core AVR only needs a compiler barrier)
+#if defined(MIRLIB_PLATFORM_AVR)
+  #define MIRLIB_RING_BARRIER() __asm__ __volatile__("" ::: "memory")
+#else
+  #define MIRLIB_RING_BARRIER() __sync_synchronize()
+#endif
+
+/**
+ * @brief RxFrame::flags: bytes hold the unstuffed, CRC-checked frame (Parameters to CRC)
+ */
+const uint8_t RX_FRAME_UNSTUFFED = 0x01;
+
+/**
+ * @brief Frame as read from the radio FIFO
+ */
+struct RxFrame {
+    RxMetadata metadata; ///< Sync timestamp (GDO0 edge) and appended status bytes
+    uint8_t size; ///< Number of valid bytes
+    uint8_t flags; ///< RX_FRAME_* flags
+    uint8_t bytes[ProtocolConstants::MAX_PACKET_SIZE]; ///< Raw frame with start/stop bytes, or unstuffed frame
+};
+
+/**
+ * @brief Fixed-size single-producer/single-consumer queue of received frames
+ *
+ * The producer (radio ISR or drain task) fills slots in place and publishes
+ * them with commit(); the consumer reads front() and releases it with pop().
+ * No locks: each index is written by one side only. When the queue is full
+ * the producer gets a scratch slot, so the FIFO is still drained and the
+ * frame is counted as dropped.
+ *
+ * @tparam CAPACITY Number of slots, power of two not above 128
+ */
+template<uint8_t CAPACITY = MIRLIB_RX_RING_SIZE>
+class FrameRing {
+    static_assert(CAPACITY > 0 && CAPACITY <= 128 && (CAPACITY & (CAPACITY - 1)) == 0,
+                  "FrameRing capacity must be a power of two not above 128");
+
+public:
+    FrameRing() : m_head(0), m_tail(0), m_dropped(0) {
+    }
+
+    /**
+     * @brief Slot for the next frame (producer side)
+     * @return Free slot, or the scratch slot if the queue is full
+     */
+    RxFrame &producerSlot() {
+        return full() ? m_scratch : m_slots[m_head & MASK];
+    }
+
+    /**
+     * @brief Publish the slot returned by producerSlot() (producer side)
+     * @return false if the queue was full and the frame was dropped
+     */
+    bool commit() {
+        if (full()) {
+            m_dropped = m_dropped + 1;
+            return false;
+        }
+        MIRLIB_RING_BARRIER();
+        m_head = static_cast<uint8_t>(m_head + 1);
+        return true;
+    }
+
+    /**
+     * @brief Oldest frame (consumer side)
+     * @return Frame, or nullptr if the queue is empty
+     */
+    const RxFrame *front() const {
+        if (empty()) {
+            return nullptr;
+        }
+        MIRLIB_RING_BARRIER();
+        return &m_slots[m_tail & MASK];
+    }
+
+    /**
+     * @brief Release the frame returned by front() (consumer side)
+     */
+    void pop() {
+        if (!empty()) {
+            MIRLIB_RING_BARRIER();
+            m_tail = static_cast<uint8_t>(m_tail + 1);
+        }
+    }
+
+    /**
+     * @brief Drop all queued frames (consumer side)
+     */
+    void clear() {
+        MIRLIB_RING_BARRIER();
+        m_tail = m_head;
+    }
+
+    bool empty() const { return m_head == m_tail; }
+
+    bool full() const { return static_cast<uint8_t>(m_head - m_tail) >= CAPACITY; }
+
+    uint8_t count() const { return static_cast<uint8_t>(m_head - m_tail); }
+
+    /**
+     * @brief Frames dropped because the queue was full
+     */
+    uint16_t dropped() const { return m_dropped; }
+
+    static uint8_t capacity() { return CAPACITY; }
+
+private:
+    static const uint8_t MASK = CAPACITY - 1;
+
+    RxFrame m_slots[CAPACITY];
+    RxFrame m_scratch;
+    volatile uint8_t m_head; ///< Written by the producer only (free-running)
+    volatile uint8_t m_tail; ///< Written by the consumer only (free-running)
+    volatile uint16_t m_dropped;
+};
+
+#endif // FRAME_RING_H
@@ -0,0 +1,166 @@
+#include "FrameUnstuffer.h"
+
+FrameUnstuffer::FrameUnstuffer()
+    : m_state(STATE_HUNT)
+      , m_result(RESULT_PENDING)
+      , m_marker(false)
+      , m_failed(false)
+      , m_crcOk(false)
+      , m_decoded(false)
+      , m_index(0)
+      , m_crcIndex(ProtocolConstants::HEADER_SIZE)
+{
+}
+
+FrameUnstuffer::Result FrameUnstuffer::feedByte(uint8_t value) {
+    switch (m_state) {
+        case STATE_HUNT:
+            if (value == ProtocolConstants::START1) {
+                m_state = STATE_START;
+            }
+            return RESULT_PENDING;
+
+        case STATE_START:
+            if (value == ProtocolConstants::START2) {
+                beginFrame();
+            } else if (value != ProtocolConstants::START1) {
+                m_state = STATE_HUNT;
+            }
+            return RESULT_PENDING;
+
+        case STATE_BODY:
+        default:
+            return bodyByte(value);
+    }
+}
+
+FrameUnstuffer::Result FrameUnstuffer::feed(const uint8_t *data, size_t size, size_t &consumed) {
+    consumed = 0;
+    if (data == nullptr) {
+        return RESULT_PENDING;
+    }
+
+    while (consumed < size) {
+        // Runs of plain header/data bytes are copied and fed to the CRC as one burst
+        if (m_state == STATE_BODY && !m_marker && m_index > 0 && m_index < m_crcIndex) {
+            const uint8_t *const run = data + consumed;
+            size_t available = size - consumed;
+            if (available > m_crcIndex - m_index) {
+                available = m_crcIndex - m_index;
+            }
+
+            size_t length = 0;
+            while (length < available && run[length] != ProtocolConstants::STOP &&
+                   run[length] != ProtocolConstants::STUFF_MARKER) {
+                length++;
+            }
+
+            if (length > 0) {
+                memcpy(m_frame + m_index, run, length);
+                m_crc.add(run, length);
+                m_index += length;
+                consumed += length;
+                continue;
+            }
+        }
+
+        Result const result = feedByte(data[consumed++]);
+        if (result != RESULT_PENDING) {
+            return result;
+        }
+    }
+    return RESULT_PENDING;
+}
+
+void FrameUnstuffer::reset() {
+    m_state = STATE_HUNT;
+    m_result = RESULT_PENDING;
+    m_marker = false;
+    m_index = 0;
+    m_crcIndex = ProtocolConstants::HEADER_SIZE;
+}
+
+bool FrameUnstuffer::attach(PacketView &view, uint32_t encodingKey) {
+    if (m_result != RESULT_VALID || !view.attach(m_frame, frameSize())) {
+        view.reset();
+        return false;
+    }
+
+    if (!m_decoded && (m_frame[0] & 0x80) != 0) {
+        ProtocolUtils::applyKeystream(m_frame + ProtocolConstants::HEADER_SIZE, view.dataSize(), encodingKey);
+    }
+    m_decoded = true;
+    return true;
+}
+
+void FrameUnstuffer::beginFrame() {
+    m_state = STATE_BODY;
+    m_result = RESULT_PENDING;
+    m_marker = false;
+    m_failed = false;
+    m_crcOk = false;
+    m_decoded = false;
+    m_index = 0;
+    m_crcIndex = ProtocolConstants::HEADER_SIZE; // Updated once parameters are known
+    m_crc.reset();
+}
+
+FrameUnstuffer::Result FrameUnstuffer::bodyByte(uint8_t value) {
+    if (value == ProtocolConstants::STOP) {
+        if (m_marker) {
+            // Marker right before STOP has no pair and is kept as is
+            put(ProtocolConstants::STUFF_MARKER);
+        }
+        return completeFrame();
+    }
+
+    if (m_marker) {
+        m_marker = false;
+        if (value == ProtocolConstants::STUFF_0x55) {
+            put(0x55);
+        } else if (value == ProtocolConstants::STUFF_0x73) {
+            put(0x73);
+        } else if (m_index >= ProtocolConstants::MAX_PACKET_SIZE - 1) {
+            m_failed = true;
+        } else {
+            // Invalid stuffing, both bytes are kept
+            put(ProtocolConstants::STUFF_MARKER);
+            put(value);
+        }
+        return RESULT_PENDING;
+    }
+
+    // Output is capped, the rest of the frame is only scanned for STOP
+    if (m_index >= ProtocolConstants::MAX_PACKET_SIZE) {
+        return RESULT_PENDING;
+    }
+
+    if (value == ProtocolConstants::STUFF_MARKER) {
+        m_marker = true;
+    } else {
+        put(value);
+    }
+    return RESULT_PENDING;
+}
+
+void FrameUnstuffer::put(uint8_t value) {
+    if (m_index < m_crcIndex) {
+        m_crc.add(value);
+        if (m_index == 0) {
+            m_crcIndex = ProtocolConstants::HEADER_SIZE + (value & 0x1F);
+        }
+        m_frame[m_index] = value;
+    } else if (m_index == m_crcIndex) {
+        m_frame[m_index] = value;
+        m_crcOk = m_crc.matches(value);
+    }
+    // Bytes after CRC are ignored
+
+    m_index++;
+}
+
+FrameUnstuffer::Result FrameUnstuffer::completeFrame() {
+    m_state = STATE_HUNT;
+    m_result = (!m_failed && m_crcOk) ? RESULT_VALID : RESULT_INVALID;
+    return m_result;
+}
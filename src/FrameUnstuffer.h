@@ -0,0 +1,139 @@
+#ifndef FRAME_UNSTUFFER_H
+#define FRAME_UNSTUFFER_H
+
+#include <Arduino.h>
+#include "ProtocolTypes.h"
+#include "Crc8Engine.h"
+#include "PacketView.h"
+
+/**
+ * @brief Incremental unstuffer: raw bytes in, unstuffed and CRC-checked frame out
+ *
+ * Bytes are taken one at a time or in bursts (e.g. as the radio FIFO is
+ * drained), unstuffed and fed into a running CRC immediately, so the frame
+ * is validated by the time STOP arrives. Bytes before START1 START2 are
+ * skipped; inside a frame the first unescaped 0x55 is STOP.
+ *
+ * Same rules as ProtocolUtils::unstuffFrame: output is capped at
+ * MAX_PACKET_SIZE, invalid escape pairs are kept as two bytes, bytes after
+ * CRC are ignored, and a marker right before STOP is kept as a data byte.
+ */
+class FrameUnstuffer {
+public:
+    /**
+     * @brief State after feeding input
+     */
+    enum Result {
+        RESULT_PENDING, ///< No frame completed yet
+        RESULT_VALID, ///< Frame completed, framing and CRC are valid
+        RESULT_INVALID ///< Frame completed, framing or CRC is invalid
+    };
+
+    /**
+     * @brief Constructor
+     */
+    FrameUnstuffer();
+
+    /**
+     * @brief Feed a single raw byte
+     * @param value Raw byte
+     * @return RESULT_VALID/RESULT_INVALID when this byte was STOP, RESULT_PENDING otherwise
+     */
+    Result feedByte(uint8_t value);
+
+    /**
+     * @brief Feed a burst of raw bytes, stopping after the first completed frame
+     * @param data Raw bytes
+     * @param size Number of bytes
+     * @param consumed Number of bytes processed (output)
+     * @return Result of the completed frame, RESULT_PENDING if all bytes were consumed without STOP
+     */
+    Result feed(const uint8_t *data, size_t size, size_t &consumed);
+
+    /**
+     * @brief Drop any partially received frame
+     */
+    void reset();
+
+    /**
+     * @brief Check if START1 START2 was received and STOP was not yet
+     */
+    bool inFrame() const { return m_state == STATE_BODY; }
+
+    /**
+     * @brief Check if the header (Parameters..Password/Status) is already unstuffed
+     *
+     * Header fields in frame() are final from this point on, so a receiver
+     * can filter on addresses and command before the rest of the frame arrives.
+     */
+    bool headerComplete() const { return m_index >= ProtocolConstants::HEADER_SIZE; }
+
+    /**
+     * @brief Unstuffed frame (Parameters to CRC), overwritten by the next frame
+     */
+    const uint8_t *frame() const { return m_frame; }
+
+    /**
+     * @brief Size of the completed frame from Parameters to CRC inclusive
+     */
+    size_t frameSize() const { return m_crcIndex + 1; }
+
+    /**
+     * @brief Result of the last completed frame
+     */
+    Result result() const { return m_result; }
+
+    /**
+     * @brief Attach a view to the last valid frame
+     *
+     * Data of encoded frames (params.encoding) is decoded in place on the
+     * first call, as in PacketView::decode.
+     * @param view Output view
+     * @param encodingKey Keystream key for encoded frames
+     * @return false if the last completed frame is not valid
+     */
+    bool attach(PacketView &view, uint32_t encodingKey = 0);
+
+private:
+    enum State {
+        STATE_HUNT, ///< Waiting for START1
+        STATE_START, ///< Got START1, waiting for START2
+        STATE_BODY ///< Inside a frame, waiting for STOP
+    };
+
+    static const size_t FRAME_CAPACITY = ProtocolConstants::HEADER_SIZE + ProtocolConstants::MAX_DATA_SIZE + 1;
+
+    State m_state;
+    Result m_result;
+    bool m_marker; ///< Last body byte was a stuffing marker awaiting its pair
+    bool m_failed; ///< Invalid escape pair did not fit
+    bool m_crcOk; ///< CRC byte received and matched
+    bool m_decoded; ///< Keystream already removed from data
+    uint8_t m_frame[FRAME_CAPACITY];
+    size_t m_index; ///< Unstuffed bytes so far (capped at MAX_PACKET_SIZE)
+    size_t m_crcIndex; ///< Position of CRC, known after Parameters
+    Crc8Accumulator m_crc;
+
+    /**
+     * @brief Start a new frame with START1 START2 already received
+     */
+    void beginFrame();
+
+    /**
+     * @brief Handle one raw byte inside a frame
+     * @return Frame result if the byte was STOP, RESULT_PENDING otherwise
+     */
+    Result bodyByte(uint8_t value);
+
+    /**
+     * @brief Store one unstuffed byte and update CRC
+     */
+    void put(uint8_t value);
+
+    /**
+     * @brief Finish the frame on STOP
+     */
+    Result completeFrame();
+};
+
+#endif // FRAME_UNSTUFFER_H
@@ -1,21 +1,86 @@
 #include "MirlibBase.h"
 
 #include "MirlibDebug.h"
+#include "FrameUnstuffer.h"
 
-MirlibBase::MirlibBase(uint16_t deviceAddress)
+#ifndef MIRLIB_NO_ELECHOUSE
+  #include "ElechouseRadio.h"
+#endif
+
+namespace {
+    RadioBackend *defaultRadio() {
+        #ifdef MIRLIB_NO_ELECHOUSE
+            return nullptr;
+        #else
+            return &ElechouseRadio::instance();
+        #endif
+    }
+}
+
+/**
+ * @brief Разбор пакета, принимаемого по частям (потоковый прием)
+ */
+struct MirlibBase::ReceiveStream {
+    FrameUnstuffer unstuffer;
+    uint8_t remaining; ///< Байты текущего пакета и статуса, еще не вычитанные из FIFO (0 - следующий байт - длина)
+    uint8_t length; ///< Длина кадра текущего пакета
+    bool done; ///< Кадр пакета уже завершен, остаток пакета пропускается
+    bool valid; ///< Кадр распакован и проверен, ставится в очередь после байтов статуса
+    RxMetadata metadata; ///< Отметка времени синхрослова и байты статуса текущего пакета
+
+    ReceiveStream() : remaining(0), length(0), done(false), valid(false) {
+    }
+};
+
+MirlibBase::MirlibBase(uint16_t deviceAddress, RadioBackend *radio)
     : m_deviceAddress(deviceAddress)
       , m_password(0)
       , m_status(0)
       , m_timeout(5000)
       , m_generation(UNKNOWN)
       , m_lastError(ERR_NONE)
+      , m_radio(radio != nullptr ? radio : defaultRadio())
+      , m_gdo0Pin(-1)
+      , m_receiveAborted(false)
+      , m_receiveExtended(false)
+      , m_receiveElapsedMs(0)
+      , m_txEndTimestamp(0)
+      , m_rxRing(nullptr)
+      , m_rxSignal(nullptr)
+      , m_txActive(false)
+      , m_syncTimestamp(0)
+      , m_radioConfigured(false)
+      , m_fastTransmit(false)
+      , m_packetsSinceCalibration(0)
+      , m_calibrationTime(0)
+      , m_temperature(0)
+      , m_calibrationTemperature(0)
+      , m_temperatureKnown(false)
+      , m_paTable(0xC4)
+      , m_paTableWritten(0)
+      , m_paTableValid(false)
+      , m_leanReceive(false)
+      , m_stream(nullptr)
+      , m_rxTimerArmed(false)
+      , m_channel(0x16)
 {
+    resetTransmitStats();
+    resetRadioStats();
+}
+
+MirlibBase::~MirlibBase() {
+    disableReceiveInterrupt();
 }
 
 bool MirlibBase::begin(int gdo0Pin) {
-    ELECHOUSE_cc1101.setGDO0(gdo0Pin);
+    m_gdo0Pin = gdo0Pin;
 
-    if (!ELECHOUSE_cc1101.getCC1101()) {
+    if (m_radio == nullptr) {
+        setError(ERR_SPI_CC1101_CON_ERROR);
+        return false;
+    }
+
+    if (!m_radio->begin(gdo0Pin)) {
         setError(ERR_SPI_CC1101_CON_ERROR);
     } else {
         #ifdef MIRLIB_DEBUG
@@ -43,7 +108,7 @@ bool MirlibBase::initializeCC1101() {
         0xD3, // SYNC1               Sync Word, High Byte
         0x91, // SYNC0               Sync Word, Low Byte
         0x3C, // PKTLEN              Packet Length
-        0x00, // PKTCTRL1            Packet Automation Control
+        0x04, // PKTCTRL1            Packet Automation Control (APPEND_STATUS: RSSI и LQI после кадра)
         0x41, // PKTCTRL0            Packet Automation Control
         0x00, // ADDR                Device Address
         0x16, // CHANNR              Channel Number
@@ -86,20 +151,36 @@ bool MirlibBase::initializeCC1101() {
     };
 
     // Сброс CC1101
-    ELECHOUSE_cc1101.SpiStrobe(0x30); // SRES - Reset chip
+    strobe(0x30); // SRES - Reset chip
     delay(1);
 
     // Запись настроек в регистры CC1101
-    ELECHOUSE_cc1101.SpiWriteBurstReg(0x00, const_cast<byte *>(rfSettings), 0x2F);
+    m_radio->writeBurst(0x00, rfSettings, 0x2F);
+    m_radio->writeRegister(0x0A, m_channel); // CHANNR
+    m_radioConfigured = true;
+    if (m_fastTransmit) {
+        writeCalibrationMode();
+    }
+    if (m_leanReceive) {
+        writeReceiveMode();
+    }
+    if (m_stream != nullptr) {
+        m_radio->writeRegister(0x00, 0x00); // IOCFG2 - RX FIFO не ниже порога
+        m_radio->writeRegister(0x03, 0x41); // FIFOTHR - порог RX FIFO 8 байт
+        resetStream();
+    }
+    // После сброса PATABLE содержит значение по умолчанию
+    m_paTableValid = false;
 
     // Калибровка частотного синтезатора
-    ELECHOUSE_cc1101.SpiStrobe(0x33); // SCAL - Calibrate frequency synthesizer and turn it off
+    strobe(0x33); // SCAL - Calibrate frequency synthesizer and turn it off
+    noteCalibration();
     // Очистка FIFO буферов
-    ELECHOUSE_cc1101.SpiStrobe(0x3A); // SFRX - Flush the RX FIFO buffer
-    ELECHOUSE_cc1101.SpiStrobe(0x3B); // SFTX - Flush the TX FIFO buffer
+    strobe(0x3A); // SFRX - Flush the RX FIFO buffer
+    strobe(0x3B); // SFTX - Flush the TX FIFO buffer
 
     // Переход в режим приема
-    ELECHOUSE_cc1101.SpiStrobe(0x34); // SRX - Enable RX
+    strobe(0x34); // SRX - Enable RX
 
     #ifdef MIRLIB_DEBUG
         MIRLIB_DEBUG_PRINT("CC1101 настроен с оригинальными параметрами");
@@ -109,6 +190,28 @@ bool MirlibBase::initializeCC1101() {
     return true;
 }
 
+void MirlibBase::setChannel(uint8_t channel) {
+    m_channel = channel;
+    if (!m_radioConfigured) {
+        return;
+    }
+
+    lockRadio();
+    strobe(0x36); // SIDLE - Exit RX / TX, turn off frequency synthesizer
+    m_radio->writeRegister(0x0A, channel); // CHANNR
+    // Калибровка на новой частоте
+    strobe(0x33); // SCAL - Calibrate frequency synthesizer and turn it off
+    delay(1);
+    noteCalibration();
+    strobe(0x3A); // SFRX - Flush the RX FIFO buffer
+    if (m_rxRing != nullptr) {
+        m_rxRing->clear();
+    }
+    resetStream();
+    strobe(0x34); // SRX - Enable RX
+    unlockRadio();
+}
+
 bool MirlibBase::sendPacketOriginalStyle(PacketData &packet) {
     if (!packet.isValid()) {
         #ifdef MIRLIB_DEBUG
@@ -118,34 +221,73 @@ bool MirlibBase::sendPacketOriginalStyle(PacketData &packet) {
     }
 
     #ifdef MIRLIB_DEBUG
-        MIRLIB_DEBUG_PRINT("Калибровка частотного синтезатора");
+        debugPrintPacket(packet, "Отправка запроса");
     #endif
 
-    // Калибровка частотного синтезатора
-    ELECHOUSE_cc1101.SpiStrobe(0x33); // SCAL - Calibrate frequency synthesizer and turn it off
-    delay(1);
+    return transmitRaw(packet.rawPacket, packet.rawSize);
+}
+
+bool MirlibBase::sendPacketOriginalStyle(const FlashFrame &frame) {
+    if (frame.bytes == nullptr || frame.size < ProtocolConstants::MIN_PACKET_SIZE ||
+        frame.size > ProtocolConstants::MAX_PACKET_SIZE) {
+        #ifdef MIRLIB_DEBUG
+            MIRLIB_DEBUG_PRINT("Невалидный кадр для отправки");
+        #endif
+        return false;
+    }
 
+    // Кадр уже закодирован на этапе компиляции, только копирование из flash
+    uint8_t raw[ProtocolConstants::MAX_PACKET_SIZE];
+    frame.copyTo(raw);
 
-    #ifdef MIRLIB_DEBUG
-        MIRLIB_DEBUG_PRINT("Очистка TX FIFO и выход из RX/TX режима");
-    #endif
+    return transmitRaw(raw, frame.size);
+}
 
-    // Очистка TX FIFO и выход из RX/TX режима
-    ELECHOUSE_cc1101.SpiStrobe(0x3B); // SFTX - Flush the TX FIFO buffer
-    ELECHOUSE_cc1101.SpiStrobe(0x36); // SIDLE - Exit RX / TX, turn off frequency synthesizer
+bool MirlibBase::transmitRaw(uint8_t *raw, size_t rawSize) {
+    const uint32_t requestTime = micros();
 
-    #ifdef MIRLIB_DEBUG
-        MIRLIB_DEBUG_PRINT("Установка мощности передачи 10dB");
-    #endif
+    lockRadio();
+    m_txActive = true;
+
+    // Кадры, принятые до запроса, отбрасываются так же, как содержимое RX FIFO
+    if (m_rxRing != nullptr) {
+        m_rxRing->clear();
+    }
+    resetStream();
 
-    // Установка мощности передачи 10dB
-    ELECHOUSE_cc1101.SpiWriteReg(0x3E, 0xC4); // PATABLE - выставляем мощность 10dB
+    if (m_fastTransmit) {
+        prepareFastTransmit();
+    } else {
+        #ifdef MIRLIB_DEBUG
+            MIRLIB_DEBUG_PRINT("Калибровка частотного синтезатора");
+        #endif
+
+        // Калибровка частотного синтезатора
+        strobe(0x33); // SCAL - Calibrate frequency synthesizer and turn it off
+        delay(1);
+        noteCalibration();
+        m_txStats.calibrations++;
+
+        #ifdef MIRLIB_DEBUG
+            MIRLIB_DEBUG_PRINT("Очистка TX FIFO и выход из RX/TX режима");
+        #endif
+
+        // Очистка TX FIFO и выход из RX/TX режима
+        strobe(0x3B); // SFTX - Flush the TX FIFO buffer
+        strobe(0x36); // SIDLE - Exit RX / TX, turn off frequency synthesizer
+    }
+
+    // Установка мощности передачи (по умолчанию 10dB)
+    writePaTable();
 
+    // В экономном режиме после передачи CC1101 сам вернется в RX, FIFO очищается заранее (чип в IDLE)
+    if (m_leanReceive && m_radio->readStatus(0xFB) != 0) { // RXBYTES
+        strobe(0x3A); // SFRX - Flush the RX FIFO buffer
+    }
 
     #ifdef MIRLIB_DEBUG
-        debugPrintPacket(packet, "Отправка запроса");
         char msg[50];
-        snprintf(msg, sizeof(msg), "Размер пакета: %d байт", packet.rawSize);
+        snprintf(msg, sizeof(msg), "Размер пакета: %d байт", rawSize);
         MIRLIB_DEBUG_PRINT(msg);
     #endif
 
@@ -154,100 +296,781 @@ bool MirlibBase::sendPacketOriginalStyle(PacketData &packet) {
     // txBuffer[0] = packet.rawSize;
     // memcpy(&txBuffer[1], packet.rawPacket, packet.rawSize);
     // // Отправка пакета
-    // ELECHOUSE_cc1101.SendData(txBuffer, packet.rawSize + 1);
+    // m_radio->send(txBuffer, packet.rawSize + 1);
+
+    // Задержка от запроса до передачи кадра радиомодулю (с MIRLIB_DEBUG включает отладочный вывод)
+    const uint32_t latency = micros() - requestTime;
+    m_txStats.packets++;
+    m_txStats.lastLatencyUs = latency;
+    m_txStats.totalLatencyUs += latency;
+    if (latency > m_txStats.maxLatencyUs) {
+        m_txStats.maxLatencyUs = latency;
+    }
+    if (m_packetsSinceCalibration < 0xFFFF) {
+        m_packetsSinceCalibration++;
+    }
 
     // Отправка пакета
-    ELECHOUSE_cc1101.SendData(packet.rawPacket, packet.rawSize);
+    m_radio->send(raw, static_cast<uint8_t>(rawSize));
+    m_txEndTimestamp = micros();
+    m_txActive = false;
 
     #ifdef MIRLIB_DEBUG
         MIRLIB_DEBUG_PRINT("Пакет отправлен");
     #endif
 
     // Очистка RX FIFO и переход в режим приема
-    ELECHOUSE_cc1101.SpiStrobe(0x3A); // SFRX - Flush the RX FIFO buffer
-    ELECHOUSE_cc1101.SpiStrobe(0x34); // SRX - Enable RX
+    if (!m_leanReceive) {
+        strobe(0x3A); // SFRX - Flush the RX FIFO buffer
+        strobe(0x34); // SRX - Enable RX
+    } else if (m_rxRing != nullptr) {
+        // CC1101 вернулся в RX сам, еще при поднятом m_txActive: сигнал кадра, принятого
+        // в этом окне, был проигнорирован
+        drainRadio(this);
+    }
+
+    unlockRadio();
 
     return true;
 }
 
+void MirlibBase::setFastTransmit(bool enable, const CalibrationPolicy &policy) {
+    lockRadio();
+    m_fastTransmit = enable;
+    m_calibrationPolicy = policy;
+    if (m_calibrationPolicy.autoCalibration > 3) {
+        m_calibrationPolicy.autoCalibration = 3;
+    }
+    // До begin() MCSM0 запишет initializeCC1101
+    if (m_radioConfigured) {
+        writeCalibrationMode();
+    }
+    unlockRadio();
+}
+
+void MirlibBase::setTemperature(int8_t celsius) {
+    m_temperature = celsius;
+    if (!m_temperatureKnown) {
+        // Первое значение считается температурой последней калибровки
+        m_calibrationTemperature = celsius;
+        m_temperatureKnown = true;
+    }
+}
+
+void MirlibBase::resetTransmitStats() {
+    memset(&m_txStats, 0, sizeof(m_txStats));
+}
+
+void MirlibBase::prepareFastTransmit() {
+    if (calibrationDue()) {
+        #ifdef MIRLIB_DEBUG
+            MIRLIB_DEBUG_PRINT("Калибровка частотного синтезатора по политике");
+        #endif
+        calibrateSynthesizer();
+        m_txStats.calibrations++;
+        return;
+    }
+
+    // SIDLE прерывает прием чужого кадра и выводит чип из переполнения RX FIFO,
+    // SFTX допустим только в IDLE
+    strobe(0x36); // SIDLE - Exit RX / TX, turn off frequency synthesizer
+    strobe(0x3B); // SFTX - Flush the TX FIFO buffer
+}
+
+void MirlibBase::calibrateSynthesizer() {
+    strobe(0x36); // SIDLE - Exit RX / TX, turn off frequency synthesizer
+    strobe(0x3B); // SFTX - Flush the TX FIFO buffer
+    strobe(0x33); // SCAL - Calibrate frequency synthesizer and turn it off
+
+    // Калибровка занимает ~720 мкс: ожидание IDLE вместо фиксированного delay(1)
+    const uint32_t start = micros();
+    while ((m_radio->readStatus(0xF5) & 0x1F) != 0x01 && micros() - start < 2000) { // MARCSTATE != IDLE
+    }
+
+    noteCalibration();
+}
+
+bool MirlibBase::calibrationDue() const {
+    const CalibrationPolicy &policy = m_calibrationPolicy;
+
+    if (policy.maxPackets != 0 && m_packetsSinceCalibration >= policy.maxPackets) {
+        return true;
+    }
+    if (policy.maxAgeMs != 0 && millis() - m_calibrationTime >= policy.maxAgeMs) {
+        return true;
+    }
+    if (policy.maxTemperatureDelta != 0 && m_temperatureKnown) {
+        const int delta = m_temperature - m_calibrationTemperature;
+        if (delta >= policy.maxTemperatureDelta || -delta >= policy.maxTemperatureDelta) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void MirlibBase::noteCalibration() {
+    m_packetsSinceCalibration = 0;
+    m_calibrationTime = millis();
+    m_calibrationTemperature = m_temperature;
+}
+
+void MirlibBase::writePaTable() {
+    if (m_paTableValid && m_paTableWritten == m_paTable) {
+        return;
+    }
+
+    m_radio->writeRegister(0x3E, m_paTable); // PATABLE
+    m_paTableWritten = m_paTable;
+    m_paTableValid = true;
+    m_txStats.paTableWrites++;
+}
+
+void MirlibBase::setLeanReceive(bool enable) {
+    lockRadio();
+    m_leanReceive = enable;
+    // До begin() MCSM1 запишет initializeCC1101
+    if (m_radioConfigured) {
+        writeReceiveMode();
+        strobe(0x36); // SIDLE - Exit RX / TX, turn off frequency synthesizer
+        strobe(0x3A); // SFRX - Flush the RX FIFO buffer
+        strobe(0x34); // SRX - Enable RX
+    }
+    unlockRadio();
+}
+
+void MirlibBase::resetRadioStats() {
+    memset(&m_radioStats, 0, sizeof(m_radioStats));
+}
+
+void MirlibBase::writeReceiveMode() {
+    // RXOFF_MODE = RX в обоих режимах, TXOFF_MODE: RX (экономный) или IDLE (оригинальный)
+    m_radio->writeRegister(0x17, m_leanReceive ? 0x0F : 0x0C); // MCSM1
+}
+
+void MirlibBase::strobe(uint8_t command) {
+    m_radio->strobe(command);
+    m_radioStats.strobes++;
+}
+
+void MirlibBase::writeCalibrationMode() {
+    // MCSM0 = 0x08 (PO_TIMEOUT 64), FS_AUTOCAL в битах 5:4
+    const uint8_t autoCalibration = m_fastTransmit ? m_calibrationPolicy.autoCalibration : 0;
+    m_radio->writeRegister(0x18, static_cast<uint8_t>(0x08 | (autoCalibration << 4))); // MCSM0
+}
+
 bool MirlibBase::receivePacketOriginalStyle(PacketData &packet, uint32_t timeout) {
-    packet.clear();
+    uint8_t frame[ProtocolConstants::MAX_PACKET_SIZE];
+    PacketView view;
+
+    if (!receiveFrame(frame, view, timeout)) {
+        return false;
+    }
+
+    return view.toPacketData(packet);
+}
 
-    uint32_t startTime = millis();
-    timeout = (timeout == 0) ? m_timeout : timeout;
+bool MirlibBase::receiveFrame(uint8_t *frame, PacketView &view, uint32_t timeout, const PacketFilter *filter,
+                              uint32_t encodingKey, uint32_t firstByteWindow) {
+    ReceiveWait wait;
+    beginReceive(wait, timeout, firstByteWindow);
+    view.reset();
 
     #ifdef MIRLIB_DEBUG
         char msg[100];
-        snprintf(msg, sizeof(msg), "Ожидание пакета (таймаут: %lu мс)", timeout);
+        snprintf(msg, sizeof(msg), "Ожидание пакета (таймаут: %lu мс)", wait.timeout);
         MIRLIB_DEBUG_PRINT(msg);
     #endif
 
-    while (millis() - startTime < timeout) {
-        if (ELECHOUSE_cc1101.CheckReceiveFlag()) {
-            uint8_t buffer[ProtocolConstants::MAX_PACKET_SIZE];
+    ReceiveStatus status;
+    do {
+        status = receiveStep(wait, frame, view, filter, encodingKey, wait.timeout);
+    } while (status == RECEIVE_PENDING);
 
-            const int len = ELECHOUSE_cc1101.ReceiveData(buffer);
-            if (len < 1) {
-                clearFifo();
-                delay(1);
-                continue;
-            }
+    return status == RECEIVE_FRAME;
+}
 
-            if (len > 0 && static_cast<size_t>(len) <= ProtocolConstants::MAX_PACKET_SIZE) {
-                #ifdef MIRLIB_DEBUG
-                    char msg[50];
-                    snprintf(msg, sizeof(msg), "Получен пакет, размер: %d байт", len);
-                    MIRLIB_DEBUG_PRINT(msg);
-                    ProtocolUtils::printHex(buffer, len, "Сырые данные");
-                #endif
+void MirlibBase::beginReceive(ReceiveWait &wait, uint32_t timeout, uint32_t firstByteWindow) {
+    m_receiveAborted = false;
+    m_receiveExtended = false;
 
-                // Разбор пакета
-                if (ProtocolUtils::unpackPacket(buffer, len, packet)) {
-                    #ifdef MIRLIB_DEBUG
-                        MIRLIB_DEBUG_PRINT("Пакет успешно разобран");
-                    #endif
+    wait.startTime = millis();
+    wait.timeout = (timeout == 0) ? m_timeout : timeout;
+    // Окно первого байта: пока кадр не появился в эфире, ожидание ограничено окном
+    wait.firstByteWindow = firstByteWindow < wait.timeout ? firstByteWindow : 0;
+}
 
-                    // Очистка RX FIFO и перезапуск приема
-                    ELECHOUSE_cc1101.SpiStrobe(0x36); // SIDLE - Exit RX / TX, turn off frequency synthesizer
-                    ELECHOUSE_cc1101.SpiStrobe(0x3A); // SFRX - Flush the RX FIFO buffer
-                    ELECHOUSE_cc1101.SpiStrobe(0x3B); // SFTX - Flush the TX FIFO buffer
-                    ELECHOUSE_cc1101.SpiStrobe(0x34); // SRX - Enable RX
+MirlibBase::ReceiveStatus MirlibBase::receiveStep(ReceiveWait &wait, uint8_t *frame, PacketView &view,
+                                                  const PacketFilter *filter, uint32_t encodingKey,
+                                                  uint32_t maxWaitMs) {
+    const uint32_t elapsed = millis() - wait.startTime;
+    if (elapsed >= wait.timeout) {
+        m_receiveElapsedMs = elapsed;
+
+        #ifdef MIRLIB_DEBUG
+            MIRLIB_DEBUG_PRINT("Таймаут приема пакета");
+        #endif
+
+        return RECEIVE_TIMEOUT;
+    }
+
+    uint32_t waitMs = wait.timeout - elapsed;
+    if (wait.firstByteWindow != 0) {
+        if (elapsed >= wait.firstByteWindow || receiveTimerExpired()) {
+            if (!frameInFlight()) {
+                m_receiveAborted = true;
+                m_receiveElapsedMs = elapsed;
 
-                    return true;
-                }
-                #ifdef MIRLIB_DEBUG
-                    MIRLIB_DEBUG_PRINT("Ошибка разбора пакета");
-                #endif
-            } else {
                 #ifdef MIRLIB_DEBUG
-                    char msg[50];
-                    snprintf(msg, sizeof(msg), "Неверный размер пакета: %d", len);
-                    MIRLIB_DEBUG_PRINT(msg);
+                    MIRLIB_DEBUG_PRINT("Кадр не появился в окне первого байта");
                 #endif
+
+                return RECEIVE_TIMEOUT;
+            }
+            // Кадр в эфире: ожидание до полного таймаута
+            wait.firstByteWindow = 0;
+            m_receiveExtended = true;
+        } else {
+            waitMs = wait.firstByteWindow - elapsed;
+            // Завершение приема таймером RX_TIME видно только по MARCSTATE
+            if (m_rxTimerArmed && waitMs > 10) {
+                waitMs = 10;
             }
+        }
+    }
+    if (waitMs > maxWaitMs) {
+        waitMs = maxWaitMs;
+    }
+
+    // При опросе в оригинальном режиме прием перезапускается очисткой FIFO после каждого кадра
+    const bool flushAfterFrame = m_rxRing == nullptr && !m_leanReceive;
+
+    bool unstuffed = false;
+    const int len = m_rxRing != nullptr ? takeQueuedFrame(frame, waitMs, unstuffed) : pollFrame(frame);
+    if (len < 1) {
+        return RECEIVE_PENDING;
+    }
 
-            // Очистка RX FIFO и перезапуск приема при ошибке
-            ELECHOUSE_cc1101.SpiStrobe(0x36); // SIDLE - Exit RX / TX, turn off frequency synthesizer
-            ELECHOUSE_cc1101.SpiStrobe(0x3A); // SFRX - Flush the RX FIFO buffer
-            ELECHOUSE_cc1101.SpiStrobe(0x3B); // SFTX - Flush the TX FIFO buffer
-            ELECHOUSE_cc1101.SpiStrobe(0x34); // SRX - Enable RX
+    // Потоковый прием: байт-стаффинг и CRC проверены, пока кадр был в эфире
+    if (unstuffed) {
+        if (!view.attach(frame, len) ||
+            (filter != nullptr && !filter->matches(view.destAddress(), view.srcAddress(), view.command()))) {
+            view.reset();
+            return RECEIVE_PENDING;
+        }
+        if ((frame[0] & 0x80) != 0) {
+            ProtocolUtils::applyKeystream(frame + ProtocolConstants::HEADER_SIZE, view.dataSize(), encodingKey);
         }
+        view.setMetadata(m_lastReceive);
+        m_receiveElapsedMs = millis() - wait.startTime;
+        return RECEIVE_FRAME;
+    }
 
+    if (static_cast<size_t>(len) <= ProtocolConstants::MAX_PACKET_SIZE) {
+        #ifdef MIRLIB_DEBUG
+            char msg[50];
+            snprintf(msg, sizeof(msg), "Получен пакет, размер: %d байт", len);
+            MIRLIB_DEBUG_PRINT(msg);
+            ProtocolUtils::printHex(frame, len, "Сырые данные");
+        #endif
+
+        // Чужие кадры отбрасываются по заголовку, без снятия стаффинга данных и проверки CRC
+        if (filter != nullptr && !ProtocolUtils::matchHeader(frame, len, *filter)) {
+            #ifdef MIRLIB_DEBUG
+                MIRLIB_DEBUG_PRINT("Пакет не прошел фильтр заголовка, пропуск");
+            #endif
+            if (flushAfterFrame) {
+                clearFifo();
+                delay(1);
+            }
+            return RECEIVE_PENDING;
+        }
+
+        // Разбор пакета на месте: снятие байт-стаффинга и проверка CRC в том же буфере
+        if (view.decode(frame, len, frame, encodingKey)) {
+            #ifdef MIRLIB_DEBUG
+                MIRLIB_DEBUG_PRINT("Пакет успешно разобран");
+            #endif
+
+            // Очистка RX FIFO и перезапуск приема (в режиме прерывания это уже сделал дренаж)
+            if (flushAfterFrame) {
+                clearFifo();
+            }
+
+            view.setMetadata(m_lastReceive);
+            m_receiveElapsedMs = millis() - wait.startTime;
+            return RECEIVE_FRAME;
+        }
+        #ifdef MIRLIB_DEBUG
+            MIRLIB_DEBUG_PRINT("Ошибка разбора пакета");
+        #endif
+    } else {
+        #ifdef MIRLIB_DEBUG
+            char msg[50];
+            snprintf(msg, sizeof(msg), "Неверный размер пакета: %d", len);
+            MIRLIB_DEBUG_PRINT(msg);
+        #endif
+    }
+
+    // Очистка RX FIFO и перезапуск приема при ошибке
+    if (flushAfterFrame) {
+        clearFifo();
         delay(1); // Небольшая задержка для стабильности
     }
+    return RECEIVE_PENDING;
+}
+
+bool MirlibBase::frameInFlight() {
+    if (m_rxRing != nullptr && !m_rxRing->empty()) {
+        return true;
+    }
+
+    lockRadio();
+    const uint8_t packetStatus = m_radio->readStatus(0xF8); // PKTSTATUS
+    const uint8_t rxBytes = m_radio->readStatus(0xFB); // RXBYTES
+    const bool streaming = m_stream != nullptr && m_stream->remaining != 0;
+    unlockRadio();
+
+    // CS (бит 6) - несущая выше порога, SFD (бит 3) - принято синхрослово
+    return (packetStatus & 0x48) != 0 || (rxBytes & 0x7F) != 0 || streaming;
+}
+
+void MirlibBase::armReceiveTimer(uint32_t windowMs) {
+    // RX_TIME n: 1000 мс / 2^(n + 3) при EVENT0 = 0x876B, WOR_RES = 0 (кварц 26 МГц)
+    uint8_t rxTime = 7;
+    for (uint8_t n = 6; n < 7; n--) {
+        if ((1000000UL >> (n + 3)) >= windowMs * 1000UL) {
+            rxTime = n;
+            break;
+        }
+    }
+    if (rxTime == 7) {
+        return;
+    }
+
+    lockRadio();
+    // RX_TIME_QUAL = 0: прием продолжается, если синхрослово найдено
+    m_radio->writeRegister(0x16, rxTime); // MCSM2
+    m_rxTimerArmed = true;
+    unlockRadio();
+}
+
+void MirlibBase::disarmReceiveTimer() {
+    if (!m_rxTimerArmed) {
+        return;
+    }
+
+    lockRadio();
+    m_radio->writeRegister(0x16, 0x07); // MCSM2 - без таймаута RX
+    m_rxTimerArmed = false;
+    if ((m_radio->readStatus(0xF5) & 0x1F) == 0x01) { // MARCSTATE IDLE
+        strobe(0x34); // SRX - Enable RX
+    }
+    unlockRadio();
+}
+
+bool MirlibBase::receiveTimerExpired() {
+    if (!m_rxTimerArmed) {
+        return false;
+    }
+
+    lockRadio();
+    const bool idle = (m_radio->readStatus(0xF5) & 0x1F) == 0x01; // MARCSTATE IDLE
+    unlockRadio();
+    return idle;
+}
+
+int MirlibBase::pollFrame(uint8_t *frame) {
+    uint8_t status[2];
+    int len;
+    if (m_leanReceive) {
+        len = readFifoFrame(frame, status);
+        if (len < 1) {
+            delay(1); // Небольшая задержка для стабильности
+            return len;
+        }
+    } else {
+        if (!m_radio->receiveReady()) {
+            delay(1); // Небольшая задержка для стабильности
+            return 0;
+        }
+
+        len = receiveAndFlush(frame, status);
+        if (len < 1) {
+            clearFifo();
+            delay(1);
+            return 0;
+        }
+    }
+
+    // Без прерывания момент синхрослова неизвестен, отметка - время вычитывания
+    m_lastReceive.timestamp = micros();
+    m_lastReceive.rssi = status[0];
+    m_lastReceive.lqi = status[1];
+    return len;
+}
+
+int MirlibBase::readFifoFrame(uint8_t *frame, uint8_t status[2]) {
+    const uint8_t rxBytes = m_radio->readStatus(0xFB); // RXBYTES
+    if (rxBytes & 0x80) { // RXFIFO_OVERFLOW
+        m_radioStats.overflows++;
+        restartReceive();
+        return 0;
+    }
+
+    // Пока GDO0 поднят, в FIFO принимается кадр: он вычитывается вместе с предыдущими по концу пакета
+    if ((rxBytes & 0x7F) == 0 || (m_radio->readStatus(0xF8) & 0x01) != 0) { // PKTSTATUS, GDO0
+        return 0;
+    }
+
+    const int len = m_radio->readFrame(frame, status);
+    if (len < 1) {
+        restartReceive();
+        return 0;
+    }
+
+    m_radioStats.frames++;
+    return len;
+}
+
+int MirlibBase::receiveAndFlush(uint8_t *frame, uint8_t status[2]) {
+    // Данные в FIFO сверх кадра - начало следующего кадра, receive() их сбросит
+    const uint8_t available = m_radio->readStatus(0xFB) & 0x7F; // RXBYTES
+    const int len = m_radio->receive(frame, status);
+    m_radioStats.strobes += 2; // SFRX и SRX внутри receive()
+
+    if (len < 1) {
+        return 0;
+    }
+
+    m_radioStats.frames++;
+    if (available > len + 3) { // Байт длины, кадр и два байта статуса
+        m_radioStats.missedFrames++;
+    }
+    return len;
+}
+
+void MirlibBase::restartReceive() {
+    m_radioStats.missedFrames++;
+    resetStream();
+    strobe(0x36); // SIDLE - Exit RX / TX, turn off frequency synthesizer
+    strobe(0x3A); // SFRX - Flush the RX FIFO buffer
+    strobe(0x34); // SRX - Enable RX
+}
+
+int MirlibBase::takeQueuedFrame(uint8_t *frame, uint32_t waitMs, bool &unstuffed) {
+    // Получатель регистрируется до проверки очереди, чтобы не потерять уведомление
+    m_rxSignal->prepareWait();
+
+    const RxFrame *queued = m_rxRing->front();
+    if (queued == nullptr) {
+        m_rxSignal->wait(waitMs);
+        queued = m_rxRing->front();
+        if (queued == nullptr) {
+            return 0;
+        }
+    }
+
+    const int len = queued->size;
+    memcpy(frame, queued->bytes, len);
+    unstuffed = (queued->flags & RX_FRAME_UNSTUFFED) != 0;
+    m_lastReceive = queued->metadata;
+    m_rxRing->pop();
+
+    return len;
+}
+
+bool MirlibBase::enableReceiveInterrupt() {
+    if (m_radio == nullptr || m_gdo0Pin < 0) {
+        setError(ERR_RECEIVE_INTERRUPT_UNAVAILABLE);
+        return false;
+    }
+    if (m_rxRing != nullptr) {
+        return true;
+    }
+
+    m_rxRing = new FrameRing<>();
+    m_rxSignal = new RxSignal();
+
+    // Сигнал приема может принадлежать только одному экземпляру на радиомодуль
+    if (!m_rxSignal->begin(drainRadio, this) || !m_radio->attachReceiveSignal(onReceiveSignal, this)) {
+        releaseReceiveQueue();
+        setError(ERR_RECEIVE_INTERRUPT_UNAVAILABLE);
+        return false;
+    }
 
     #ifdef MIRLIB_DEBUG
-        MIRLIB_DEBUG_PRINT("Таймаут приема пакета");
+        MIRLIB_DEBUG_PRINT("Прием по прерыванию GDO0 включен");
     #endif
 
-    return false;
+    return true;
+}
+
+void MirlibBase::disableReceiveInterrupt() {
+    if (m_rxRing == nullptr) {
+        return;
+    }
+
+    disableStreamingReceive();
+    m_radio->detachReceiveSignal();
+    releaseReceiveQueue();
+}
+
+bool MirlibBase::enableStreamingReceive(int gdo2Pin) {
+    if (m_stream != nullptr) {
+        return true;
+    }
+    const bool interruptEnabled = isReceiveInterruptEnabled();
+    if (!enableReceiveInterrupt()) {
+        return false;
+    }
+
+    lockRadio();
+    m_stream = new ReceiveStream();
+    if (!m_radio->attachFifoSignal(gdo2Pin, onFifoSignal, this)) {
+        delete m_stream;
+        m_stream = nullptr;
+        unlockRadio();
+        if (!interruptEnabled) {
+            disableReceiveInterrupt();
+        }
+        setError(ERR_RECEIVE_INTERRUPT_UNAVAILABLE);
+        return false;
+    }
+
+    // Прием перезапускается с пустым FIFO, чтобы первый байт был длиной пакета
+    m_radio->writeRegister(0x00, 0x00); // IOCFG2 - RX FIFO не ниже порога
+    m_radio->writeRegister(0x03, 0x41); // FIFOTHR - порог RX FIFO 8 байт
+    strobe(0x36); // SIDLE - Exit RX / TX, turn off frequency synthesizer
+    strobe(0x3A); // SFRX - Flush the RX FIFO buffer
+    strobe(0x34); // SRX - Enable RX
+    unlockRadio();
+
+    #ifdef MIRLIB_DEBUG
+        MIRLIB_DEBUG_PRINT("Потоковый прием по порогу RX FIFO включен");
+    #endif
+
+    return true;
+}
+
+void MirlibBase::disableStreamingReceive() {
+    if (m_stream == nullptr) {
+        return;
+    }
+
+    lockRadio();
+    m_radio->detachFifoSignal();
+    delete m_stream;
+    m_stream = nullptr;
+
+    // Настройки оригинального кода, недочитанный пакет сбрасывается
+    m_radio->writeRegister(0x00, 0x0D); // IOCFG2
+    m_radio->writeRegister(0x03, 0x4F); // FIFOTHR
+    strobe(0x36); // SIDLE - Exit RX / TX, turn off frequency synthesizer
+    strobe(0x3A); // SFRX - Flush the RX FIFO buffer
+    strobe(0x34); // SRX - Enable RX
+    unlockRadio();
+}
+
+void MirlibBase::releaseReceiveQueue() {
+    if (m_rxSignal != nullptr) {
+        m_rxSignal->end();
+    }
+    delete m_rxSignal;
+    m_rxSignal = nullptr;
+    delete m_rxRing;
+    m_rxRing = nullptr;
+}
+
+void MIRLIB_ISR_ATTR MirlibBase::onReceiveSignal(void *context, bool frameStart) {
+    MirlibBase *const owner = static_cast<MirlibBase *>(context);
+    if (owner->m_txActive) {
+        return;
+    }
+
+    if (frameStart) {
+        owner->m_syncTimestamp = micros();
+    } else {
+        owner->m_rxSignal->requestDrainFromIsr();
+    }
+}
+
+void MIRLIB_ISR_ATTR MirlibBase::onFifoSignal(void *context, bool asserted) {
+    MirlibBase *const owner = static_cast<MirlibBase *>(context);
+    if (asserted && !owner->m_txActive) {
+        owner->m_rxSignal->requestDrainFromIsr();
+    }
+}
+
+void MirlibBase::drainRadio(void *context) {
+    MirlibBase *const self = static_cast<MirlibBase *>(context);
+
+    if (self->m_stream != nullptr) {
+        self->streamFifo();
+        return;
+    }
+
+    if (self->m_leanReceive) {
+        // FIFO не очищается, в нем может накопиться несколько кадров
+        for (;;) {
+            RxFrame &slot = self->m_rxRing->producerSlot();
+            uint8_t status[2];
+            const int len = self->readFifoFrame(slot.bytes, status);
+            if (len < 1) {
+                return;
+            }
+
+            slot.size = static_cast<uint8_t>(len);
+            slot.flags = 0;
+            slot.metadata.timestamp = self->m_syncTimestamp;
+            slot.metadata.rssi = status[0];
+            slot.metadata.lqi = status[1];
+            if (self->m_rxRing->commit()) {
+                self->m_rxSignal->notify();
+            }
+        }
+    }
+
+    // При переполнении очереди кадр все равно вычитывается (в резервный слот) и отбрасывается
+    RxFrame &slot = self->m_rxRing->producerSlot();
+
+    // receive() сам очищает RX FIFO и возвращает CC1101 в режим приема
+    uint8_t status[2];
+    const int len = self->receiveAndFlush(slot.bytes, status);
+    if (len < 1 || static_cast<size_t>(len) > ProtocolConstants::MAX_PACKET_SIZE) {
+        return;
+    }
+
+    slot.size = static_cast<uint8_t>(len);
+    slot.flags = 0;
+    slot.metadata.timestamp = self->m_syncTimestamp;
+    slot.metadata.rssi = status[0];
+    slot.metadata.lqi = status[1];
+    if (self->m_rxRing->commit()) {
+        self->m_rxSignal->notify();
+    }
+}
+
+void MirlibBase::streamFifo() {
+    ReceiveStream &stream = *m_stream;
+    uint8_t chunk[ProtocolConstants::MAX_PACKET_SIZE];
+
+    for (;;) {
+        // RXBYTES во время приема читается до совпадения двух значений подряд (errata)
+        uint8_t rxBytes = m_radio->readStatus(0xFB); // RXBYTES
+        for (uint8_t previous = rxBytes ^ 0xFF; rxBytes != previous;) {
+            previous = rxBytes;
+            rxBytes = m_radio->readStatus(0xFB);
+        }
+
+        if (rxBytes & 0x80) { // RXFIFO_OVERFLOW
+            m_radioStats.overflows++;
+            restartReceive();
+            return;
+        }
+
+        // Пока идет прием (GDO0 поднят), последний байт FIFO не читается
+        uint8_t available = rxBytes & 0x7F;
+        if (available != 0 && (m_radio->readStatus(0xF8) & 0x01) != 0) { // PKTSTATUS, GDO0
+            available--;
+        }
+        if (available == 0) {
+            return;
+        }
+
+        // Начало пакета: байт длины
+        if (stream.remaining == 0) {
+            uint8_t length = 0;
+            m_radio->readFifo(&length, 1);
+            if (length == 0 || length > ProtocolConstants::MAX_PACKET_SIZE) {
+                restartReceive();
+                return;
+            }
+            // За кадром следуют два байта статуса (APPEND_STATUS)
+            stream.remaining = length + 2;
+            stream.length = length;
+            stream.done = false;
+            stream.valid = false;
+            stream.metadata.timestamp = m_syncTimestamp;
+            stream.unstuffer.reset();
+            continue;
+        }
+
+        const uint8_t count = available < stream.remaining ? available : stream.remaining;
+        m_radio->readFifo(chunk, count);
+
+        // Байты кадра - в распаковщик, байты статуса - в метаданные
+        const uint8_t offset = stream.length + 2 - stream.remaining;
+        uint8_t frameBytes = 0;
+        if (offset < stream.length) {
+            frameBytes = stream.length - offset < count ? stream.length - offset : count;
+        }
+        for (uint8_t i = frameBytes; i < count; i++) {
+            if (offset + i == stream.length) {
+                stream.metadata.rssi = chunk[i];
+            } else {
+                stream.metadata.lqi = chunk[i];
+            }
+        }
+        stream.remaining -= count;
+
+        if (!stream.done && frameBytes != 0) {
+            size_t consumed = 0;
+            if (stream.unstuffer.feed(chunk, frameBytes, consumed) != FrameUnstuffer::RESULT_PENDING) {
+                stream.done = true;
+                stream.valid = stream.unstuffer.result() == FrameUnstuffer::RESULT_VALID;
+            }
+        }
+
+        if (stream.remaining == 0) {
+            m_radioStats.frames++;
+            if (stream.valid) {
+                RxFrame &slot = m_rxRing->producerSlot();
+                memcpy(slot.bytes, stream.unstuffer.frame(), stream.unstuffer.frameSize());
+                slot.size = static_cast<uint8_t>(stream.unstuffer.frameSize());
+                slot.flags = RX_FRAME_UNSTUFFED;
+                slot.metadata = stream.metadata;
+                if (m_rxRing->commit()) {
+                    m_rxSignal->notify();
+                }
+            }
+        }
+    }
+}
+
+void MirlibBase::resetStream() {
+    if (m_stream != nullptr) {
+        m_stream->remaining = 0;
+        m_stream->done = false;
+        m_stream->valid = false;
+        m_stream->unstuffer.reset();
+    }
+}
+
+void MirlibBase::lockRadio() {
+    if (m_rxSignal != nullptr) {
+        m_rxSignal->lockRadio();
+    }
+}
+
+void MirlibBase::unlockRadio() {
+    if (m_rxSignal != nullptr) {
+        m_rxSignal->unlockRadio();
+    }
 }
 
 void MirlibBase::clearFifo() {
-    ELECHOUSE_cc1101.SpiStrobe(0x36); // SIDLE - Exit RX / TX, turn off frequency synthesizer
-    ELECHOUSE_cc1101.SpiStrobe(0x3A); // SFRX - Flush the RX FIFO buffer
-    ELECHOUSE_cc1101.SpiStrobe(0x3B); // SFTX - Flush the TX FIFO buffer
-    ELECHOUSE_cc1101.SpiStrobe(0x34); // SRX - Enable RX
+    lockRadio();
+    // Данные, пришедшие после вычитывания кадра, теряются
+    if (m_radio->readStatus(0xFB) != 0) { // RXBYTES
+        m_radioStats.missedFrames++;
+    }
+    resetStream();
+    strobe(0x36); // SIDLE - Exit RX / TX, turn off frequency synthesizer
+    strobe(0x3A); // SFRX - Flush the RX FIFO buffer
+    strobe(0x3B); // SFTX - Flush the TX FIFO buffer
+    strobe(0x34); // SRX - Enable RX
+    unlockRadio();
 }
 
 void MirlibBase::setError(const ErrorCode code) {
@@ -276,14 +1099,16 @@ void MirlibBase::printCC1101Status() {
     MIRLIB_DEBUG_PRINT("=== Статус CC1101 ===");
 
     // Чтение регистра статуса
-    uint8_t status = ELECHOUSE_cc1101.SpiReadStatus(0xF5); // MARCSTATE
+    lockRadio();
+    uint8_t status = m_radio->readStatus(0xF5); // MARCSTATE
     char msg[50];
     snprintf(msg, sizeof(msg), "MARCSTATE: 0x%02X", status);
     debugPrint(msg);
 
     // Проверка FIFO
-    uint8_t rxBytes = ELECHOUSE_cc1101.SpiReadStatus(0xFB); // RXBYTES
-    uint8_t txBytes = ELECHOUSE_cc1101.SpiReadStatus(0xFA); // TXBYTES
+    uint8_t rxBytes = m_radio->readStatus(0xFB); // RXBYTES
+    uint8_t txBytes = m_radio->readStatus(0xFA); // TXBYTES
+    unlockRadio();
     snprintf(msg, sizeof(msg), "RX FIFO: %d байт, TX FIFO: %d байт", rxBytes & 0x7F, txBytes & 0x7F);
     debugPrint(msg);
 
@@ -295,7 +1120,12 @@ void MirlibBase::resetCC1101() {
         MIRLIB_DEBUG_PRINT("Выполняется сброс CC1101...");
     #endif
 
+    lockRadio();
     initializeCC1101();
+    if (m_rxRing != nullptr) {
+        m_rxRing->clear();
+    }
+    unlockRadio();
 
     #ifdef MIRLIB_DEBUG
         MIRLIB_DEBUG_PRINT("Сброс CC1101 завершен");
@@ -2,11 +2,16 @@
 #define MIRLIB_BASE_H
 
 #include <Arduino.h>
-#include <ELECHOUSE_CC1101_SRC_DRV.h>
 
 #include "MirlibErrors.h"
 #include "ProtocolTypes.h"
 #include "ProtocolUtils.h"
+#include "PacketView.h"
+#include "PacketFilter.h"
+#include "StaticFrame.h"
+#include "FrameRing.h"
+#include "RxSignal.h"
+#include "RadioBackend.h"
 
 /**
  * @brief Базовый класс для Mirlib с общей функциональностью
@@ -23,16 +28,63 @@ public:
         NEW_GENERATION ///< Новое поколение (Role >= 0x32, ID: 0x09,0x0E,0x0F,0x10,0x20,0x21,0x22)
     };
 
+    /**
+     * @brief Политика калибровки частотного синтезатора в режиме быстрой передачи
+     * Калибровка выполняется перед передачей, если сработало любое из включенных условий
+     */
+    struct CalibrationPolicy {
+        uint8_t autoCalibration; ///< FS_AUTOCAL в MCSM0: 0 - только по политике, 1 - IDLE->RX/TX, 2 - RX/TX->IDLE, 3 - каждый 4-й переход IDLE->RX/TX
+        uint16_t maxPackets; ///< Калибровать после N переданных пакетов (0 - не учитывать)
+        uint32_t maxAgeMs; ///< Калибровать, если с прошлой калибровки прошло больше T мс (0 - не учитывать)
+        uint8_t maxTemperatureDelta; ///< Калибровать при изменении температуры (setTemperature) на N градусов (0 - не учитывать)
+
+        /**
+         * @brief Конструктор (калибровка раз в 100 пакетов, 60 с или 5 градусов)
+         */
+        CalibrationPolicy() : autoCalibration(0), maxPackets(100), maxAgeMs(60000), maxTemperatureDelta(5) {
+        }
+    };
+
+    /**
+     * @brief Статистика передачи
+     * Задержка - время от запроса передачи до передачи кадра радиомодулю (запись TX FIFO и STX),
+     * включая ожидание захвата радио, калибровку и запись PATABLE
+     */
+    struct TransmitStats {
+        uint32_t packets; ///< Переданные пакеты
+        uint32_t calibrations; ///< Калибровки синтезатора (SCAL) перед передачей
+        uint32_t paTableWrites; ///< Записи PATABLE
+        uint32_t lastLatencyUs; ///< Задержка последней передачи
+        uint32_t maxLatencyUs; ///< Максимальная задержка
+        uint32_t totalLatencyUs; ///< Сумма задержек (для среднего)
+
+        /**
+         * @brief Средняя задержка передачи в мкс
+         */
+        uint32_t averageLatencyUs() const { return packets != 0 ? totalLatencyUs / packets : 0; }
+    };
+
+    /**
+     * @brief Статистика работы с радиомодулем
+     */
+    struct RadioStats {
+        uint32_t strobes; ///< Стробы, выданные библиотекой (включая SFRX и SRX внутри receive() радиомодуля, без STX передачи)
+        uint32_t frames; ///< Кадры, вычитанные из RX FIFO
+        uint32_t overflows; ///< Переполнения RX FIFO
+        uint32_t missedFrames; ///< Очистки RX FIFO, при которых в нем были данные (кадры, потерянные при перезапуске приема)
+    };
+
     /**
      * @brief Конструктор
      * @param deviceAddress Адрес устройства
+     * @param radio Радиомодуль (nullptr - ElechouseRadio, глобальный ELECHOUSE_cc1101); должен жить не меньше объекта
      */
-    explicit MirlibBase(uint16_t deviceAddress = 0xFFFF);
+    explicit MirlibBase(uint16_t deviceAddress = 0xFFFF, RadioBackend *radio = nullptr);
 
     /**
      * @brief Деструктор
      */
-    virtual ~MirlibBase() = default;
+    virtual ~MirlibBase();
 
     /**
      * @brief Инициализация протокола и CC1101 с оригинальными настройками
@@ -45,7 +97,19 @@ public:
      * @brief Установить пароль устройства
      * @param password 4-байтный пароль
      */
-    void setPassword(uint32_t password) { m_password = password; }
+    void setPassword(uint32_t password) {
+        m_password = password;
+        onAddressingChanged();
+    }
+
+    /**
+     * @brief Установить адрес устройства
+     * @param deviceAddress Адрес устройства
+     */
+    void setDeviceAddress(uint16_t deviceAddress) {
+        m_deviceAddress = deviceAddress;
+        onAddressingChanged();
+    }
 
     /**
      * @brief Установить статус устройства
@@ -71,12 +135,151 @@ public:
      */
     void setTimeout(uint32_t timeout) { m_timeout = timeout; }
 
+    /**
+     * @brief Получить таймаут приема в миллисекундах
+     */
+    uint32_t getTimeout() const { return m_timeout; }
+
+    /**
+     * @brief Установить канал CC1101 (CHANNR, по умолчанию 0x16)
+     * Частота канала - база плюс channel * шаг канала (MDMCFG0). После смены канала
+     * синтезатор калибруется, прием перезапускается
+     * @param channel Номер канала
+     */
+    void setChannel(uint8_t channel);
+
+    /**
+     * @brief Получить канал CC1101
+     */
+    uint8_t getChannel() const { return m_channel; }
+
     /**
      * @brief Получить последнее сообщение об ошибке
      * @return Строка сообщения об ошибке
      */
     const ErrorCode getLastError() const { return m_lastError; }
 
+    /**
+     * @brief Включить прием по прерыванию GDO0 (после begin)
+     * Обработчик прерывания вычитывает FIFO в очередь кадров с отметкой времени,
+     * прием ждет уведомления вместо опроса CheckReceiveFlag (FreeRTOS task notify на ESP32).
+     * Прерывание может принадлежать только одному экземпляру.
+     * Размер очереди - MIRLIB_RX_RING_SIZE кадров.
+     * @return true если прерывание подключено
+     */
+    bool enableReceiveInterrupt();
+
+    /**
+     * @brief Отключить прием по прерыванию и вернуться к опросу
+     */
+    void disableReceiveInterrupt();
+
+    /**
+     * @brief Проверить, включен ли прием по прерыванию
+     */
+    bool isReceiveInterruptEnabled() const { return m_rxRing != nullptr; }
+
+    /**
+     * @brief Включить потоковый прием по порогу RX FIFO (GDO2)
+     * IOCFG2 = 0x00, порог RX FIFO 8 байт (FIFOTHR = 0x41). По сигналу GDO2 байты вычитываются из FIFO
+     * и сразу проходят снятие байт-стаффинга и CRC (FrameUnstuffer), пока кадр еще в эфире;
+     * к концу пакета кадр уже проверен. FIFO не очищается между кадрами.
+     * Включает прием по прерыванию, если он еще не включен
+     * @param gdo2Pin Пин GDO2
+     * @return true если сигнал GDO2 подключен
+     */
+    bool enableStreamingReceive(int gdo2Pin);
+
+    /**
+     * @brief Отключить потоковый прием (прием по прерыванию остается включенным)
+     */
+    void disableStreamingReceive();
+
+    /**
+     * @brief Проверить, включен ли потоковый прием
+     */
+    bool isStreamingReceiveEnabled() const { return m_stream != nullptr; }
+
+    /**
+     * @brief Число кадров, отброшенных из-за переполнения очереди приема
+     */
+    uint16_t getDroppedFrameCount() const { return m_rxRing != nullptr ? m_rxRing->dropped() : 0; }
+
+    /**
+     * @brief Время начала последнего принятого кадра (micros() по фронту GDO0 на синхрослове)
+     * В режиме опроса - время вычитывания кадра из FIFO
+     */
+    uint32_t getLastReceiveTimestamp() const { return m_lastReceive.timestamp; }
+
+    /**
+     * @brief Метаданные последнего принятого кадра: RSSI, LQI и отметка времени
+     * RSSI и LQI передаются CC1101 после кадра (PKTCTRL1.APPEND_STATUS) и вычитываются
+     * вместе с ним. В режиме опроса отметка времени - момент вычитывания кадра
+     */
+    const RxMetadata &getLastReceiveMetadata() const { return m_lastReceive; }
+
+    /**
+     * @brief Включить быструю передачу
+     * Перед пакетом выполняются только SIDLE и SFTX, без SCAL и delay(1): синтезатор калибруется
+     * по политике (и/или самим CC1101 через FS_AUTOCAL), окончание калибровки определяется по MARCSTATE
+     * @param enable true - быстрая передача, false - последовательность оригинального кода
+     * @param policy Политика калибровки
+     */
+    void setFastTransmit(bool enable, const CalibrationPolicy &policy = CalibrationPolicy());
+
+    /**
+     * @brief Проверить, включена ли быстрая передача
+     */
+    bool isFastTransmitEnabled() const { return m_fastTransmit; }
+
+    /**
+     * @brief Сообщить текущую температуру для политики калибровки
+     * Источник выбирает приложение (например, temperatureRead() на ESP32 или внешний датчик)
+     * @param celsius Температура в градусах Цельсия
+     */
+    void setTemperature(int8_t celsius);
+
+    /**
+     * @brief Установить мощность передачи
+     * Регистр записывается перед следующей передачей, только если значение изменилось
+     * @param paTable Значение PATABLE (по умолчанию 0xC4 - 10 дБм)
+     */
+    void setTransmitPower(uint8_t paTable) { m_paTable = paTable; }
+
+    /**
+     * @brief Статистика передачи (число пакетов, калибровок и задержка до эфира)
+     */
+    const TransmitStats &getTransmitStats() const { return m_txStats; }
+
+    /**
+     * @brief Сбросить статистику передачи
+     */
+    void resetTransmitStats();
+
+    /**
+     * @brief Включить экономный перезапуск приема
+     * MCSM1 = 0x0F: после передачи и после приема пакета CC1101 сам остается в RX. Кадры вычитываются
+     * из FIFO по одному без SFRX/SRX, FIFO очищается только при переполнении (RXBYTES) или ошибке длины,
+     * поэтому кадр, пришедший сразу за предыдущим, не теряется
+     * @param enable true - экономный режим, false - перезапуск приема оригинального кода
+     */
+    void setLeanReceive(bool enable);
+
+    /**
+     * @brief Проверить, включен ли экономный перезапуск приема
+     */
+    bool isLeanReceiveEnabled() const { return m_leanReceive; }
+
+    /**
+     * @brief Статистика работы с радиомодулем (стробы, переполнения, потерянные кадры)
+     */
+    const RadioStats &getRadioStats() const { return m_radioStats; }
+
+    /**
+     * @brief Сбросить статистику работы с радиомодулем
+     */
+    void resetRadioStats();
+
     /**
      * @brief Вывести статус CC1101 (для отладки)
      */
@@ -94,6 +297,36 @@ protected:
     uint32_t m_timeout;
     Generation m_generation;
     ErrorCode m_lastError;
+    RadioBackend *m_radio;
+    int m_gdo0Pin;
+    bool m_receiveAborted; ///< Последний receiveFrame прерван по окну первого байта
+    bool m_receiveExtended; ///< В последнем receiveFrame к концу окна кадр был в эфире, ожидание продлено
+    uint32_t m_receiveElapsedMs; ///< Время ожидания в последнем receiveFrame
+    uint32_t m_txEndTimestamp; ///< micros() по окончании передачи последнего кадра
+
+    /**
+     * @brief Результат шага приема
+     */
+    enum ReceiveStatus {
+        RECEIVE_PENDING, ///< Кадра еще нет
+        RECEIVE_FRAME, ///< Кадр получен
+        RECEIVE_TIMEOUT ///< Таймаут или ранний выход по окну первого байта (m_receiveAborted)
+    };
+
+    /**
+     * @brief Ожидание кадра, разбитое на шаги (receiveFrame или прием без блокировки)
+     */
+    struct ReceiveWait {
+        uint32_t startTime;
+        uint32_t timeout;
+        uint32_t firstByteWindow; ///< 0 - окно закрыто или не задано
+    };
+
+    /**
+     * @brief Вызывается при смене пароля или адреса устройства (сброс производных данных)
+     */
+    virtual void onAddressingChanged() {
+    }
 
     /**
      * @brief Инициализация CC1101 с оригинальными настройками rfSettings
@@ -109,15 +342,83 @@ protected:
      */
     bool sendPacketOriginalStyle(PacketData &packet);
 
+    /**
+     * @brief Отправить готовый кадр, собранный на этапе компиляции (StaticRequestFrame)
+     * Кодирование и стаффинг во время выполнения не выполняются
+     * @param frame Кадр во flash
+     * @return true если отправлен успешно
+     */
+    bool sendPacketOriginalStyle(const FlashFrame &frame);
+
+    /**
+     * @brief Передать закодированный кадр последовательностью команд CC1101 оригинального кода
+     * @param raw Кадр с байт-стаффингом (в ОЗУ)
+     * @param rawSize Размер кадра
+     * @return true если отправлен успешно
+     */
+    bool transmitRaw(uint8_t *raw, size_t rawSize);
+
     /**
      * @brief Получить пакет в стиле оригинального кода
-     * Использует CheckReceiveFlag и обработку как в исходном проекте
+     * Использует CheckReceiveFlag и обработку как в исходном проекте.
+     * rawPacket содержит кадр в том виде, в каком он передается в эфир (проходит isValid)
      * @param packet Буфер для полученного пакета
      * @param timeout Таймаут в мс
      * @return true если пакет получен
      */
     bool receivePacketOriginalStyle(PacketData &packet, uint32_t timeout = 0);
 
+    /**
+     * @brief Получить кадр без создания PacketData
+     * Кадр разбирается на месте в буфере приема, view указывает на этот буфер
+     * @param frame Буфер приема (не менее MAX_PACKET_SIZE байт), должен жить не меньше view
+     * @param view Представление полученного кадра (выход)
+     * @param timeout Таймаут в мс
+     * @param filter Фильтр заголовка (nullptr - принимать все); несовпадающие кадры пропускаются до таймаута
+     * @param encodingKey Ключ для кадров с кодированием данных (params.encoding)
+     * @param firstByteWindow Окно первого байта в мс (0 - ждать весь таймаут): если к его концу
+     *        (или по таймеру RX_TIME) в эфире нет кадра (синхрослово, несущая, байты в FIFO), ожидание прерывается
+     * @return true если кадр получен и прошел проверку CRC
+     */
+    bool receiveFrame(uint8_t *frame, PacketView &view, uint32_t timeout = 0,
+                      const PacketFilter *filter = nullptr, uint32_t encodingKey = 0, uint32_t firstByteWindow = 0);
+
+    /**
+     * @brief Начать ожидание кадра (параметры как у receiveFrame)
+     */
+    void beginReceive(ReceiveWait &wait, uint32_t timeout = 0, uint32_t firstByteWindow = 0);
+
+    /**
+     * @brief Шаг ожидания кадра: взять кадр из очереди или FIFO, отфильтровать и разобрать
+     * @param wait Ожидание (beginReceive)
+     * @param frame Буфер кадра (не менее MAX_PACKET_SIZE байт)
+     * @param view Представление кадра (выход)
+     * @param filter Фильтр заголовка (nullptr - принимать все)
+     * @param encodingKey Ключ для кадров с кодированием данных
+     * @param maxWaitMs Наибольшее ожидание уведомления в шаге (0 - только проверить очередь)
+     * @return RECEIVE_PENDING, пока кадра нет и таймаут не истек
+     */
+    ReceiveStatus receiveStep(ReceiveWait &wait, uint8_t *frame, PacketView &view,
+                              const PacketFilter *filter, uint32_t encodingKey, uint32_t maxWaitMs);
+
+    /**
+     * @brief Проверить, принимается ли кадр: синхрослово или несущая (PKTSTATUS), байты в FIFO или очереди
+     */
+    bool frameInFlight();
+
+    /**
+     * @brief Завершать RX аппаратно (MCSM2 RX_TIME), если синхрослово не пришло за окно
+     * Таймер запускается при входе в RX, поэтому вызывается до передачи запроса.
+     * Выбирается наименьший RX_TIME не короче окна; окна длиннее 125 мс таймер не покрывает
+     * @param windowMs Окно первого байта в мс
+     */
+    void armReceiveTimer(uint32_t windowMs);
+
+    /**
+     * @brief Отключить таймер RX_TIME и вернуть CC1101 в RX, если он завершил прием
+     */
+    void disarmReceiveTimer();
+
     /**
      * @brief Установить последнее сообщение об ошибке
      * @param error Сообщение об ошибке
@@ -137,6 +438,163 @@ protected:
      */
     void debugPrintPacket(const PacketData &packet, const char *title);
     void clearFifo();
+
+private:
+    struct ReceiveStream;
+
+    FrameRing<> *m_rxRing; ///< Очередь кадров из прерывания (nullptr - режим опроса)
+    RxSignal *m_rxSignal;
+    volatile bool m_txActive; ///< Идет собственная передача, фронты GDO0 не относятся к приему
+    volatile uint32_t m_syncTimestamp;
+    RxMetadata m_lastReceive; ///< Метаданные последнего кадра, выданного приемом
+
+    bool m_radioConfigured; ///< initializeCC1101 выполнен, регистры можно писать
+    bool m_fastTransmit;
+    CalibrationPolicy m_calibrationPolicy;
+    uint16_t m_packetsSinceCalibration;
+    uint32_t m_calibrationTime; ///< millis() последней калибровки
+    int8_t m_temperature;
+    int8_t m_calibrationTemperature; ///< Температура на момент последней калибровки
+    bool m_temperatureKnown;
+    uint8_t m_paTable; ///< Требуемое значение PATABLE
+    uint8_t m_paTableWritten; ///< Последнее записанное в CC1101 значение PATABLE
+    bool m_paTableValid; ///< m_paTableWritten соответствует CC1101 (сбрасывается при SRES)
+    TransmitStats m_txStats;
+    bool m_leanReceive;
+    RadioStats m_radioStats;
+    ReceiveStream *m_stream; ///< Состояние потокового приема (nullptr - кадр вычитывается целиком)
+    bool m_rxTimerArmed; ///< MCSM2 RX_TIME включен на время ожидания ответа
+    uint8_t m_channel; ///< CHANNR
+
+    /**
+     * @brief Обработчик сигнала приема радиомодуля (контекст прерывания)
+     * @param context Экземпляр MirlibBase
+     * @param frameStart true - синхрослово, false - конец пакета
+     */
+    static void onReceiveSignal(void *context, bool frameStart);
+
+    /**
+     * @brief Обработчик порога RX FIFO (контекст прерывания)
+     * @param context Экземпляр MirlibBase
+     * @param asserted true - FIFO заполнен до порога
+     */
+    static void onFifoSignal(void *context, bool asserted);
+
+    /**
+     * @brief Вычитать кадр из FIFO в очередь (вызывается с захваченным радио)
+     * @param context Экземпляр MirlibBase
+     */
+    static void drainRadio(void *context);
+
+    /**
+     * @brief Вычитать доступные байты FIFO в распаковщик, готовые кадры - в очередь (потоковый прием)
+     */
+    void streamFifo();
+
+    /**
+     * @brief Сбросить разбор текущего пакета (после очистки RX FIFO)
+     */
+    void resetStream();
+
+    /**
+     * @brief Проверить, завершил ли таймер RX_TIME прием (CC1101 в IDLE)
+     */
+    bool receiveTimerExpired();
+
+    /**
+     * @brief Получить кадр опросом CheckReceiveFlag (метаданные - в m_lastReceive)
+     * @param frame Буфер кадра
+     * @return Размер кадра, 0 если кадра нет
+     */
+    int pollFrame(uint8_t *frame);
+
+    /**
+     * @brief Получить кадр из очереди прерывания, ожидая уведомления (метаданные - в m_lastReceive)
+     * @param frame Буфер кадра
+     * @param waitMs Максимальное время ожидания в мс
+     * @param unstuffed true если кадр уже распакован и проверен по CRC при приеме (выход)
+     * @return Размер кадра, 0 если кадра нет
+     */
+    int takeQueuedFrame(uint8_t *frame, uint32_t waitMs, bool &unstuffed);
+
+    /**
+     * @brief Подготовить CC1101 к быстрой передаче (вызывается с захваченным радио)
+     * Калибрует синтезатор, если этого требует политика, и выводит чип из состояний переполнения FIFO
+     */
+    void prepareFastTransmit();
+
+    /**
+     * @brief Откалибровать синтезатор: SIDLE, SCAL и ожидание IDLE (вызывается с захваченным радио)
+     */
+    void calibrateSynthesizer();
+
+    /**
+     * @brief Проверить, требует ли политика калибровки
+     */
+    bool calibrationDue() const;
+
+    /**
+     * @brief Отметить выполненную калибровку
+     */
+    void noteCalibration();
+
+    /**
+     * @brief Записать PATABLE, если требуемое значение отличается от записанного
+     */
+    void writePaTable();
+
+    /**
+     * @brief Записать MCSM0 с FS_AUTOCAL текущего режима передачи
+     */
+    void writeCalibrationMode();
+
+    /**
+     * @brief Записать MCSM1 (RXOFF/TXOFF) текущего режима приема
+     */
+    void writeReceiveMode();
+
+    /**
+     * @brief Выдать строб CC1101 с учетом в статистике
+     * @param command Строб
+     */
+    void strobe(uint8_t command);
+
+    /**
+     * @brief Вычитать следующий полный кадр из FIFO в экономном режиме
+     * При переполнении или ошибке длины FIFO очищается и прием перезапускается
+     * @param frame Буфер кадра
+     * @param status Байты статуса после кадра: RSSI, LQI
+     * @return Размер кадра, 0 если полного кадра нет
+     */
+    int readFifoFrame(uint8_t *frame, uint8_t status[2]);
+
+    /**
+     * @brief Вычитать кадр через receive() радиомодуля (очищает FIFO и перезапускает прием)
+     * @param frame Буфер кадра
+     * @param status Байты статуса после кадра: RSSI, LQI
+     * @return Размер кадра, 0 если кадра нет
+     */
+    int receiveAndFlush(uint8_t *frame, uint8_t status[2]);
+
+    /**
+     * @brief Очистить RX FIFO и перезапустить прием (экономный режим)
+     */
+    void restartReceive();
+
+    /**
+     * @brief Освободить очередь и сигнал приема по прерыванию
+     */
+    void releaseReceiveQueue();
+
+    /**
+     * @brief Захватить радио для обмена по SPI (исключает дренаж из прерывания)
+     */
+    void lockRadio();
+
+    /**
+     * @brief Освободить радио
+     */
+    void unlockRadio();
 };
 
 #endif // MIRLIB_BASE_H
\ No newline at end of file
@@ -1,7 +1,22 @@
 #include "MirlibClient.h"
 #include "MirlibDebug.h"
 
-MirlibClient::MirlibClient(uint16_t deviceAddress) : MirlibBase(deviceAddress) {
+static_assert(static_cast<uint8_t>(MirlibBase::OLD_GENERATION) == BOARD_GENERATION_OLD &&
+              static_cast<uint8_t>(MirlibBase::TRANSITION_GENERATION) == BOARD_GENERATION_TRANSITION &&
+              static_cast<uint8_t>(MirlibBase::NEW_GENERATION) == BOARD_GENERATION_NEW,
+              "Mirlib: MirlibBase::Generation must match BoardGeneration");
+
+MirlibClient::MirlibClient(uint16_t deviceAddress, RadioBackend *radio)
+    : MirlibBase(deviceAddress, radio)
+      , m_encodingKeyCount(0)
+      , m_earlyAbort(false)
+      , m_meterLinkCount(0)
+      , m_meterLinkNext(0)
+      , m_requestState(REQUEST_IDLE)
+      , m_requestCommand(nullptr)
+      , m_requestTarget(0)
+{
+    resetEarlyAbortStats();
 }
 
 bool MirlibClient::sendCommand(
@@ -10,15 +25,62 @@ bool MirlibClient::sendCommand(
     uint8_t *responseData,
     size_t responseSize
 ) {
+    return exchange(command, targetAddress, responseData, responseSize, nullptr);
+}
+
+bool MirlibClient::exchange(
+    BaseCommand *command,
+    uint16_t targetAddress,
+    uint8_t *responseData,
+    size_t responseSize,
+    PacketView *response
+) {
+    uint32_t window = 0;
+    if (!transmitRequest(command, targetAddress, window)) {
+        return false;
+    }
+
+    return receiveResponse(command, targetAddress, responseData, responseSize, window, response);
+}
+
+bool MirlibClient::transmitRequest(BaseCommand *command, uint16_t targetAddress, uint32_t &window) {
     if (command == nullptr) {
         setError(ERR_COMMAND_IS_NULL);
         return false;
     }
+    if (m_requestState == REQUEST_PENDING) {
+        setError(ERR_CLIENT_BUSY);
+        return false;
+    }
+
+    // Кодирование данных для этого счетчика (ключ не входит в ключ кэша - кэш сбрасывается при смене ключей)
+    uint32_t encodingKey = 0;
+    bool const encoded = getEncodingKey(targetAddress, encodingKey);
 
     // Подготовка данных запроса
     uint8_t requestData[ProtocolConstants::MAX_DATA_SIZE];
     size_t const requestDataSize = command->prepareRequest(requestData, sizeof(requestData));
 
+#if MIRLIB_REQUEST_CACHE_SIZE > 0
+    // Повторный опрос: готовый кадр из кэша, без createRequestPacket/packPacket
+    size_t cachedSize = 0;
+    uint8_t *cachedFrame = m_requestCache.find(command->getCommandCode(), targetAddress, m_password,
+                                               requestData, requestDataSize, cachedSize);
+    if (cachedFrame != nullptr) {
+        #ifdef MIRLIB_DEBUG
+            ProtocolUtils::printHex(cachedFrame, cachedSize, "Отправка запроса (кэш)");
+        #endif
+
+        window = openReceiveWindow(targetAddress);
+        if (!transmitRaw(cachedFrame, cachedSize)) {
+            disarmReceiveTimer();
+            setError(ERR_FAIL_SEND_PACKAGE);
+            return false;
+        }
+        return true;
+    }
+#endif
+
     // Создание пакета запроса
     PacketData requestPacket;
     if (!ProtocolUtils::createRequestPacket(
@@ -28,70 +90,376 @@ bool MirlibClient::sendCommand(
         m_password,
         requestData,
         requestDataSize,
-        requestPacket
+        requestPacket,
+        encoded,
+        encodingKey
     )) {
         setError(ERR_FAIL_CREATE_PACKAGE);
         return false;
     }
 
+#if MIRLIB_REQUEST_CACHE_SIZE > 0
+    m_requestCache.store(command->getCommandCode(), targetAddress, m_password,
+                         requestData, requestDataSize, requestPacket.rawPacket, requestPacket.rawSize);
+#endif
 
     #ifdef MIRLIB_DEBUG
         debugPrintPacket(requestPacket, "Отправка запроса");
     #endif
 
     // Отправка пакета
+    window = openReceiveWindow(targetAddress);
     if (!sendPacketOriginalStyle(requestPacket)) {
+        disarmReceiveTimer();
+        setError(ERR_FAIL_SEND_PACKAGE);
+        return false;
+    }
+    return true;
+}
+
+bool MirlibClient::startCommand(BaseCommand *command, uint16_t targetAddress) {
+    uint32_t window = 0;
+    if (!transmitRequest(command, targetAddress, window)) {
+        return false;
+    }
+
+    m_requestCommand = command;
+    m_requestTarget = targetAddress;
+    beginReceive(m_requestWait, m_timeout, window);
+    m_requestState = REQUEST_PENDING;
+    return true;
+}
+
+MirlibClient::RequestState MirlibClient::pollCommand(uint32_t maxWaitMs) {
+    if (m_requestState != REQUEST_PENDING) {
+        return m_requestState;
+    }
+
+    const PacketFilter filter = responseFilter(m_requestCommand, m_requestTarget);
+    uint32_t encodingKey = 0;
+    getEncodingKey(m_requestTarget, encodingKey);
+
+    PacketView frame;
+    const ReceiveStatus status = receiveStep(m_requestWait, m_responseFrame, frame, &filter, encodingKey, maxWaitMs);
+    if (status == RECEIVE_PENDING) {
+        return REQUEST_PENDING;
+    }
+
+    closeReceiveWindow(status == RECEIVE_FRAME);
+    if (status != RECEIVE_FRAME) {
+        setError(ERR_FAIL_RECEIVE_PACKAGE);
+        m_requestState = REQUEST_FAILED;
+        return m_requestState;
+    }
+
+    noteResponse(m_requestTarget, frame);
+    if (acceptResponse(m_requestCommand, m_requestTarget, frame, nullptr, 0, nullptr)) {
+        m_requestState = REQUEST_DONE;
+    } else {
+        m_requestState = REQUEST_FAILED;
+    }
+    return m_requestState;
+}
+
+bool MirlibClient::sendCommand(
+    BaseCommand *command,
+    const FlashFrame &request,
+    uint8_t *responseData,
+    size_t responseSize
+) {
+    if (command == nullptr) {
+        setError(ERR_COMMAND_IS_NULL);
+        return false;
+    }
+
+    if (m_requestState == REQUEST_PENDING) {
+        setError(ERR_CLIENT_BUSY);
+        return false;
+    }
+
+    // Ответ ожидается на адрес клиента, поэтому кадр должен быть собран для него
+    if (request.command != command->getCommandCode() || request.srcAddress != m_deviceAddress) {
+        setError(ERR_STATIC_FRAME_MISMATCH);
+        return false;
+    }
+
+    // Отправка готового кадра (без кодирования)
+    const uint32_t window = openReceiveWindow(request.destAddress);
+    if (!sendPacketOriginalStyle(request)) {
+        disarmReceiveTimer();
         setError(ERR_FAIL_SEND_PACKAGE);
         return false;
     }
 
-    // Ожидание ответа
-    PacketData responsePacket;
-    if (!receivePacketOriginalStyle(responsePacket, m_timeout)) {
+    return receiveResponse(command, request.destAddress, responseData, responseSize, window);
+}
+
+bool MirlibClient::receiveResponse(
+    BaseCommand *command,
+    uint16_t targetAddress,
+    uint8_t *responseData,
+    size_t responseSize,
+    uint32_t window,
+    PacketView *response
+) {
+    // Ожидание ответа (кадр разбирается на месте, без PacketData)
+    const PacketFilter filter = responseFilter(command, targetAddress);
+    uint32_t encodingKey = 0;
+    getEncodingKey(targetAddress, encodingKey);
+
+    PacketView frame;
+    const bool received = receiveFrame(m_responseFrame, frame, m_timeout, &filter, encodingKey, window);
+    closeReceiveWindow(received);
+    if (!received) {
         setError(ERR_FAIL_RECEIVE_PACKAGE);
         return false;
     }
+    noteResponse(targetAddress, frame);
+
+    return acceptResponse(command, targetAddress, frame, responseData, responseSize, response);
+}
+
+PacketFilter MirlibClient::responseFilter(BaseCommand *command, uint16_t targetAddress) const {
+    // Кадры других устройств и команд отбрасываются по заголовку до проверки CRC
+    PacketFilter filter;
+    filter.dest = AddressFilter::single(m_deviceAddress);
+    filter.src = AddressFilter::single(targetAddress);
+    filter.setCommand(command->getCommandCode());
+    return filter;
+}
 
+bool MirlibClient::acceptResponse(
+    BaseCommand *command,
+    uint16_t targetAddress,
+    const PacketView &frame,
+    uint8_t *responseData,
+    size_t responseSize,
+    PacketView *response
+) {
 #ifdef MIRLIB_DEBUG
-        debugPrintPacket(responsePacket, "Получен ответ");
+        ProtocolUtils::printHex(frame.frame(), frame.frameSize(), "Получен ответ");
 #endif
 
     // Проверка ответа
-    if (responsePacket.command != command->getCommandCode()) {
+    if (frame.command() != command->getCommandCode()) {
         setError(ERR_RESPONSE_COMMANDS_DO_NOT_MATCH);
         return false;
     }
 
-    if (responsePacket.srcAddress != targetAddress) {
+    if (frame.srcAddress() != targetAddress) {
         setError(ERR_RESPONSE_ADDRESS_DO_NOT_MATCH);
         return false;
     }
 
-    if (responsePacket.destAddress != m_deviceAddress) {
+    if (frame.destAddress() != m_deviceAddress) {
         setError(ERR_RESPONSE_TARGET_DO_NOT_MATCH);
         return false;
     }
 
-    if (!responsePacket.isResponse()) {
+    if (!frame.isResponse()) {
         setError(ERR_RESPONSE_IS_NOT_RESPONSE);
         return false;
     }
 
+    // Представление ответа: поля разбираются вызывающим при обращении
+    if (response != nullptr) {
+        *response = frame;
+        return true;
+    }
+
     // Разбор ответа
-    if (!command->parseResponse(responsePacket.data, responsePacket.dataSize)) {
+    if (!command->parseResponse(frame.data(), frame.dataSize())) {
         setError(ERR_UNABLE_TO_PARSE_RESPONSE_DATA);
         return false;
     }
 
     // Копирование данных ответа при необходимости
     if (responseData && responseSize > 0) {
-        size_t copySize = (responsePacket.dataSize < responseSize) ? responsePacket.dataSize : responseSize;
-        memcpy(responseData, responsePacket.data, copySize);
+        size_t copySize = (frame.dataSize() < responseSize) ? frame.dataSize() : responseSize;
+        memcpy(responseData, frame.data(), copySize);
     }
 
     return true;
 }
 
+bool MirlibClient::setEncodingKey(uint16_t meterAddress, uint32_t key) {
+    size_t index = 0;
+    while (index < m_encodingKeyCount && m_encodingKeys[index].meterAddress != meterAddress) {
+        index++;
+    }
+
+    if (index == m_encodingKeyCount) {
+        if (m_encodingKeyCount >= MIRLIB_ENCODING_KEY_SLOTS) {
+            return false;
+        }
+        m_encodingKeyCount++;
+    }
+
+    m_encodingKeys[index].meterAddress = meterAddress;
+    m_encodingKeys[index].key = key;
+
+#if MIRLIB_REQUEST_CACHE_SIZE > 0
+    m_requestCache.clear();
+#endif
+    return true;
+}
+
+void MirlibClient::clearEncodingKey(uint16_t meterAddress) {
+    for (size_t i = 0; i < m_encodingKeyCount; i++) {
+        if (m_encodingKeys[i].meterAddress == meterAddress) {
+            m_encodingKeys[i] = m_encodingKeys[--m_encodingKeyCount];
+            break;
+        }
+    }
+
+#if MIRLIB_REQUEST_CACHE_SIZE > 0
+    m_requestCache.clear();
+#endif
+}
+
+bool MirlibClient::getEncodingKey(uint16_t meterAddress, uint32_t &key) const {
+    for (size_t i = 0; i < m_encodingKeyCount; i++) {
+        if (m_encodingKeys[i].meterAddress == meterAddress) {
+            key = m_encodingKeys[i].key;
+            return true;
+        }
+    }
+    return false;
+}
+
+void MirlibClient::setEarlyAbort(bool enable, const ReceiveWindowPolicy &policy) {
+    m_earlyAbort = enable;
+    m_windowPolicy = policy;
+}
+
+uint32_t MirlibClient::getReceiveWindow(uint16_t meterAddress) const {
+    uint32_t window = m_windowPolicy.initialWindowMs;
+    const MeterLinkStats *const stats = getMeterStats(meterAddress);
+    if (stats != nullptr) {
+        window = 2UL * stats->responseMs + m_windowPolicy.marginMs;
+        if (window < m_windowPolicy.minWindowMs) {
+            window = m_windowPolicy.minWindowMs;
+        }
+    }
+
+    // Окно не короче таймаута не сокращает ожидание
+    return window < m_timeout ? window : 0;
+}
+
+void MirlibClient::resetEarlyAbortStats() {
+    memset(&m_earlyAbortStats, 0, sizeof(m_earlyAbortStats));
+}
+
+const MirlibClient::MeterLinkStats *MirlibClient::getMeterStats(uint16_t meterAddress) const {
+    for (size_t i = 0; i < m_meterLinkCount; i++) {
+        if (m_meterLinks[i].stats.meterAddress == meterAddress) {
+            return &m_meterLinks[i].stats;
+        }
+    }
+    return nullptr;
+}
+
+void MirlibClient::resetMeterStats() {
+    m_meterLinkCount = 0;
+    m_meterLinkNext = 0;
+}
+
+uint32_t MirlibClient::openReceiveWindow(uint16_t targetAddress) {
+    if (!m_earlyAbort) {
+        return 0;
+    }
+
+    const uint32_t window = getReceiveWindow(targetAddress);
+    if (window != 0 && m_windowPolicy.useRxTimer) {
+        armReceiveTimer(window);
+    }
+    return window;
+}
+
+void MirlibClient::closeReceiveWindow(bool received) {
+    disarmReceiveTimer();
+    if (!m_earlyAbort) {
+        return;
+    }
+
+    if (m_receiveExtended) {
+        m_earlyAbortStats.extendedWaits++;
+    }
+
+    if (received) {
+        m_earlyAbortStats.responses++;
+        return;
+    }
+
+    if (!m_receiveAborted) {
+        m_earlyAbortStats.fullTimeouts++;
+        return;
+    }
+
+    m_earlyAbortStats.earlyAborts++;
+    const uint32_t saved = m_timeout > m_receiveElapsedMs ? m_timeout - m_receiveElapsedMs : 0;
+    m_earlyAbortStats.savedMs += saved;
+
+    uint8_t bucket = 0;
+    for (uint32_t limit = 64; bucket < EarlyAbortStats::HISTOGRAM_SIZE - 1 && saved >= limit; limit <<= 1) {
+        bucket++;
+    }
+    m_earlyAbortStats.savedHistogram[bucket]++;
+}
+
+void MirlibClient::noteResponse(uint16_t targetAddress, const PacketView &frame) {
+    const RxMetadata &metadata = frame.metadata();
+    const uint16_t elapsedMs = m_receiveElapsedMs < 0xFFFF ? static_cast<uint16_t>(m_receiveElapsedMs) : 0xFFFF;
+    const int16_t rssi = metadata.rssiDbm();
+    const uint8_t lqi = metadata.linkQuality();
+    // Синхрослово, пропущенное во время передачи, оставляет отметку до конца запроса
+    const int32_t sinceRequest = static_cast<int32_t>(metadata.timestamp - m_txEndTimestamp);
+    const uint32_t roundTrip = sinceRequest > 0 ? static_cast<uint32_t>(sinceRequest) : 0;
+
+    size_t index = 0;
+    while (index < m_meterLinkCount && m_meterLinks[index].stats.meterAddress != targetAddress) {
+        index++;
+    }
+
+    MeterLink *link;
+    if (index == m_meterLinkCount) {
+        if (m_meterLinkCount < MIRLIB_RX_WINDOW_SLOTS) {
+            m_meterLinkCount++;
+        } else {
+            index = m_meterLinkNext;
+            m_meterLinkNext = static_cast<uint8_t>((m_meterLinkNext + 1) % MIRLIB_RX_WINDOW_SLOTS);
+        }
+
+        // Первый ответ задает средние
+        link = &m_meterLinks[index];
+        link->stats.meterAddress = targetAddress;
+        link->stats.responseMs = elapsedMs;
+        link->stats.responses = 0;
+        link->rssiSum = static_cast<int16_t>(rssi * 8);
+        link->lqiSum = static_cast<uint16_t>(lqi * 8);
+        link->roundTripSum = roundTrip * 8;
+    } else {
+        link = &m_meterLinks[index];
+
+        // Время ответа растет сразу, а снижается на 1/4 за ответ (окно не сужается по одному быстрому ответу)
+        const uint16_t decayed = link->stats.responseMs - link->stats.responseMs / 4;
+        link->stats.responseMs = elapsedMs > decayed ? elapsedMs : decayed;
+
+        link->rssiSum = static_cast<int16_t>(link->rssiSum - link->rssiSum / 8 + rssi);
+        link->lqiSum = static_cast<uint16_t>(link->lqiSum - link->lqiSum / 8 + lqi);
+        link->roundTripSum = link->roundTripSum - link->roundTripSum / 8 + roundTrip;
+    }
+
+    MeterLinkStats &stats = link->stats;
+    stats.responses++;
+    stats.rssiDbm = rssi;
+    stats.rssiAverageDbm = static_cast<int16_t>(link->rssiSum / 8);
+    stats.lqi = lqi;
+    stats.lqiAverage = static_cast<uint8_t>(link->lqiSum / 8);
+    stats.roundTripUs = roundTrip;
+    stats.roundTripAverageUs = link->roundTripSum / 8;
+}
+
 bool MirlibClient::autoDetectGeneration(uint16_t targetAddress) {
     GetInfoCommand getInfoCmd;
 
@@ -99,17 +467,11 @@ bool MirlibClient::autoDetectGeneration(uint16_t targetAddress) {
         return false;
     }
 
-    GenerationInfo const info = ProtocolUtils::determineGeneration(getInfoCmd.getBoardId(), 0x32);
     // Предполагаем role >= 0x32 для определения
+    m_generation = static_cast<Generation>(
+        BoardCapabilities::generation(getInfoCmd.getBoardId(), BoardCapabilities::ROLE_THRESHOLD));
 
-    if (info.isOldGeneration) {
-        m_generation = OLD_GENERATION;
-    } else if (info.isTransitionGeneration) {
-        m_generation = TRANSITION_GENERATION;
-    } else if (info.isNewGeneration) {
-        m_generation = NEW_GENERATION;
-    } else {
-        m_generation = UNKNOWN;
+    if (m_generation == UNKNOWN) {
         return false;
     }
 
@@ -177,8 +539,10 @@ bool MirlibClient::readStatus(uint16_t targetAddress, EnergyType energyType,
 
     // Установить поколение для команды
     GenerationInfo const info = getGenerationInfo();
-    uint8_t const boardId = (info.boardId != 0) ? info.boardId : 0x09; // По умолчанию новое поколение
-    cmd.setGeneration(boardId, 0x32);
+    uint8_t const boardId = (info.boardId != 0)
+                                ? info.boardId
+                                : BoardCapabilities::profile(BOARD_GENERATION_NEW).referenceBoardId; // По умолчанию новое поколение
+    cmd.setGeneration(boardId, BoardCapabilities::ROLE_THRESHOLD);
 
     cmd.setRequest(energyType);
 
@@ -197,6 +561,67 @@ bool MirlibClient::readStatus(uint16_t targetAddress, EnergyType energyType,
     return true;
 }
 
+bool MirlibClient::readStatus(uint16_t targetAddress, ReadStatusOldView &view) {
+    ReadStatusCommand cmd;
+    cmd.setGeneration(BoardCapabilities::profile(BOARD_GENERATION_OLD).referenceBoardId, BoardCapabilities::ROLE_THRESHOLD);
+
+    PacketView response;
+    if (!exchange(&cmd, targetAddress, nullptr, 0, &response)) {
+        return false;
+    }
+
+    if (!view.attach(response.data(), response.dataSize())) {
+        setError(ERR_UNABLE_TO_PARSE_RESPONSE_DATA);
+        return false;
+    }
+
+    return true;
+}
+
+bool MirlibClient::readStatus(uint16_t targetAddress, EnergyType energyType, ReadStatusNewView &view) {
+    ReadStatusCommand cmd;
+    cmd.setGeneration(BoardCapabilities::profile(BOARD_GENERATION_NEW).referenceBoardId, BoardCapabilities::ROLE_THRESHOLD);
+    cmd.setRequest(energyType);
+
+    PacketView response;
+    if (!exchange(&cmd, targetAddress, nullptr, 0, &response)) {
+        return false;
+    }
+
+    if (!view.attach(response.data(), response.dataSize())) {
+        setError(ERR_UNABLE_TO_PARSE_RESPONSE_DATA);
+        return false;
+    }
+
+    return true;
+}
+
+bool MirlibClient::readStatus(const FlashFrame &request,
+                              ReadStatusResponseOld *oldResponse, ReadStatusResponseNew *newResponse) {
+    ReadStatusCommand cmd;
+
+    // Установить поколение для разбора ответа (запрос уже собран)
+    GenerationInfo const info = getGenerationInfo();
+    uint8_t const boardId = (info.boardId != 0)
+                                ? info.boardId
+                                : BoardCapabilities::profile(BOARD_GENERATION_NEW).referenceBoardId; // По умолчанию новое поколение
+    cmd.setGeneration(boardId, BoardCapabilities::ROLE_THRESHOLD);
+
+    if (!sendCommand(&cmd, request)) {
+        return false;
+    }
+
+    if (cmd.isOldGeneration() && (oldResponse != nullptr)) {
+        *oldResponse = cmd.getOldResponse();
+    }
+
+    if (!cmd.isOldGeneration() && (newResponse != nullptr)) {
+        *newResponse = cmd.getNewResponse();
+    }
+
+    return true;
+}
+
 bool MirlibClient::readInstantValue(uint16_t targetAddress, ParameterGroup group,
                                     ReadInstantValueResponseTransition *transResponse,
                                     ReadInstantValueResponseNewBasic *newResponse) {
@@ -204,8 +629,10 @@ bool MirlibClient::readInstantValue(uint16_t targetAddress, ParameterGroup group
 
     // Установить поколение для команды
     GenerationInfo const info = getGenerationInfo();
-    uint8_t const boardId = (info.boardId != 0) ? info.boardId : 0x09; // По умолчанию новое поколение
-    cmd.setGeneration(boardId, 0x32);
+    uint8_t const boardId = (info.boardId != 0)
+                                ? info.boardId
+                                : BoardCapabilities::profile(BOARD_GENERATION_NEW).referenceBoardId; // По умолчанию новое поколение
+    cmd.setGeneration(boardId, BoardCapabilities::ROLE_THRESHOLD);
 
     cmd.setRequest(group);
 
@@ -224,36 +651,37 @@ bool MirlibClient::readInstantValue(uint16_t targetAddress, ParameterGroup group
     return true;
 }
 
-GenerationInfo MirlibClient::getGenerationInfo(uint8_t boardId, uint8_t role) {
-    GenerationInfo info = {0};
+bool MirlibClient::readInstantValue(uint16_t targetAddress, InstantValueNewView &view) {
+    ReadInstantValueCommand cmd;
+    cmd.setGeneration(BoardCapabilities::profile(BOARD_GENERATION_NEW).referenceBoardId, BoardCapabilities::ROLE_THRESHOLD);
+    cmd.setRequest(GROUP_BASIC);
 
-    // Если поколение уже определено, используем его
-    if (m_generation != UNKNOWN) {
-        switch (m_generation) {
-            case OLD_GENERATION:
-                info.boardId = (boardId != 0) ? boardId : 0x01;
-                info.role = role;
-                info.isOldGeneration = true;
-                break;
-            case TRANSITION_GENERATION:
-                info.boardId = (boardId != 0) ? boardId : 0x07;
-                info.role = role;
-                info.isTransitionGeneration = true;
-                break;
-            case NEW_GENERATION:
-                info.boardId = (boardId != 0) ? boardId : 0x09;
-                info.role = role;
-                info.isNewGeneration = true;
-                break;
-            default:
-                break;
-        }
+    PacketView response;
+    if (!exchange(&cmd, targetAddress, nullptr, 0, &response)) {
+        return false;
+    }
+
+    if (!view.attach(response.data(), response.dataSize())) {
+        setError(ERR_UNABLE_TO_PARSE_RESPONSE_DATA);
+        return false;
     }
 
+    return true;
+}
+
+GenerationInfo MirlibClient::getGenerationInfo(uint8_t boardId, uint8_t role) {
     // Если boardId передан, используем его для определения
     if (boardId != 0) {
-        info = ProtocolUtils::determineGeneration(boardId, role);
+        return ProtocolUtils::determineGeneration(boardId, role);
+    }
+
+    // Если поколение уже определено, используем его (ID платы - типовой для поколения)
+    if (m_generation != UNKNOWN) {
+        BoardGeneration const generation = static_cast<BoardGeneration>(m_generation);
+        return BoardCapabilities::generationInfo(generation,
+                                                 BoardCapabilities::profile(generation).referenceBoardId, role);
     }
 
+    GenerationInfo info = {};
     return info;
 }
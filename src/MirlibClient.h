@@ -2,6 +2,7 @@
 #define MIRLIB_CLIENT_H
 
 #include "MirlibBase.h"
+#include "RequestFrameCache.h"
 #include "Commands/BaseCommand.h"
 #include "Commands/PingCommand.h"
 #include "Commands/ReadStatusCommand.h"
@@ -9,6 +10,29 @@
 #include "Commands/ReadDateTimeCommand.h"
 #include "Commands/GetInfoCommand.h"
 
+/**
+ * @brief Количество счетчиков с ключом кодирования данных на клиенте
+ */
+#ifndef MIRLIB_ENCODING_KEY_SLOTS
+  #if defined(MIRLIB_PLATFORM_AVR)
+    #define MIRLIB_ENCODING_KEY_SLOTS 4
+  #else
+    #define MIRLIB_ENCODING_KEY_SLOTS 16
+  #endif
+#endif
+
+/**
+ * @brief Количество счетчиков в таблице связи: выученное время ответа (окно раннего прерывания),
+ * RSSI, LQI и время прохождения запрос-ответ
+ */
+#ifndef MIRLIB_RX_WINDOW_SLOTS
+  #if defined(MIRLIB_PLATFORM_AVR)
+    #define MIRLIB_RX_WINDOW_SLOTS 4
+  #else
+    #define MIRLIB_RX_WINDOW_SLOTS 32
+  #endif
+#endif
+
 /**
  * @brief Клиентская часть Mirlib для отправки команд счетчикам
  *
@@ -17,11 +41,71 @@
  */
 class MirlibClient : public MirlibBase {
 public:
+    /**
+     * @brief Окно ожидания начала ответа (раннее прерывание)
+     *
+     * Окно счетчика - удвоенное выученное время ответа плюс запас, не меньше minWindowMs.
+     * Если к концу окна в эфире нет кадра, ожидание прерывается; полный таймаут
+     * ожидается только когда кадр уже принимается.
+     */
+    struct ReceiveWindowPolicy {
+        uint16_t initialWindowMs; ///< Окно для счетчика без истории ответов
+        uint16_t minWindowMs; ///< Нижняя граница выученного окна
+        uint16_t marginMs; ///< Запас к удвоенному времени ответа
+        bool useRxTimer; ///< Дублировать окно таймером RX_TIME (MCSM2) для окон до 125 мс
+
+        ReceiveWindowPolicy() : initialWindowMs(500), minWindowMs(30), marginMs(20), useRxTimer(true) {}
+    };
+
+    /**
+     * @brief Состояние запроса без блокировки (startCommand / pollCommand)
+     */
+    enum RequestState {
+        REQUEST_IDLE, ///< Запроса не было
+        REQUEST_PENDING, ///< Запрос отправлен, ответ ожидается
+        REQUEST_DONE, ///< Ответ получен и разобран командой
+        REQUEST_FAILED ///< Запрос не выполнен (getLastError)
+    };
+
+    /**
+     * @brief Статистика ожидания ответов при раннем прерывании
+     */
+    struct EarlyAbortStats {
+        static const uint8_t HISTOGRAM_SIZE = 8;
+
+        uint32_t responses; ///< Получено ответов
+        uint32_t earlyAborts; ///< Ожиданий, прерванных по окну
+        uint32_t extendedWaits; ///< Ожиданий, продленных до таймаута: к концу окна кадр был в эфире
+        uint32_t fullTimeouts; ///< Ожиданий без ответа до полного таймаута
+        uint32_t savedMs; ///< Сэкономлено времени ожидания, мс
+        /// Сэкономлено на одно прерывание: < 64, < 128, < 256, < 512, < 1024, < 2048, < 4096, >= 4096 мс
+        uint32_t savedHistogram[HISTOGRAM_SIZE];
+    };
+
+    /**
+     * @brief Статистика связи со счетчиком, обновляется по каждому принятому ответу
+     *
+     * Средние - скользящие с весом 1/8 последнего ответа. Время прохождения - от окончания
+     * передачи запроса до синхрослова ответа (в режиме опроса - до вычитывания ответа из FIFO).
+     */
+    struct MeterLinkStats {
+        uint16_t meterAddress;
+        uint16_t responseMs; ///< Выученное время ответа (окно раннего прерывания)
+        uint32_t responses; ///< Принято ответов
+        int16_t rssiDbm; ///< RSSI последнего ответа, дБм
+        int16_t rssiAverageDbm; ///< Среднее RSSI, дБм
+        uint8_t lqi; ///< LQI последнего ответа (меньше - лучше)
+        uint8_t lqiAverage; ///< Среднее LQI
+        uint32_t roundTripUs; ///< Время прохождения последнего запроса, мкс
+        uint32_t roundTripAverageUs; ///< Среднее время прохождения, мкс
+    };
+
     /**
      * @brief Конструктор
      * @param deviceAddress Адрес клиента (по умолчанию 0xFFFF)
+     * @param radio Радиомодуль (nullptr - ElechouseRadio)
      */
-    explicit MirlibClient(uint16_t deviceAddress = 0xFFFF);
+    explicit MirlibClient(uint16_t deviceAddress = 0xFFFF, RadioBackend *radio = nullptr);
 
     /**
      * @brief Деструктор
@@ -39,6 +123,41 @@ public:
     bool sendCommand(BaseCommand *command, uint16_t targetAddress,
                      uint8_t *responseData = nullptr, size_t responseSize = 0);
 
+    /**
+     * @brief Отправить команду готовым кадром, собранным на этапе компиляции
+     * Кадр (StaticRequestFrame) должен быть собран для этой команды и адреса клиента
+     * @param command Команда (используется для разбора ответа)
+     * @param request Кадр запроса во flash
+     * @param responseData Буфер для данных ответа (опционально)
+     * @param responseSize Размер буфера ответа
+     * @return true если команда отправлена и ответ получен успешно
+     */
+    bool sendCommand(BaseCommand *command, const FlashFrame &request,
+                     uint8_t *responseData = nullptr, size_t responseSize = 0);
+
+    /**
+     * @brief Отправить команду, не дожидаясь ответа
+     * Ответ ожидается вызовами pollCommand() и разбирается в command, поэтому команда
+     * должна жить до завершения запроса. Пока запрос не завершен, другие запросы
+     * этим клиентом не выполняются
+     * @param command Команда для отправки
+     * @param targetAddress Адрес целевого устройства
+     * @return false если запрос не отправлен (getLastError)
+     */
+    bool startCommand(BaseCommand *command, uint16_t targetAddress);
+
+    /**
+     * @brief Проверить ответ на запрос startCommand
+     * @param maxWaitMs Наибольшее ожидание в вызове (0 - без блокировки)
+     * @return REQUEST_PENDING, пока ответа нет и таймаут не истек
+     */
+    RequestState pollCommand(uint32_t maxWaitMs = 0);
+
+    /**
+     * @brief Получить состояние последнего запроса startCommand
+     */
+    RequestState getRequestState() const { return m_requestState; }
+
     /**
      * @brief Автоопределение поколения устройства с помощью команды GetInfo
      * @param targetAddress Адрес целевого устройства
@@ -83,6 +202,36 @@ public:
                     ReadStatusResponseOld *oldResponse = nullptr, 
                     ReadStatusResponseNew *newResponse = nullptr);
 
+    /**
+     * @brief Прочитать статус счетчика старого поколения без разбора всего ответа
+     * Поля разбираются при обращении к view; view действителен до следующего запроса этого клиента
+     * @param targetAddress Адрес целевого устройства
+     * @param view Представление ответа (выход)
+     * @return true если команда выполнена успешно
+     */
+    bool readStatus(uint16_t targetAddress, ReadStatusOldView &view);
+
+    /**
+     * @brief Прочитать статус счетчика переходного/нового поколения без разбора всего ответа
+     * Поля разбираются при обращении к view; view действителен до следующего запроса этого клиента
+     * @param targetAddress Адрес целевого устройства
+     * @param energyType Тип энергии
+     * @param view Представление ответа (выход)
+     * @return true если команда выполнена успешно
+     */
+    bool readStatus(uint16_t targetAddress, EnergyType energyType, ReadStatusNewView &view);
+
+    /**
+     * @brief Прочитать статус счетчика готовым кадром (адрес, пароль и тип энергии заданы в кадре)
+     * @param request Кадр запроса ReadStatus (StaticRequestFrame)
+     * @param oldResponse Ответ старого поколения (выход)
+     * @param newResponse Ответ нового поколения (выход)
+     * @return true если команда выполнена успешно
+     */
+    bool readStatus(const FlashFrame &request,
+                    ReadStatusResponseOld *oldResponse = nullptr,
+                    ReadStatusResponseNew *newResponse = nullptr);
+
     /**
      * @brief Прочитать мгновенные значения (для переходного/нового поколения)
      * @param targetAddress Адрес целевого устройства
@@ -95,20 +244,217 @@ public:
                           ReadInstantValueResponseTransition *transResponse = nullptr,
                           ReadInstantValueResponseNewBasic *newResponse = nullptr);
 
+    /**
+     * @brief Прочитать мгновенные значения нового поколения без разбора всего ответа
+     * Поля разбираются при обращении к view; view действителен до следующего запроса этого клиента
+     * @param targetAddress Адрес целевого устройства
+     * @param view Представление ответа группы 0x00 (выход)
+     * @return true если команда выполнена успешно
+     */
+    bool readInstantValue(uint16_t targetAddress, InstantValueNewView &view);
+
     /**
      * @brief Установить поколение для команд (если известно заранее)
      * @param generation Поколение устройства
      */
     void setDeviceGeneration(Generation generation) { m_generation = generation; }
 
+    /**
+     * @brief Включить кодирование данных (params.encoding = 1) для счетчика
+     * Запросы к счетчику отправляются закодированными, закодированные ответы декодируются этим ключом
+     * @param meterAddress Адрес счетчика
+     * @param key Ключ
+     * @return false если таблица ключей заполнена (MIRLIB_ENCODING_KEY_SLOTS)
+     */
+    bool setEncodingKey(uint16_t meterAddress, uint32_t key);
+
+    /**
+     * @brief Отключить кодирование данных для счетчика
+     * @param meterAddress Адрес счетчика
+     */
+    void clearEncodingKey(uint16_t meterAddress);
+
+    /**
+     * @brief Получить ключ кодирования счетчика
+     * @param meterAddress Адрес счетчика
+     * @param key Ключ (выход)
+     * @return true если для счетчика включено кодирование
+     */
+    bool getEncodingKey(uint16_t meterAddress, uint32_t &key) const;
+
+    /**
+     * @brief Прерывать ожидание ответа, если он не начался в окне счетчика
+     * Время ответа выучивается по каждому счетчику (MIRLIB_RX_WINDOW_SLOTS, см. getMeterStats);
+     * неответивший счетчик стоит окно вместо полного таймаута
+     * @param enable Включить раннее прерывание
+     * @param policy Окно ожидания
+     */
+    void setEarlyAbort(bool enable, const ReceiveWindowPolicy &policy = ReceiveWindowPolicy());
+
+    /**
+     * @brief Проверить, включено ли раннее прерывание
+     */
+    bool isEarlyAbortEnabled() const { return m_earlyAbort; }
+
+    /**
+     * @brief Окно ожидания начала ответа счетчика
+     * @param meterAddress Адрес счетчика
+     * @return Окно в мс, 0 - ожидание полного таймаута
+     */
+    uint32_t getReceiveWindow(uint16_t meterAddress) const;
+
+    /**
+     * @brief Получить статистику раннего прерывания
+     */
+    const EarlyAbortStats &getEarlyAbortStats() const { return m_earlyAbortStats; }
+
+    /**
+     * @brief Сбросить статистику раннего прерывания (выученные окна сохраняются)
+     */
+    void resetEarlyAbortStats();
+
+    /**
+     * @brief Статистика связи со счетчиком
+     * При заполненной таблице (MIRLIB_RX_WINDOW_SLOTS) новый счетчик вытесняет самую старую запись
+     * @param meterAddress Адрес счетчика
+     * @return nullptr если от счетчика не было ответов
+     */
+    const MeterLinkStats *getMeterStats(uint16_t meterAddress) const;
+
+    /**
+     * @brief Сбросить статистику связи со всеми счетчиками (вместе с выученными окнами)
+     */
+    void resetMeterStats();
+
+#if MIRLIB_REQUEST_CACHE_SIZE > 0
+    /**
+     * @brief Кэш закодированных кадров запросов (счетчики попаданий/промахов)
+     */
+    const RequestFrameCache &getRequestCache() const { return m_requestCache; }
+
+    /**
+     * @brief Очистить кэш кадров запросов
+     */
+    void clearRequestCache() { m_requestCache.clear(); }
+
+protected:
+    /**
+     * @brief Сброс кэша кадров при смене пароля или адреса клиента
+     */
+    void onAddressingChanged() override { m_requestCache.clear(); }
+#endif
+
 private:
+    /**
+     * @brief Отправить запрос и получить ответ
+     * @param command Команда
+     * @param targetAddress Адрес целевого устройства
+     * @param responseData Буфер для данных ответа (опционально)
+     * @param responseSize Размер буфера ответа
+     * @param response Кадр ответа без разбора командой (опционально, см. receiveResponse)
+     * @return true если команда отправлена и ответ получен успешно
+     */
+    bool exchange(BaseCommand *command, uint16_t targetAddress,
+                  uint8_t *responseData, size_t responseSize, PacketView *response);
+
+    /**
+     * @brief Собрать (или взять из кэша) и отправить кадр запроса, открыть окно ответа
+     * @param command Команда
+     * @param targetAddress Адрес целевого устройства
+     * @param window Окно начала ответа (выход, см. openReceiveWindow)
+     * @return true если запрос отправлен
+     */
+    bool transmitRequest(BaseCommand *command, uint16_t targetAddress, uint32_t &window);
+
+    /**
+     * @brief Получить и проверить ответ на отправленный запрос, разобрать его командой
+     * @param command Команда
+     * @param targetAddress Адрес целевого устройства
+     * @param responseData Буфер для данных ответа (опционально)
+     * @param responseSize Размер буфера ответа
+     * @param window Окно начала ответа (openReceiveWindow)
+     * @param response Если задан - ответ не разбирается командой, а возвращается как кадр в m_responseFrame
+     * @return true если ответ получен и разобран
+     */
+    bool receiveResponse(BaseCommand *command, uint16_t targetAddress,
+                         uint8_t *responseData, size_t responseSize, uint32_t window,
+                         PacketView *response = nullptr);
+
+    /**
+     * @brief Фильтр заголовка ответа: от целевого устройства клиенту, та же команда
+     */
+    PacketFilter responseFilter(BaseCommand *command, uint16_t targetAddress) const;
+
+    /**
+     * @brief Проверить принятый ответ и разобрать его командой (параметры как у receiveResponse)
+     * @param frame Принятый кадр
+     */
+    bool acceptResponse(BaseCommand *command, uint16_t targetAddress, const PacketView &frame,
+                        uint8_t *responseData, size_t responseSize, PacketView *response);
+
+    /**
+     * @brief Определить окно ответа счетчика и запустить таймер RX_TIME (до передачи запроса)
+     * @return Окно в мс, 0 - раннее прерывание выключено
+     */
+    uint32_t openReceiveWindow(uint16_t targetAddress);
+
+    /**
+     * @brief Остановить таймер RX_TIME и обновить статистику раннего прерывания
+     * @param received Ответ получен
+     * @note Время ответа счетчика запоминает noteResponse
+     */
+    void closeReceiveWindow(bool received);
+
+    /**
+     * @brief Обновить статистику связи со счетчиком по принятому ответу
+     * @param targetAddress Адрес счетчика
+     * @param frame Ответ с метаданными приема
+     */
+    void noteResponse(uint16_t targetAddress, const PacketView &frame);
+
     /**
      * @brief Определить поколение для команды на основе известного поколения или автоопределения
      * @param boardId Board ID (если известен)
      * @param role Role (если известен)
      * @return Информация о поколении
      */
-    GenerationInfo getGenerationInfo(uint8_t boardId = 0, uint8_t role = 0x32);
+    GenerationInfo getGenerationInfo(uint8_t boardId = 0, uint8_t role = BoardCapabilities::ROLE_THRESHOLD);
+
+    struct EncodingKey {
+        uint16_t meterAddress;
+        uint32_t key;
+    };
+
+    uint8_t m_responseFrame[ProtocolConstants::MAX_PACKET_SIZE]; ///< Последний принятый кадр (для представлений ответа)
+
+    /**
+     * @brief Запись таблицы связи: статистика и суммы скользящих средних (среднее * 8)
+     */
+    struct MeterLink {
+        MeterLinkStats stats;
+        int16_t rssiSum;
+        uint16_t lqiSum;
+        uint32_t roundTripSum;
+    };
+
+    EncodingKey m_encodingKeys[MIRLIB_ENCODING_KEY_SLOTS]; ///< Ключи кодирования по адресу счетчика
+    uint8_t m_encodingKeyCount;
+
+    bool m_earlyAbort;
+    ReceiveWindowPolicy m_windowPolicy;
+    EarlyAbortStats m_earlyAbortStats;
+    MeterLink m_meterLinks[MIRLIB_RX_WINDOW_SLOTS]; ///< Связь по адресу счетчика
+    uint8_t m_meterLinkCount;
+    uint8_t m_meterLinkNext; ///< Следующая вытесняемая запись при заполненной таблице
+
+    RequestState m_requestState; ///< Запрос без блокировки
+    BaseCommand *m_requestCommand;
+    uint16_t m_requestTarget;
+    ReceiveWait m_requestWait;
+
+#if MIRLIB_REQUEST_CACHE_SIZE > 0
+    RequestFrameCache m_requestCache; ///< Кадры запросов повторяющегося опроса
+#endif
 };
 
 #endif // MIRLIB_CLIENT_H
\ No newline at end of file
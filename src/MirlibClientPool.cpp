@@ -0,0 +1,129 @@
+#include "MirlibClientPool.h"
+
+MirlibClientPool::MirlibClientPool()
+    : m_count(0)
+      , m_channelGuardMs(0)
+{
+}
+
+bool MirlibClientPool::addClient(MirlibClient &client) {
+    if (m_count >= MIRLIB_POOL_SIZE) {
+        return false;
+    }
+
+    m_slots[m_count].client = &client;
+    m_slots[m_count].job = nullptr;
+    m_slots[m_count].startTime = 0;
+    m_slots[m_count].startChannel = 0;
+    m_slots[m_count].started = false;
+    m_count++;
+    return true;
+}
+
+bool MirlibClientPool::poll(Job *jobs, size_t count) {
+    // Ответы: завершенные запросы освобождают клиентов
+    for (uint8_t i = 0; i < m_count; i++) {
+        Slot &slot = m_slots[i];
+        if (slot.job == nullptr) {
+            continue;
+        }
+
+        const MirlibClient::RequestState state = slot.client->pollCommand();
+        if (state == MirlibClient::REQUEST_PENDING) {
+            continue;
+        }
+        if (state == MirlibClient::REQUEST_DONE) {
+            slot.job->state = JOB_DONE;
+        } else {
+            slot.job->state = JOB_FAILED;
+            slot.job->error = slot.client->getLastError();
+        }
+        slot.job = nullptr;
+    }
+
+    // Задания свободным клиентам
+    for (uint8_t i = 0; i < m_count; i++) {
+        Slot &slot = m_slots[i];
+        const uint8_t channel = slot.client->getChannel();
+        while (slot.job == nullptr && channelFree(channel, millis())) {
+            Job *job = nextJob(jobs, count, channel);
+            if (job == nullptr) {
+                break;
+            }
+
+            job->client = i;
+            if (!slot.client->startCommand(job->command, job->meterAddress)) {
+                job->state = JOB_FAILED;
+                job->error = slot.client->getLastError();
+                continue;
+            }
+            job->state = JOB_ACTIVE;
+            slot.job = job;
+            slot.startTime = millis();
+            slot.startChannel = channel;
+            slot.started = true;
+        }
+    }
+
+    bool finished = true;
+    for (size_t i = 0; i < count; i++) {
+        Job &job = jobs[i];
+        if (job.state == JOB_QUEUED && job.channel != ANY_CHANNEL && !hasChannel(job.channel)) {
+            // Счетчик на канале, которого нет ни у одного клиента
+            job.state = JOB_FAILED;
+            job.error = ERR_NO_CLIENT_ON_CHANNEL;
+        }
+        if (job.state == JOB_QUEUED || job.state == JOB_ACTIVE) {
+            finished = false;
+        }
+    }
+    return finished;
+}
+
+size_t MirlibClientPool::run(Job *jobs, size_t count) {
+    while (!poll(jobs, count)) {
+        yield();
+    }
+
+    size_t done = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (jobs[i].state == JOB_DONE) {
+            done++;
+        }
+    }
+    return done;
+}
+
+bool MirlibClientPool::channelFree(uint8_t channel, uint32_t now) const {
+    for (uint8_t i = 0; i < m_count; i++) {
+        const Slot &slot = m_slots[i];
+        if (m_channelGuardMs == 0) {
+            // Канал занят, пока на нем есть незавершенный запрос
+            if (slot.job != nullptr && slot.client->getChannel() == channel) {
+                return false;
+            }
+        } else if (slot.started && slot.startChannel == channel && now - slot.startTime < m_channelGuardMs) {
+            // Интервал отсчитывается от последней отправки на канале, даже если запрос уже завершен
+            return false;
+        }
+    }
+    return true;
+}
+
+MirlibClientPool::Job *MirlibClientPool::nextJob(Job *jobs, size_t count, uint8_t channel) const {
+    for (size_t i = 0; i < count; i++) {
+        if (jobs[i].state == JOB_QUEUED && (jobs[i].channel == ANY_CHANNEL || jobs[i].channel == channel)) {
+            return &jobs[i];
+        }
+    }
+    return nullptr;
+}
+
+bool MirlibClientPool::hasChannel(uint16_t channel) const {
+    for (uint8_t i = 0; i < m_count; i++) {
+        if (m_slots[i].client->getChannel() == channel) {
+            return true;
+        }
+    }
+    return false;
+}
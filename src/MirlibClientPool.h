@@ -0,0 +1,134 @@
+#ifndef MIRLIB_CLIENT_POOL_H
+#define MIRLIB_CLIENT_POOL_H
+
+#include "MirlibClient.h"
+
+/**
+ * @brief Наибольшее количество клиентов (радиомодулей) в пуле
+ */
+#ifndef MIRLIB_POOL_SIZE
+  #define MIRLIB_POOL_SIZE 4
+#endif
+
+/**
+ * @brief Параллельный опрос счетчиков несколькими радиомодулями
+ *
+ * Каждый клиент пула работает со своим радиомодулем (RadioBackend) и ведет свой
+ * запрос без блокировки (startCommand / pollCommand). Пул раздает задания опроса
+ * свободным клиентам и проверяет ответы всех клиентов по очереди.
+ *
+ * Клиенты на разных каналах работают параллельно. На одном канале запросы
+ * разделяются по времени: без защитного интервала (по умолчанию) канал занят
+ * одним запросом до ответа или таймаута; с интервалом следующий запрос на канале
+ * отправляется не раньше, чем через интервал после предыдущей отправки на этом канале
+ * (даже если тот запрос уже завершен).
+ */
+class MirlibClientPool {
+public:
+    /**
+     * @brief Состояние задания опроса
+     */
+    enum JobState {
+        JOB_QUEUED, ///< Ожидает свободного клиента
+        JOB_ACTIVE, ///< Запрос отправлен, ответ ожидается
+        JOB_DONE, ///< Ответ получен и разобран командой
+        JOB_FAILED ///< Запрос не выполнен (error)
+    };
+
+    /**
+     * @brief Канал задания: счетчик доступен любому клиенту (вне диапазона CHANNR 0..255)
+     */
+    static const uint16_t ANY_CHANNEL = 0x100;
+
+    /**
+     * @brief Задание опроса: команда одному счетчику
+     */
+    struct Job {
+        BaseCommand *command; ///< Команда; ответ разбирается в нее, поэтому у каждого задания своя
+        uint16_t meterAddress; ///< Адрес счетчика
+        uint16_t channel; ///< Канал счетчика 0..255 (ANY_CHANNEL - любой клиент)
+        JobState state;
+        ErrorCode error; ///< Ошибка для JOB_FAILED
+        uint8_t client; ///< Индекс клиента, выполнившего задание
+
+        Job() : command(nullptr), meterAddress(0), channel(ANY_CHANNEL), state(JOB_QUEUED), error(ERR_NONE), client(0) {}
+
+        Job(BaseCommand *jobCommand, uint16_t jobMeterAddress, uint16_t jobChannel = ANY_CHANNEL)
+            : command(jobCommand), meterAddress(jobMeterAddress), channel(jobChannel), state(JOB_QUEUED),
+              error(ERR_NONE), client(0) {}
+    };
+
+    MirlibClientPool();
+
+    /**
+     * @brief Добавить клиента (после begin и настройки канала)
+     * @param client Клиент со своим радиомодулем
+     * @return false если пул заполнен (MIRLIB_POOL_SIZE)
+     */
+    bool addClient(MirlibClient &client);
+
+    /**
+     * @brief Количество клиентов в пуле
+     */
+    uint8_t size() const { return m_count; }
+
+    /**
+     * @brief Клиент пула по индексу
+     */
+    MirlibClient &client(uint8_t index) { return *m_slots[index].client; }
+
+    /**
+     * @brief Защитный интервал между запросами на одном канале
+     * @param guardMs Интервал в мс (0 - один запрос на канале до завершения)
+     */
+    void setChannelGuard(uint16_t guardMs) { m_channelGuardMs = guardMs; }
+
+    /**
+     * @brief Шаг опроса без блокировки: проверить ответы, раздать задания свободным клиентам
+     * Массив заданий передается один и тот же, пока poll не вернет true. Задание на канале,
+     * которого нет ни у одного клиента, завершается с ERR_NO_CLIENT_ON_CHANNEL
+     * @param jobs Задания
+     * @param count Количество заданий
+     * @return true если все задания завершены
+     */
+    bool poll(Job *jobs, size_t count);
+
+    /**
+     * @brief Выполнить все задания
+     * @param jobs Задания
+     * @param count Количество заданий
+     * @return Количество успешно выполненных заданий
+     */
+    size_t run(Job *jobs, size_t count);
+
+private:
+    struct Slot {
+        MirlibClient *client;
+        Job *job; ///< Текущее задание (nullptr - клиент свободен)
+        uint32_t startTime; ///< Время отправки последнего запроса
+        uint8_t startChannel; ///< Канал последнего запроса
+        bool started; ///< Клиент уже отправлял запрос (startTime и startChannel заданы)
+    };
+
+    Slot m_slots[MIRLIB_POOL_SIZE];
+    uint8_t m_count;
+    uint16_t m_channelGuardMs;
+
+    /**
+     * @brief Проверить, можно ли отправить запрос на канале
+     */
+    bool channelFree(uint8_t channel, uint32_t now) const;
+
+    /**
+     * @brief Найти задание для свободного клиента
+     * @return nullptr если подходящих заданий нет
+     */
+    Job *nextJob(Job *jobs, size_t count, uint8_t channel) const;
+
+    /**
+     * @brief Проверить, есть ли в пуле клиент на канале
+     */
+    bool hasChannel(uint16_t channel) const;
+};
+
+#endif // MIRLIB_CLIENT_POOL_H
@@ -18,6 +18,13 @@
   #error "Mirlib: неподдерживаемая платформа!"
 #endif
 
+// Размещение обработчиков прерываний (на ESP32 - в IRAM)
+#if defined(MIRLIB_PLATFORM_ESP32)
+  #define MIRLIB_ISR_ATTR IRAM_ATTR
+#else
+  #define MIRLIB_ISR_ATTR
+#endif
+
 // Реализации для Arduino AVR (UNO/NANO)
 #ifdef MIRLIB_PLATFORM_AVR
 
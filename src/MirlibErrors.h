@@ -35,6 +35,14 @@ enum ErrorCode {
     ERR_COMMAND_HANDLER_FAILED = 13,
     // Не удалось отправить ответ
     ERR_FAILED_TO_SEND_RESPONSE = 14,
+    // Готовый кадр запроса не соответствует команде или адресу клиента
+    ERR_STATIC_FRAME_MISMATCH = 15,
+    // Не удалось включить прием по прерыванию GDO0
+    ERR_RECEIVE_INTERRUPT_UNAVAILABLE = 16,
+    // Клиент занят запросом без блокировки
+    ERR_CLIENT_BUSY = 17,
+    // В пуле нет клиента на канале счетчика
+    ERR_NO_CLIENT_ON_CHANNEL = 18,
 };
 
 #endif //MIRLIBERRORS_H
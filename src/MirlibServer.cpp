@@ -1,7 +1,8 @@
 #include "MirlibServer.h"
 
-MirlibServer::MirlibServer(uint16_t deviceAddress, Generation serverGeneration)
-    : MirlibBase(deviceAddress), m_serverGeneration(serverGeneration), m_commandHandlers(nullptr) {
+MirlibServer::MirlibServer(uint16_t deviceAddress, Generation serverGeneration, RadioBackend *radio)
+    : MirlibBase(deviceAddress, radio), m_serverGeneration(serverGeneration), m_encodingKey(0),
+      m_commandHandlers(nullptr) {
     registerDefaultHandlers();
 }
 
@@ -10,14 +11,20 @@ MirlibServer::~MirlibServer() {
 }
 
 bool MirlibServer::processIncomingPackets() {
-    PacketData packet;
-    if (!receivePacketOriginalStyle(packet, 100)) {
+    // Пакеты для других адресов отбрасываются по заголовку, до снятия стаффинга и проверки CRC
+    PacketFilter filter;
+    filter.dest = AddressFilter::single(m_deviceAddress);
+    filter.dest.acceptBroadcast = true;
+
+    uint8_t frame[ProtocolConstants::MAX_PACKET_SIZE];
+    PacketView packet;
+    if (!receiveFrame(frame, packet, 100, &filter, m_encodingKey)) {
         // Короткий таймаут для неблокирующей работы
         return false; // Пакет не получен (не является ошибкой)
     }
 
     #ifdef MIRLIB_DEBUG
-        debugPrintPacket(packet, "Получен запрос");
+        ProtocolUtils::printHex(packet.frame(), packet.frameSize(), "Получен запрос");
     #endif
 
     return handleServerPacket(packet);
@@ -32,10 +39,26 @@ void MirlibServer::registerCommandHandler(
     newHandler->commandCode = commandCode;
     newHandler->handlerFunc = handlerFunc;
     newHandler->context = context;
-    newHandler->next = m_commandHandlers;
+    addCommandHandler(newHandler);
+}
+
+void MirlibServer::registerCommandHandler(
+    uint8_t commandCode,
+    bool (*handlerFunc)(const PacketView &, PacketData &, void *),
+    void *context
+  ) {
+    auto *newHandler = new CommandHandler();
+    newHandler->commandCode = commandCode;
+    newHandler->viewHandlerFunc = handlerFunc;
+    newHandler->context = context;
+    addCommandHandler(newHandler);
+}
+
+void MirlibServer::addCommandHandler(CommandHandler *handler) {
+    handler->next = m_commandHandlers;
 
     // Добавляем в начало списка
-    m_commandHandlers = newHandler;
+    m_commandHandlers = handler;
 }
 
 CommandHandler *MirlibServer::findCommandHandler(uint8_t commandCode) {
@@ -59,7 +82,7 @@ void MirlibServer::clearCommandHandlers() {
     m_commandHandlers = nullptr;
 }
 
-bool MirlibServer::handleServerPacket(const PacketData &packet) {
+bool MirlibServer::handleServerPacket(const PacketView &packet) {
     // Проверка пакета
     if (!packet.isRequest()) {
         setError(ERR_PACKAGE_IS_NO_REQUEST);
@@ -67,15 +90,16 @@ bool MirlibServer::handleServerPacket(const PacketData &packet) {
     }
 
     // Проверка адресации пакета (для нас или широковещательный)
-    if (packet.destAddress != m_deviceAddress &&
-        packet.destAddress != ProtocolConstants::ADDR_CLIENT) {
+    uint16_t const destAddress = packet.destAddress();
+    if (destAddress != m_deviceAddress &&
+        destAddress != ProtocolConstants::ADDR_CLIENT) {
         // Пакет не для нас, игнорируем молча
         return false;
     }
 
     // Поиск обработчика команды
-    const CommandHandler *handler = findCommandHandler(packet.command);
-    if ((handler == nullptr) || (handler->handlerFunc == nullptr)) {
+    const CommandHandler *handler = findCommandHandler(packet.command());
+    if ((handler == nullptr) || (handler->handlerFunc == nullptr && handler->viewHandlerFunc == nullptr)) {
         setError(ERR_NO_HAVE_HANDLER_FOR_THIS_COMMAND);
         return false;
     }
@@ -84,13 +108,23 @@ bool MirlibServer::handleServerPacket(const PacketData &packet) {
     PacketData responsePacket;
 
     // Вызов обработчика команды
-    if (!handler->handlerFunc(packet, responsePacket, handler->context)) {
+    bool handled;
+    if (handler->viewHandlerFunc != nullptr) {
+        handled = handler->viewHandlerFunc(packet, responsePacket, handler->context);
+    } else {
+        // Обработчик со старой сигнатурой - нужен PacketData запроса
+        PacketData request;
+        handled = packet.toPacketData(request, m_encodingKey) &&
+                  handler->handlerFunc(request, responsePacket, handler->context);
+    }
+
+    if (!handled) {
         setError(ERR_COMMAND_HANDLER_FAILED);
         return false;
     }
 
     // Отправка ответа (если это не широковещательная команда)
-    if (packet.destAddress != ProtocolConstants::ADDR_CLIENT) {
+    if (destAddress != ProtocolConstants::ADDR_CLIENT) {
         if (!sendResponse(packet, responsePacket)) {
             setError(ERR_FAILED_TO_SEND_RESPONSE);
             return false;
@@ -104,12 +138,12 @@ bool MirlibServer::handleServerPacket(const PacketData &packet) {
     return true;
 }
 
-bool MirlibServer::sendResponse(const PacketData &originalPacket, const PacketData &responseData) {
+bool MirlibServer::sendResponse(const PacketView &originalPacket, const PacketData &responseData) {
     PacketData responsePacket;
 
     if (!ProtocolUtils::createResponsePacket(originalPacket, m_status,
                                              responseData.data, responseData.dataSize,
-                                             responsePacket)) {
+                                             responsePacket, m_encodingKey)) {
         return false;
     }
 
@@ -126,14 +160,14 @@ void MirlibServer::registerDefaultHandlers() {
 }
 
 // Статические обработчики команд
-bool MirlibServer::handlePingCommand(const PacketData &request, PacketData &response, void *context) {
+bool MirlibServer::handlePingCommand(const PacketView &request, PacketData &response, void *context) {
     MirlibServer *mirlibServer = (MirlibServer *)context;
 
     PingCommand cmd;
     cmd.setServerResponse(0x0100, mirlibServer->m_deviceAddress); // Пример версии прошивки
 
     uint8_t responseData[4];
-    size_t responseSize = cmd.handleRequest(request.data, request.dataSize,
+    size_t responseSize = cmd.handleRequest(request.data(), request.dataSize(),
                                             responseData, sizeof(responseData));
     if (responseSize == 0) {
         return false;
@@ -144,7 +178,7 @@ bool MirlibServer::handlePingCommand(const PacketData &request, PacketData &resp
     return true;
 }
 
-bool MirlibServer::handleGetInfoCommand(const PacketData &request, PacketData &response, void *context) {
+bool MirlibServer::handleGetInfoCommand(const PacketView &request, PacketData &response, void *context) {
     MirlibServer *mirlibServer = (MirlibServer *)context;
 
     GetInfoCommand cmd;
@@ -185,7 +219,7 @@ bool MirlibServer::handleGetInfoCommand(const PacketData &request, PacketData &r
     cmd.setServerResponse(info);
 
     uint8_t responseData[31];
-    size_t responseSize = cmd.handleRequest(request.data, request.dataSize,
+    size_t responseSize = cmd.handleRequest(request.data(), request.dataSize(),
                                             responseData, sizeof(responseData));
     if (responseSize == 0) {
         return false;
@@ -196,7 +230,7 @@ bool MirlibServer::handleGetInfoCommand(const PacketData &request, PacketData &r
     return true;
 }
 
-bool MirlibServer::handleReadDateTimeCommand(const PacketData &request, PacketData &response, void *context) {
+bool MirlibServer::handleReadDateTimeCommand(const PacketView &request, PacketData &response, void *context) {
     ReadDateTimeCommand cmd;
 
     ReadDateTimeResponse dateTime;
@@ -211,7 +245,7 @@ bool MirlibServer::handleReadDateTimeCommand(const PacketData &request, PacketDa
     cmd.setServerResponse(dateTime);
 
     uint8_t responseData[7];
-    size_t responseSize = cmd.handleRequest(request.data, request.dataSize,
+    size_t responseSize = cmd.handleRequest(request.data(), request.dataSize(),
                                             responseData, sizeof(responseData));
     if (responseSize == 0) {
         return false;
@@ -222,7 +256,7 @@ bool MirlibServer::handleReadDateTimeCommand(const PacketData &request, PacketDa
     return true;
 }
 
-bool MirlibServer::handleReadStatusCommand(const PacketData &request, PacketData &response, void *context) {
+bool MirlibServer::handleReadStatusCommand(const PacketView &request, PacketData &response, void *context) {
     MirlibServer *mirlibServer = (MirlibServer *)context;
 
     ReadStatusCommand cmd;
@@ -242,7 +276,7 @@ bool MirlibServer::handleReadStatusCommand(const PacketData &request, PacketData
             break;
     }
 
-    cmd.setGeneration(boardId, 0x32);
+    cmd.setGeneration(boardId, BoardCapabilities::ROLE_THRESHOLD);
 
     if (cmd.isOldGeneration()) {
         // Создание ответа старого поколения
@@ -260,8 +294,8 @@ bool MirlibServer::handleReadStatusCommand(const PacketData &request, PacketData
         // Создание ответа нового поколения
         ReadStatusResponseNew newResponse;
         newResponse.energyType = ACTIVE_FORWARD;
-        if (request.dataSize > 0) {
-            newResponse.energyType = static_cast<EnergyType>(request.data[0]);
+        if (request.dataSize() > 0) {
+            newResponse.energyType = static_cast<EnergyType>(request.data()[0]);
         }
         newResponse.configByte.fromByte(0x03);
         newResponse.voltageTransformCoeff = 1;
@@ -275,7 +309,7 @@ bool MirlibServer::handleReadStatusCommand(const PacketData &request, PacketData
     }
 
     uint8_t responseData[31];
-    size_t responseSize = cmd.handleRequest(request.data, request.dataSize,
+    size_t responseSize = cmd.handleRequest(request.data(), request.dataSize(),
                                             responseData, sizeof(responseData));
     if (responseSize == 0) {
         return false;
@@ -286,7 +320,7 @@ bool MirlibServer::handleReadStatusCommand(const PacketData &request, PacketData
     return true;
 }
 
-bool MirlibServer::handleReadInstantValueCommand(const PacketData &request, PacketData &response, void *context) {
+bool MirlibServer::handleReadInstantValueCommand(const PacketView &request, PacketData &response, void *context) {
     MirlibServer *mirlibServer = (MirlibServer *)context;
 
     // Старое поколение не поддерживает эту команду
@@ -308,12 +342,12 @@ bool MirlibServer::handleReadInstantValueCommand(const PacketData &request, Pack
             break;
     }
 
-    cmd.setGeneration(boardId, 0x32);
+    cmd.setGeneration(boardId, BoardCapabilities::ROLE_THRESHOLD);
 
     // Разбор запроса для получения группы параметров
     ParameterGroup group = GROUP_BASIC; // По умолчанию
-    if (request.dataSize > 0) {
-        group = static_cast<ParameterGroup>(request.data[0]);
+    if (request.dataSize() > 0) {
+        group = static_cast<ParameterGroup>(request.data()[0]);
     }
     cmd.setRequest(group);
 
@@ -370,7 +404,7 @@ bool MirlibServer::handleReadInstantValueCommand(const PacketData &request, Pack
     }
 
     uint8_t responseData[32]; // Максимальный размер для любого поколения
-    size_t responseSize = cmd.handleRequest(request.data, request.dataSize,
+    size_t responseSize = cmd.handleRequest(request.data(), request.dataSize(),
                                             responseData, sizeof(responseData));
     if (responseSize == 0) {
         return false;
@@ -15,10 +15,11 @@
 struct CommandHandler {
     uint8_t commandCode;
     bool (*handlerFunc)(const PacketData &request, PacketData &response, void *context);
+    bool (*viewHandlerFunc)(const PacketView &request, PacketData &response, void *context); ///< Обработчик без PacketData запроса
     void *context;
     CommandHandler *next;
 
-    CommandHandler() : commandCode(0), handlerFunc(nullptr), context(nullptr), next(nullptr) {}
+    CommandHandler() : commandCode(0), handlerFunc(nullptr), viewHandlerFunc(nullptr), context(nullptr), next(nullptr) {}
 };
 
 /**
@@ -33,8 +34,10 @@ public:
      * @brief Конструктор
      * @param deviceAddress Адрес счетчика (0x0001-0xFDE8)
      * @param serverGeneration Поколение для имитации (по умолчанию NEW_GENERATION)
+     * @param radio Радиомодуль (nullptr - ElechouseRadio)
      */
-    explicit MirlibServer(uint16_t deviceAddress = 0x0001, Generation serverGeneration = NEW_GENERATION);
+    explicit MirlibServer(uint16_t deviceAddress = 0x0001, Generation serverGeneration = NEW_GENERATION,
+                          RadioBackend *radio = nullptr);
 
     /**
      * @brief Деструктор
@@ -49,6 +52,7 @@ public:
 
     /**
      * @brief Зарегистрировать обработчик команд
+     * Метаданные приема запроса (RSSI, LQI, отметка времени) - в request.metadata
      * @param commandCode Код команды (0x01, 0x05, 0x30, и т.д.)
      * @param handlerFunc Функция обработчика команды
      * @param context Контекст для передачи в обработчик
@@ -57,6 +61,18 @@ public:
                                 bool (*handlerFunc)(const PacketData &, PacketData &, void *),
                                 void *context = nullptr);
 
+    /**
+     * @brief Зарегистрировать обработчик команд, работающий напрямую с кадром запроса
+     * Запрос передается как PacketView, PacketData для запроса не создается.
+     * Метаданные приема запроса - request.metadata()
+     * @param commandCode Код команды (0x01, 0x05, 0x30, и т.д.)
+     * @param handlerFunc Функция обработчика команды
+     * @param context Контекст для передачи в обработчик
+     */
+    void registerCommandHandler(uint8_t commandCode,
+                                bool (*handlerFunc)(const PacketView &, PacketData &, void *),
+                                void *context = nullptr);
+
     /**
      * @brief Установить поколение сервера для ответов
      * @param generation Поколение сервера для имитации
@@ -69,26 +85,40 @@ public:
      */
     Generation getServerGeneration() const { return m_serverGeneration; }
 
+    /**
+     * @brief Установить ключ кодирования данных
+     * Закодированные запросы (params.encoding = 1) декодируются этим ключом, ответы на них кодируются им же
+     * @param key Ключ
+     */
+    void setEncodingKey(uint32_t key) { m_encodingKey = key; }
+
 private:
     Generation m_serverGeneration;
+    uint32_t m_encodingKey;
 
     // Связный список обработчиков команд вместо std::map
     CommandHandler *m_commandHandlers;
 
     /**
      * @brief Обработать полученный пакет в режиме сервера
-     * @param packet Полученный пакет
+     * @param packet Полученный кадр
      * @return true если пакет был обработан
      */
-    bool handleServerPacket(const PacketData &packet);
+    bool handleServerPacket(const PacketView &packet);
 
     /**
      * @brief Отправить пакет ответа в режиме сервера
-     * @param originalPacket Исходный пакет запроса
+     * @param originalPacket Исходный кадр запроса
      * @param responseData Данные ответа
      * @return true если ответ отправлен
      */
-    bool sendResponse(const PacketData &originalPacket, const PacketData &responseData);
+    bool sendResponse(const PacketView &originalPacket, const PacketData &responseData);
+
+    /**
+     * @brief Добавить обработчик в начало списка
+     * @param handler Новый обработчик
+     */
+    void addCommandHandler(CommandHandler *handler);
 
     /**
      * @brief Найти обработчик команды
@@ -108,11 +138,11 @@ private:
     void registerDefaultHandlers();
 
     // Статические обработчики для команд по умолчанию
-    static bool handlePingCommand(const PacketData &request, PacketData &response, void *context);
-    static bool handleGetInfoCommand(const PacketData &request, PacketData &response, void *context);
-    static bool handleReadDateTimeCommand(const PacketData &request, PacketData &response, void *context);
-    static bool handleReadStatusCommand(const PacketData &request, PacketData &response, void *context);
-    static bool handleReadInstantValueCommand(const PacketData &request, PacketData &response, void *context);
+    static bool handlePingCommand(const PacketView &request, PacketData &response, void *context);
+    static bool handleGetInfoCommand(const PacketView &request, PacketData &response, void *context);
+    static bool handleReadDateTimeCommand(const PacketView &request, PacketData &response, void *context);
+    static bool handleReadStatusCommand(const PacketView &request, PacketData &response, void *context);
+    static bool handleReadInstantValueCommand(const PacketView &request, PacketData &response, void *context);
 };
 
 #endif // MIRLIB_SERVER_H
\ No newline at end of file
@@ -0,0 +1,129 @@
+#include "PacketDeframer.h"
+
+PacketDeframer::PacketDeframer(PacketCallback callback, void *context)
+    : m_callback(callback)
+      , m_context(context)
+      , m_copyRaw(false)
+      , m_filter(nullptr)
+      , m_state(STATE_HUNT)
+      , m_marker(false)
+      , m_frameSize(0)
+      , m_packetsDecoded(0)
+      , m_framesRejected(0)
+      , m_framesFiltered(0)
+      , m_framesOverflowed(0)
+      , m_resyncs(0)
+{
+}
+
+size_t PacketDeframer::feed(const uint8_t *data, size_t size) {
+    if (data == nullptr) {
+        return 0;
+    }
+
+    size_t emitted = 0;
+    for (size_t i = 0; i < size; i++) {
+        if (feedByte(data[i])) {
+            emitted++;
+        }
+    }
+    return emitted;
+}
+
+bool PacketDeframer::feedByte(uint8_t value) {
+    switch (m_state) {
+        case STATE_HUNT:
+            if (value == ProtocolConstants::START1) {
+                m_state = STATE_START;
+            }
+            return false;
+
+        case STATE_START:
+            if (value == ProtocolConstants::START2) {
+                beginFrame();
+            } else if (value != ProtocolConstants::START1) {
+                m_state = STATE_HUNT;
+            }
+            return false;
+
+        case STATE_BODY:
+        default:
+            break;
+    }
+
+    if (value == ProtocolConstants::STOP) {
+        if (m_marker) {
+            // 0x73 0x55 is never valid stuffing: a new frame started
+            m_resyncs++;
+            beginFrame();
+            return false;
+        }
+
+        // Body never exceeds MAX_PACKET_SIZE - 1, so STOP always fits
+        bool const startCandidate = m_frame[m_frameSize - 1] == ProtocolConstants::START1;
+        m_frame[m_frameSize++] = value;
+        m_state = STATE_HUNT;
+        if (completeFrame()) {
+            return true;
+        }
+
+        // Frame rejected and ended with 0x73 0x55: that may be the start of the next frame
+        if (startCandidate) {
+            m_resyncs++;
+            beginFrame();
+        }
+        return false;
+    }
+
+    // Reserve the last byte for STOP
+    if (m_frameSize >= ProtocolConstants::MAX_PACKET_SIZE - 1) {
+        m_framesOverflowed++;
+        m_state = (value == ProtocolConstants::START1) ? STATE_START : STATE_HUNT;
+        return false;
+    }
+
+    m_frame[m_frameSize++] = value;
+    m_marker = (value == ProtocolConstants::STUFF_MARKER) && !m_marker;
+    return false;
+}
+
+void PacketDeframer::reset() {
+    m_state = STATE_HUNT;
+    m_marker = false;
+    m_frameSize = 0;
+}
+
+void PacketDeframer::resetStats() {
+    m_packetsDecoded = 0;
+    m_framesRejected = 0;
+    m_framesFiltered = 0;
+    m_framesOverflowed = 0;
+    m_resyncs = 0;
+}
+
+void PacketDeframer::beginFrame() {
+    m_frame[0] = ProtocolConstants::START1;
+    m_frame[1] = ProtocolConstants::START2;
+    m_frameSize = 2;
+    m_marker = false;
+    m_state = STATE_BODY;
+}
+
+bool PacketDeframer::completeFrame() {
+    if (m_filter != nullptr && !ProtocolUtils::matchHeader(m_frame, m_frameSize, *m_filter)) {
+        m_framesFiltered++;
+        return false;
+    }
+
+    PacketData packet;
+    if (!ProtocolUtils::decodePacket(m_frame, m_frameSize, packet, m_copyRaw)) {
+        m_framesRejected++;
+        return false;
+    }
+
+    m_packetsDecoded++;
+    if (m_callback != nullptr) {
+        m_callback(packet, m_context);
+    }
+    return true;
+}
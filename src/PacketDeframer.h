@@ -0,0 +1,125 @@
+#ifndef PACKET_DEFRAMER_H
+#define PACKET_DEFRAMER_H
+
+#include <Arduino.h>
+#include "ProtocolTypes.h"
+#include "ProtocolUtils.h"
+#include "PacketFilter.h"
+
+/**
+ * @brief Incremental deframer: arbitrary byte stream -> PacketData
+ *
+ * Accepts chunks of any size and keeps its state between calls. Frames are
+ * delimited by START1 START2 ... STOP; since 0x55 is always stuffed inside a
+ * frame, the first unescaped 0x55 ends it, while 0x73 0x55 inside a frame
+ * means a new frame started (resynchronisation after corruption).
+ * At most one frame (MAX_PACKET_SIZE bytes) is buffered.
+ */
+class PacketDeframer {
+public:
+    /**
+     * @brief Callback for completed packets
+     * @param packet Decoded packet
+     * @param context User context
+     */
+    typedef void (*PacketCallback)(const PacketData &packet, void *context);
+
+    /**
+     * @brief Constructor
+     * @param callback Callback for completed packets
+     * @param context Context passed to the callback
+     */
+    explicit PacketDeframer(PacketCallback callback = nullptr, void *context = nullptr);
+
+    /**
+     * @brief Set callback for completed packets
+     * @param callback Callback function
+     * @param context Context passed to the callback
+     */
+    void setCallback(PacketCallback callback, void *context = nullptr) {
+        m_callback = callback;
+        m_context = context;
+    }
+
+    /**
+     * @brief Copy raw frames into PacketData::rawPacket before emitting
+     * @param copyRaw true to copy raw frames (default: false)
+     */
+    void setCopyRaw(bool copyRaw) { m_copyRaw = copyRaw; }
+
+    /**
+     * @brief Drop frames whose header does not match before decoding them
+     * @param filter Header filter (not copied, nullptr to accept all)
+     */
+    void setFilter(const PacketFilter *filter) { m_filter = filter; }
+
+    /**
+     * @brief Feed a chunk of the byte stream
+     * @param data Input bytes
+     * @param size Number of bytes
+     * @return Number of packets emitted while processing this chunk
+     */
+    size_t feed(const uint8_t *data, size_t size);
+
+    /**
+     * @brief Feed a single byte of the byte stream
+     * @param value Input byte
+     * @return true if a packet was emitted
+     */
+    bool feedByte(uint8_t value);
+
+    /**
+     * @brief Drop any partially received frame
+     */
+    void reset();
+
+    /**
+     * @brief Statistics
+     */
+    uint32_t getPacketsDecoded() const { return m_packetsDecoded; } ///< Frames decoded and emitted
+    uint32_t getFramesRejected() const { return m_framesRejected; } ///< Frames failing decode (CRC/format)
+    uint32_t getFramesFiltered() const { return m_framesFiltered; } ///< Frames dropped by the header filter
+    uint32_t getFramesOverflowed() const { return m_framesOverflowed; } ///< Frames longer than MAX_PACKET_SIZE
+    uint32_t getResyncs() const { return m_resyncs; } ///< Frames abandoned on a new START sequence
+
+    /**
+     * @brief Reset statistics counters
+     */
+    void resetStats();
+
+private:
+    enum State {
+        STATE_HUNT, ///< Waiting for START1
+        STATE_START, ///< Got START1, waiting for START2
+        STATE_BODY ///< Inside a frame, waiting for STOP
+    };
+
+    PacketCallback m_callback;
+    void *m_context;
+    bool m_copyRaw;
+    const PacketFilter *m_filter;
+
+    State m_state;
+    bool m_marker; ///< Last body byte was an unconsumed stuffing marker
+    uint8_t m_frame[ProtocolConstants::MAX_PACKET_SIZE];
+    size_t m_frameSize;
+
+    uint32_t m_packetsDecoded;
+    uint32_t m_framesRejected;
+    uint32_t m_framesFiltered;
+    uint32_t m_framesOverflowed;
+    uint32_t m_resyncs;
+
+    /**
+     * @brief Start a new frame with START1 START2 already received
+     */
+    void beginFrame();
+
+    /**
+     * @brief Decode buffered frame and emit it
+     * @return true if a packet was emitted
+     */
+    bool completeFrame();
+};
+
+#endif // PACKET_DEFRAMER_H
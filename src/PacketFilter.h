@@ -0,0 +1,141 @@
+#ifndef PACKET_FILTER_H
+#define PACKET_FILTER_H
+
+#include <Arduino.h>
+#include "ProtocolTypes.h"
+
+/**
+ * @brief Address matcher: any, single address, range or compact bitmap
+ */
+struct AddressFilter {
+    enum Mode : uint8_t {
+        MATCH_ANY = 0, ///< Every address matches
+        MATCH_SINGLE, ///< Only `first` matches
+        MATCH_RANGE, ///< first..last inclusive
+        MATCH_BITMAP ///< Bit (address - first) set in bitmap, for first..last
+    };
+
+    Mode mode; ///< Match mode
+    uint16_t first; ///< Single address / range start / bitmap base
+    uint16_t last; ///< Range end / last address covered by bitmap
+    const uint8_t *bitmap; ///< Bitmap, LSB first (not owned)
+    bool acceptBroadcast; ///< Also match ADDR_CLIENT (0xFFFF)
+
+    AddressFilter() : mode(MATCH_ANY), first(0), last(0), bitmap(nullptr), acceptBroadcast(false) {
+    }
+
+    /**
+     * @brief Match every address
+     */
+    static AddressFilter any() {
+        return AddressFilter();
+    }
+
+    /**
+     * @brief Match a single address
+     * @param address Address
+     */
+    static AddressFilter single(uint16_t address) {
+        AddressFilter filter;
+        filter.mode = MATCH_SINGLE;
+        filter.first = address;
+        filter.last = address;
+        return filter;
+    }
+
+    /**
+     * @brief Match an inclusive address range
+     * @param first First address
+     * @param last Last address
+     */
+    static AddressFilter range(uint16_t first, uint16_t last) {
+        AddressFilter filter;
+        filter.mode = MATCH_RANGE;
+        filter.first = first;
+        filter.last = last;
+        return filter;
+    }
+
+    /**
+     * @brief Match addresses whose bit is set in a bitmap
+     * @param bitmap Bitmap (count bits, LSB first), must outlive the filter
+     * @param first Address of bit 0
+     * @param count Number of addresses covered (must be > 0)
+     */
+    static AddressFilter fromBitmap(const uint8_t *bitmap, uint16_t first, uint16_t count) {
+        AddressFilter filter;
+        filter.mode = MATCH_BITMAP;
+        filter.first = first;
+        filter.last = first + (count - 1);
+        filter.bitmap = bitmap;
+        return filter;
+    }
+
+    /**
+     * @brief Check address against the filter
+     * @param address Address
+     * @return true if address matches
+     */
+    bool matches(uint16_t address) const {
+        if (acceptBroadcast && address == ProtocolConstants::ADDR_CLIENT) {
+            return true;
+        }
+
+        switch (mode) {
+            case MATCH_SINGLE:
+                return address == first;
+            case MATCH_RANGE:
+                return address >= first && address <= last;
+            case MATCH_BITMAP: {
+                if (address < first || address > last || bitmap == nullptr) {
+                    return false;
+                }
+                uint16_t const bit = address - first;
+                return (bitmap[bit >> 3] & (1 << (bit & 0x07))) != 0;
+            }
+            case MATCH_ANY:
+            default:
+                return true;
+        }
+    }
+};
+
+/**
+ * @brief Header filter for early rejection of foreign frames
+ *
+ * Checked against the first 7 unstuffed bytes (params, reserve, dest, src, command)
+ * before the payload is unstuffed and CRC-checked.
+ */
+struct PacketFilter {
+    AddressFilter dest; ///< Destination address matcher
+    AddressFilter src; ///< Source address matcher
+    bool matchCommand; ///< Check command code
+    uint8_t command; ///< Expected command code
+
+    PacketFilter() : matchCommand(false), command(0) {
+    }
+
+    /**
+     * @brief Require a command code
+     * @param commandCode Command code
+     */
+    void setCommand(uint8_t commandCode) {
+        matchCommand = true;
+        command = commandCode;
+    }
+
+    /**
+     * @brief Check header fields against the filter
+     * @param destAddress Destination address
+     * @param srcAddress Source address
+     * @param commandCode Command code
+     * @return true if header matches
+     */
+    bool matches(uint16_t destAddress, uint16_t srcAddress, uint8_t commandCode) const {
+        return (!matchCommand || commandCode == command) &&
+               dest.matches(destAddress) &&
+               src.matches(srcAddress);
+    }
+};
+
+#endif // PACKET_FILTER_H
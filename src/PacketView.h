@@ -0,0 +1,211 @@
+#ifndef PACKET_VIEW_H
+#define PACKET_VIEW_H
+
+#include <Arduino.h>
+#include "ProtocolTypes.h"
+#include "ProtocolUtils.h"
+
+/**
+ * @brief Non-owning view over a validated, unstuffed frame
+ *
+ * The frame layout is Parameters, Reserve, Dest(2), Src(2), Command,
+ * Password/Status(4), Data, CRC. Fields are decoded on access; the
+ * underlying buffer must outlive the view.
+ */
+class PacketView {
+public:
+    /**
+     * @brief Constructor (empty view)
+     */
+    PacketView() : m_frame(nullptr), m_frameSize(0) {
+    }
+
+    /**
+     * @brief Attach to an unstuffed, CRC-checked frame
+     * @param frame Frame buffer (from ProtocolUtils::unstuffFrame)
+     * @param frameSize Frame size from Parameters to CRC inclusive
+     * @return true if frame is long enough for its data length
+     */
+    bool attach(const uint8_t *frame, size_t frameSize) {
+        if (frame == nullptr || frameSize < ProtocolConstants::HEADER_SIZE + 1 ||
+            frameSize < ProtocolConstants::HEADER_SIZE + (frame[0] & 0x1F) + 1) {
+            reset();
+            return false;
+        }
+
+        m_frame = frame;
+        m_frameSize = frameSize;
+        return true;
+    }
+
+    /**
+     * @brief Unstuff and validate a raw frame, then attach to the result
+     *
+     * Data of encoded frames (params.encoding) is decoded in place after the
+     * CRC check, so data() is always plaintext.
+     * @param rawData Raw packet data (with start/stop bytes)
+     * @param rawSize Raw data size
+     * @param frame Output buffer (at least MAX_PACKET_SIZE bytes, may be rawData itself)
+     * @param encodingKey Keystream key for encoded frames
+     * @return true if frame is valid
+     */
+    bool decode(const uint8_t *rawData, size_t rawSize, uint8_t *frame, uint32_t encodingKey = 0) {
+        size_t frameSize = 0;
+        if (!ProtocolUtils::unstuffFrame(rawData, rawSize, frame, frameSize) || !attach(frame, frameSize)) {
+            reset();
+            return false;
+        }
+
+        if ((frame[0] & 0x80) != 0) {
+            ProtocolUtils::applyKeystream(frame + ProtocolConstants::HEADER_SIZE, dataSize(), encodingKey);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Detach from the frame
+     */
+    void reset() {
+        m_frame = nullptr;
+        m_frameSize = 0;
+        m_metadata = RxMetadata();
+    }
+
+    /**
+     * @brief Attach receive metadata (RSSI, LQI, sync timestamp) of the frame
+     */
+    void setMetadata(const RxMetadata &metadata) { m_metadata = metadata; }
+
+    /**
+     * @brief Receive metadata, zero for frames that did not come from the radio
+     */
+    const RxMetadata &metadata() const { return m_metadata; }
+
+    /**
+     * @brief Check if view is attached to a frame
+     */
+    bool isAttached() const { return m_frame != nullptr; }
+
+    /**
+     * @brief Parameters field
+     */
+    Parameters params() const {
+        Parameters params;
+        params.fromByte(m_frame[0]);
+        return params;
+    }
+
+    /**
+     * @brief Destination address
+     */
+    uint16_t destAddress() const { return ProtocolUtils::bytesToUint16(&m_frame[2]); }
+
+    /**
+     * @brief Source address
+     */
+    uint16_t srcAddress() const { return ProtocolUtils::bytesToUint16(&m_frame[4]); }
+
+    /**
+     * @brief Command code
+     */
+    uint8_t command() const { return m_frame[6]; }
+
+    /**
+     * @brief Password (request) or Status (response)
+     */
+    uint32_t passwordOrStatus() const { return ProtocolUtils::bytesToUint32(&m_frame[7]); }
+
+    /**
+     * @brief Data field
+     */
+    const uint8_t *data() const { return m_frame + ProtocolConstants::HEADER_SIZE; }
+
+    /**
+     * @brief Data field size
+     */
+    uint8_t dataSize() const { return m_frame[0] & 0x1F; }
+
+    /**
+     * @brief CRC8 checksum
+     */
+    uint8_t crc() const { return m_frame[ProtocolConstants::HEADER_SIZE + dataSize()]; }
+
+    /**
+     * @brief Check if this is a request packet
+     */
+    bool isRequest() const { return (m_frame[0] & 0x20) != 0; }
+
+    /**
+     * @brief Check if this is a response packet
+     */
+    bool isResponse() const { return (m_frame[0] & 0x20) == 0; }
+
+    /**
+     * @brief Underlying unstuffed frame
+     */
+    const uint8_t *frame() const { return m_frame; }
+
+    /**
+     * @brief Underlying unstuffed frame size
+     */
+    size_t frameSize() const { return m_frameSize; }
+
+    /**
+     * @brief Materialize the frame into PacketData, raw frame included
+     *
+     * The raw bytes are gone once the frame is unstuffed, so rawPacket is the
+     * received frame stuffed again as is: its own reserve byte and CRC, data
+     * re-encoded with the same key for encoded frames. No header is packed and
+     * no CRC is computed; crc always matches rawPacket, which passes isValid()
+     * and can be sent again.
+     * @param packet Output packet
+     * @param encodingKey Keystream key the frame was decoded with
+     * @return false if the view is empty or the stuffed frame does not fit rawPacket (rawSize is 0)
+     */
+    bool toPacketData(PacketData &packet, uint32_t encodingKey = 0) const {
+        packet.rawSize = 0;
+        packet.metadata = m_metadata;
+        if (m_frame == nullptr) {
+            return false;
+        }
+
+        packet.params = params();
+        packet.destAddress = destAddress();
+        packet.srcAddress = srcAddress();
+        packet.command = command();
+        packet.passwordOrStatus = passwordOrStatus();
+        packet.dataSize = dataSize();
+        packet.crc = crc();
+        memcpy(packet.data, data(), packet.dataSize);
+
+        // Header and data as sent on air (CRC is not stuffed)
+        const size_t bodySize = ProtocolConstants::HEADER_SIZE + packet.dataSize;
+        const uint8_t *body = m_frame;
+        uint8_t encoded[ProtocolConstants::HEADER_SIZE + ProtocolConstants::MAX_DATA_SIZE];
+        if (packet.params.encoding) {
+            memcpy(encoded, m_frame, bodySize);
+            ProtocolUtils::applyKeystream(encoded + ProtocolConstants::HEADER_SIZE, packet.dataSize, encodingKey);
+            body = encoded;
+        }
+
+        uint8_t *const raw = packet.rawPacket;
+        raw[0] = ProtocolConstants::START1;
+        raw[1] = ProtocolConstants::START2;
+        const size_t stuffed = ProtocolUtils::byteStuffing(body, bodySize, raw + 2,
+                                                           ProtocolConstants::MAX_PACKET_SIZE - 4);
+        if (stuffed == 0) {
+            return false;
+        }
+        raw[2 + stuffed] = packet.crc;
+        raw[3 + stuffed] = ProtocolConstants::STOP;
+        packet.rawSize = stuffed + 4;
+        return true;
+    }
+
+private:
+    const uint8_t *m_frame;
+    size_t m_frameSize;
+    RxMetadata m_metadata;
+};
+
+#endif // PACKET_VIEW_H
@@ -22,6 +22,8 @@ namespace ProtocolConstants {
     const size_t MAX_DATA_SIZE = 31; ///< Maximum data field size
     const size_t MAX_PACKET_SIZE = 64; ///< Maximum packet size after stuffing
     const size_t MIN_PACKET_SIZE = 10; ///< Minimum packet size
+    const size_t HEADER_SIZE = 11; ///< Params + reserve + dest(2) + src(2) + cmd + password/status(4)
+    const size_t FRAMING_SIZE = 3; ///< START1 + START2 + STOP
 
     // Special addresses
     const uint16_t ADDR_PRODUCTION = 0x0000; ///< Production address
@@ -143,6 +145,37 @@ enum BoardID : uint8_t {
     BOARD_NEW_22 = 0x22
 };
 
+/**
+ * @brief Receive metadata of a frame
+ *
+ * rssi and lqi are the status bytes the CC1101 appends to every received
+ * frame (PKTCTRL1.APPEND_STATUS); they are read from the FIFO together with
+ * the frame, without extra SPI transactions.
+ */
+struct RxMetadata {
+    uint32_t timestamp; ///< micros() at the sync word (GDO0 edge); in polling receive, when the frame was read
+    uint8_t rssi; ///< Raw RSSI (two's complement, 0.5 dB steps)
+    uint8_t lqi; ///< LQI (bits 6:0, lower is better) and CRC_OK (bit 7)
+
+    RxMetadata() : timestamp(0), rssi(0), lqi(0) {
+    }
+
+    /**
+     * @brief RSSI in dBm (RSSI offset 74 dB)
+     */
+    int16_t rssiDbm() const { return static_cast<int16_t>(static_cast<int8_t>(rssi) / 2 - 74); }
+
+    /**
+     * @brief Link quality indicator (0..127, lower is better)
+     */
+    uint8_t linkQuality() const { return lqi & 0x7F; }
+
+    /**
+     * @brief CC1101 CRC_OK flag (always set while CRC_EN is off, the frame CRC8 is checked separately)
+     */
+    bool crcOk() const { return (lqi & 0x80) != 0; }
+};
+
 /**
  * @brief Packet data structure
  */
@@ -165,6 +198,8 @@ struct PacketData {
     uint8_t rawPacket[ProtocolConstants::MAX_PACKET_SIZE]; ///< Raw packet bytes
     size_t rawSize; ///< Raw packet size
 
+    RxMetadata metadata; ///< Receive metadata (received packets only)
+
     /**
      * @brief Constructor
      */
@@ -222,6 +257,52 @@ struct PacketData {
         command = 0;
         passwordOrStatus = 0;
         crc = 0;
+        metadata = RxMetadata();
+    }
+};
+
+/**
+ * @brief Structure-of-arrays output of ProtocolUtils::decodeBatch
+ *
+ * All arrays are caller-owned. Column arrays hold at least `capacity`
+ * entries, `valid` holds (capacity + 7) / 8 bytes and `data` holds at least
+ * capacity * MAX_DATA_SIZE bytes. Rows of invalid frames are zeroed.
+ */
+struct PacketBatch {
+    // Columns
+    uint16_t *destAddress; ///< Destination address per frame
+    uint16_t *srcAddress; ///< Source address per frame
+    uint8_t *command; ///< Command code per frame
+    uint32_t *passwordOrStatus; ///< Password (request) or Status (response) per frame
+    uint32_t *dataOffset; ///< Offset of the data field in `data` per frame
+    uint8_t *dataLength; ///< Data field size per frame (0 for invalid frames)
+    uint8_t *valid; ///< Validity bitmap, bit (i & 7) of byte (i >> 3), LSB first
+
+    // Data fields of all frames, packed back to back
+    uint8_t *data;
+
+    size_t capacity; ///< Number of rows the arrays can hold
+
+    // Results
+    size_t count; ///< Frames decoded (rows written)
+    size_t validCount; ///< Frames that passed CRC and format checks
+    size_t bytesConsumed; ///< Input bytes consumed (resume point for the next call)
+
+    /**
+     * @brief Constructor (no storage attached)
+     */
+    PacketBatch()
+        : destAddress(nullptr), srcAddress(nullptr), command(nullptr), passwordOrStatus(nullptr),
+          dataOffset(nullptr), dataLength(nullptr), valid(nullptr), data(nullptr),
+          capacity(0), count(0), validCount(0), bytesConsumed(0) {
+    }
+
+    /**
+     * @brief Check validity bit of a row
+     * @param index Row index
+     */
+    bool isValid(size_t index) const {
+        return (valid[index >> 3] >> (index & 0x07)) & 0x01;
     }
 };
 
@@ -1,23 +1,28 @@
 #include "ProtocolUtils.h"
+#include "Crc8Engine.h"
+#include "StuffingEngine.h"
+#include "BoardCapabilities.h"
+#include "PacketView.h"
+#include "PacketFilter.h"
+
+// Keystream SIMD blocks (host builds), selected independently of the stuffing kernels
+#if defined(MIRLIB_PLATFORM_GCC) && !defined(MIRLIB_KEYSTREAM_NO_SIMD)
+  #if defined(__x86_64__) || (defined(__i386__) && defined(__SSE2__))
+    #define MIRLIB_KEYSTREAM_HAS_X86
+  #elif defined(__ARM_NEON) || defined(__aarch64__)
+    #define MIRLIB_KEYSTREAM_HAS_NEON
+  #endif
+#endif
+
+#if defined(MIRLIB_KEYSTREAM_HAS_X86)
+  #include <emmintrin.h>
+#elif defined(MIRLIB_KEYSTREAM_HAS_NEON)
+  #include <arm_neon.h>
+#endif
 
 uint8_t ProtocolUtils::calculateCRC8(const uint8_t *data, size_t length)
 {
-    uint8_t crc = ProtocolConstants::CRC_INITIAL;
-
-    for (size_t i = 0; i < length; i++) {
-        uint8_t dataByte = data[i];
-
-        for (int bit = 0; bit < 8; bit++) {
-            if (((dataByte ^ crc) & 0x80) == 0) {
-                crc = (crc << 1);
-            } else {
-                crc = ((crc << 1) ^ ProtocolConstants::CRC_POLYNOMIAL);
-            }
-            dataByte = (dataByte << 1);
-        }
-    }
-
-    return crc;
+    return Crc8Engine::calculate(data, length);
 }
 
 size_t ProtocolUtils::byteStuffing(
@@ -26,228 +31,467 @@ size_t ProtocolUtils::byteStuffing(
     uint8_t *output,
     const size_t outputMaxSize
 ) {
-    if ((input == nullptr) || (output == nullptr) || inputSize == 0) {
-        return 0;
-    }
+    return StuffingEngine::stuff(input, inputSize, output, outputMaxSize);
+}
 
-    size_t outputIndex = 0;
+size_t ProtocolUtils::byteUnstuffing(
+    const uint8_t *input,
+    size_t inputSize,
+    uint8_t *output,
+    size_t outputMaxSize
+) {
+    return StuffingEngine::unstuff(input, inputSize, output, outputMaxSize);
+}
 
-    for (size_t i = 0; i < inputSize; i++) {
-        if (outputIndex >= outputMaxSize - 1) {
-            // Reserve space for potential stuffing
-            return 0; // Not enough space
+namespace {
+    /**
+     * @brief Single-pass frame writer: running CRC + byte stuffing
+     */
+    struct StuffingWriter {
+        uint8_t *out; ///< Next output position
+        uint8_t *limit; ///< End of space available for stuffed bytes
+        uint8_t crc; ///< Running CRC over unstuffed bytes
+        bool checked; ///< Bounds checks required (worst case does not fit)
+        bool overflow; ///< Output did not fit
+
+        void put(uint8_t value) {
+            crc = Crc8Engine::updateByte(crc, value);
+            putRaw(value);
         }
 
-        uint8_t const currentByte = input[i];
-
-        if (currentByte == 0x55) {
-            // Replace 0x55 with 0x73 0x11
-            output[outputIndex++] = ProtocolConstants::STUFF_MARKER;
-            if (outputIndex >= outputMaxSize) {
-                return 0;
+        void putRaw(uint8_t value) {
+            if (value == 0x55 || value == 0x73) {
+                if (checked && out + 2 > limit) {
+                    overflow = true;
+                    return;
+                }
+                *out++ = ProtocolConstants::STUFF_MARKER;
+                *out++ = (value == 0x55) ? ProtocolConstants::STUFF_0x55 : ProtocolConstants::STUFF_0x73;
+            } else {
+                if (checked && out + 1 > limit) {
+                    overflow = true;
+                    return;
+                }
+                *out++ = value;
             }
-            output[outputIndex++] = ProtocolConstants::STUFF_0x55;
-        } else if (currentByte == 0x73) {
-            // Replace 0x73 with 0x73 0x22
-            output[outputIndex++] = ProtocolConstants::STUFF_MARKER;
-            if (outputIndex >= outputMaxSize) {
-                return 0;
+        }
+    };
+
+    /**
+     * @brief Sink writing decoded header fields and data into PacketData
+     */
+    struct PacketFieldSink {
+        PacketData *packet; ///< Output packet (only decoded fields are written)
+
+        void store(size_t index, uint8_t value) {
+            switch (index) {
+                case 0:
+                    packet->params.fromByte(value);
+                    break;
+                case 1: // Reserve
+                    break;
+                case 2:
+                    packet->destAddress = value;
+                    break;
+                case 3:
+                    packet->destAddress |= static_cast<uint16_t>(value) << 8;
+                    break;
+                case 4:
+                    packet->srcAddress = value;
+                    break;
+                case 5:
+                    packet->srcAddress |= static_cast<uint16_t>(value) << 8;
+                    break;
+                case 6:
+                    packet->command = value;
+                    break;
+                case 7:
+                    packet->passwordOrStatus = value;
+                    break;
+                case 8:
+                case 9:
+                case 10:
+                    packet->passwordOrStatus |= static_cast<uint32_t>(value) << (8 * (index - 7));
+                    break;
+                default:
+                    packet->data[index - ProtocolConstants::HEADER_SIZE] = value;
+                    break;
             }
-            output[outputIndex++] = ProtocolConstants::STUFF_0x73;
-        } else {
-            // Regular byte, copy as is
-            output[outputIndex++] = currentByte;
         }
-    }
 
-    return outputIndex;
-}
+        void storeCrc(size_t, uint8_t value) {
+            packet->crc = value;
+        }
+    };
 
-size_t ProtocolUtils::byteUnstuffing(
-    const uint8_t *input,
-    size_t inputSize,
-    uint8_t *output,
-    size_t outputMaxSize
-) {
-    if ((input == nullptr) || (output == nullptr) || inputSize == 0) {
-        return 0;
-    }
+    /**
+     * @brief Sink writing the unstuffed frame into a buffer (may alias the raw input)
+     */
+    struct FrameBufferSink {
+        uint8_t *frame; ///< Output buffer (MAX_PACKET_SIZE bytes)
 
-    size_t outputIndex = 0;
-    size_t inputIndex = 0;
+        void store(size_t index, uint8_t value) {
+            frame[index] = value;
+        }
 
-    while (inputIndex < inputSize && outputIndex < outputMaxSize) {
-        uint8_t const currentByte = input[inputIndex++];
+        void storeCrc(size_t index, uint8_t value) {
+            frame[index] = value;
+        }
+    };
+
+    /**
+     * @brief Unstuff a raw frame in a single forward scan, feeding the sink and checking CRC
+     *
+     * Same rules as byteUnstuffing + the former two-pass unpackPacket: output is
+     * capped at MAX_PACKET_SIZE, invalid escape pairs are kept as two bytes,
+     * bytes after CRC are scanned but ignored.
+     * @param rawData Raw frame (with start/stop bytes)
+     * @param rawSize Raw frame size
+     * @param sink Destination for unstuffed bytes up to and including CRC
+     * @param frameSize Unstuffed frame size up to and including CRC (output)
+     * @return true if framing is valid and CRC matches
+     */
+    template<typename Sink>
+    bool scanFrame(const uint8_t *rawData, size_t rawSize, Sink &sink, size_t &frameSize) {
+        if ((rawData == nullptr) || rawSize < ProtocolConstants::MIN_PACKET_SIZE) {
+            return false;
+        }
 
-        if (currentByte == ProtocolConstants::STUFF_MARKER && inputIndex < inputSize) {
-            uint8_t const nextByte = input[inputIndex++];
+        // Check start and stop bytes
+        if (rawData[0] != ProtocolConstants::START1 ||
+            rawData[1] != ProtocolConstants::START2 ||
+            rawData[rawSize - 1] != ProtocolConstants::STOP) {
+            return false;
+        }
 
-            if (nextByte == ProtocolConstants::STUFF_0x55) {
-                // 0x73 0x11 -> 0x55
-                output[outputIndex++] = 0x55;
-            } else if (nextByte == ProtocolConstants::STUFF_0x73) {
-                // 0x73 0x22 -> 0x73
-                output[outputIndex++] = 0x73;
-            } else {
-                // Invalid stuffing, treat as error or copy both bytes
-                if (outputIndex < outputMaxSize - 1) {
-                    output[outputIndex++] = currentByte;
-                    output[outputIndex++] = nextByte;
+        size_t index = 0;
+        size_t crcIndex = ProtocolConstants::HEADER_SIZE; // Updated once parameters are known
+        uint8_t crc = ProtocolConstants::CRC_INITIAL;
+        bool crcSeen = false;
+        bool crcOk = false;
+
+        const uint8_t *in = rawData + 2;
+        const uint8_t *const end = rawData + rawSize - 1;
+
+        while (in < end && index < ProtocolConstants::MAX_PACKET_SIZE) {
+            uint8_t value = *in++;
+            uint8_t second = 0;
+            bool pair = false;
+
+            if (value == ProtocolConstants::STUFF_MARKER && in < end) {
+                uint8_t const nextByte = *in++;
+
+                if (nextByte == ProtocolConstants::STUFF_0x55) {
+                    value = 0x55;
+                } else if (nextByte == ProtocolConstants::STUFF_0x73) {
+                    value = 0x73;
                 } else {
-                    return 0;
+                    // Invalid stuffing, both bytes are kept
+                    if (index >= ProtocolConstants::MAX_PACKET_SIZE - 1) {
+                        return false;
+                    }
+                    second = nextByte;
+                    pair = true;
                 }
             }
-        } else {
-            // Regular byte, copy as is
-            output[outputIndex++] = currentByte;
+
+            for (uint8_t n = pair ? 2 : 1; n > 0; n--) {
+                if (index < crcIndex) {
+                    crc = Crc8Engine::updateByte(crc, value);
+                    if (index == 0) {
+                        crcIndex = ProtocolConstants::HEADER_SIZE + (value & 0x1F);
+                    }
+                    sink.store(index, value);
+                } else if (index == crcIndex) {
+                    sink.storeCrc(index, value);
+                    crcSeen = true;
+                    crcOk = (crc == value);
+                }
+                // Bytes after CRC are ignored
+
+                index++;
+                value = second;
+            }
         }
-    }
 
-    return outputIndex;
+        frameSize = crcIndex + 1;
+        return crcSeen && crcOk;
+    }
 }
 
-bool ProtocolUtils::packPacket(PacketData &packet) {
-    // Create packet without start/stop bytes and without stuffing
-    uint8_t tempPacket[ProtocolConstants::MAX_PACKET_SIZE];
-    size_t tempIndex = 0;
+bool ProtocolUtils::packPacket(PacketData &packet, uint32_t encodingKey) {
+    if (packet.dataSize > ProtocolConstants::MAX_DATA_SIZE) {
+        return false;
+    }
+
+    uint8_t *const raw = packet.rawPacket;
+    raw[0] = ProtocolConstants::START1;
+    raw[1] = ProtocolConstants::START2;
+
+    // Bounds checks are only needed when the worst-case stuffed frame may not fit
+    StuffingWriter writer;
+    writer.out = raw + 2;
+    writer.limit = raw + ProtocolConstants::MAX_PACKET_SIZE - 1; // Reserve space for STOP
+    writer.crc = ProtocolConstants::CRC_INITIAL;
+    writer.checked = maxStuffedPacketSize(packet.dataSize) > ProtocolConstants::MAX_PACKET_SIZE;
+    writer.overflow = false;
 
     // Parameters + Length
     packet.params.dataLength = packet.dataSize;
-    tempPacket[tempIndex++] = packet.params.toByte();
+    writer.put(packet.params.toByte());
 
     // Reserve
-    tempPacket[tempIndex++] = ProtocolConstants::RESERVE;
+    writer.put(ProtocolConstants::RESERVE);
 
     // Destination address (little-endian)
-    uint16ToBytes(packet.destAddress, &tempPacket[tempIndex]);
-    tempIndex += 2;
+    writer.put(packet.destAddress & 0xFF);
+    writer.put((packet.destAddress >> 8) & 0xFF);
 
     // Source address (little-endian)
-    uint16ToBytes(packet.srcAddress, &tempPacket[tempIndex]);
-    tempIndex += 2;
+    writer.put(packet.srcAddress & 0xFF);
+    writer.put((packet.srcAddress >> 8) & 0xFF);
 
     // Command
-    tempPacket[tempIndex++] = packet.command;
+    writer.put(packet.command);
 
     // Password/Status (little-endian)
-    uint32ToBytes(packet.passwordOrStatus, &tempPacket[tempIndex]);
-    tempIndex += 4;
-
-    // Data
-    if (packet.dataSize > 0) {
-        memcpy(&tempPacket[tempIndex], packet.data, packet.dataSize);
-        tempIndex += packet.dataSize;
+    writer.put(packet.passwordOrStatus & 0xFF);
+    writer.put((packet.passwordOrStatus >> 8) & 0xFF);
+    writer.put((packet.passwordOrStatus >> 16) & 0xFF);
+    writer.put((packet.passwordOrStatus >> 24) & 0xFF);
+
+    // Data (packet.data stays plaintext, encoded frames carry data XOR keystream)
+    const uint8_t *data = packet.data;
+    uint8_t encoded[ProtocolConstants::MAX_DATA_SIZE];
+    if (packet.params.encoding) {
+        memcpy(encoded, packet.data, packet.dataSize);
+        applyKeystream(encoded, packet.dataSize, encodingKey);
+        data = encoded;
+    }
+    for (uint8_t i = 0; i < packet.dataSize; i++) {
+        writer.put(data[i]);
     }
 
-    // Calculate CRC for all bytes from Parameters to Data
-    packet.crc = calculateCRC8(tempPacket, tempIndex);
-    tempPacket[tempIndex++] = packet.crc;
-
-    // Now perform byte stuffing on the packet (excluding start/stop)
-    uint8_t stuffedPacket[ProtocolConstants::MAX_PACKET_SIZE];
-    size_t stuffedSize = byteStuffing(tempPacket, tempIndex, stuffedPacket, sizeof(stuffedPacket));
+    // CRC for all bytes from Parameters to Data
+    packet.crc = writer.crc;
+    writer.putRaw(packet.crc);
 
-    if (stuffedSize == 0 || stuffedSize + 3 > ProtocolConstants::MAX_PACKET_SIZE) {
+    if (writer.overflow) {
+        packet.rawSize = 0;
         return false;
     }
 
-    // Build final packet with start/stop bytes
-    packet.rawSize = 0;
-    packet.rawPacket[packet.rawSize++] = ProtocolConstants::START1;
-    packet.rawPacket[packet.rawSize++] = ProtocolConstants::START2;
-
-    memcpy(&packet.rawPacket[packet.rawSize], stuffedPacket, stuffedSize);
-    packet.rawSize += stuffedSize;
-
-    packet.rawPacket[packet.rawSize++] = ProtocolConstants::STOP;
+    *writer.out++ = ProtocolConstants::STOP;
+    packet.rawSize = writer.out - raw;
 
     return true;
 }
 
-bool ProtocolUtils::unpackPacket(const uint8_t *rawData, size_t rawSize, PacketData &packet) {
-    packet.clear();
+bool ProtocolUtils::unpackPacket(const uint8_t *rawData, size_t rawSize, PacketData &packet, uint32_t encodingKey) {
+    return decodePacket(rawData, rawSize, packet, true, encodingKey);
+}
 
-    if ((rawData == nullptr) || rawSize < ProtocolConstants::MIN_PACKET_SIZE) {
+bool ProtocolUtils::decodePacket(const uint8_t *rawData, size_t rawSize, PacketData &packet, bool copyRaw,
+                                 uint32_t encodingKey) {
+    if (copyRaw && rawSize > ProtocolConstants::MAX_PACKET_SIZE) {
         return false;
     }
 
-    // Check start and stop bytes
-    if (rawData[0] != ProtocolConstants::START1 ||
-        rawData[1] != ProtocolConstants::START2 ||
-        rawData[rawSize - 1] != ProtocolConstants::STOP) {
+    PacketFieldSink sink;
+    sink.packet = &packet;
+
+    size_t frameSize = 0;
+    if (!scanFrame(rawData, rawSize, sink, frameSize)) {
         return false;
     }
 
-    // Extract stuffed data (without start/stop bytes)
-    const uint8_t *stuffedData = rawData + 2;
-    size_t const stuffedSize = rawSize - 3;
+    packet.dataSize = packet.params.dataLength;
 
-    // Perform reverse byte stuffing
-    uint8_t unstuffedData[ProtocolConstants::MAX_PACKET_SIZE];
-    size_t const unstuffedSize = byteUnstuffing(stuffedData, stuffedSize, unstuffedData, sizeof(unstuffedData));
+    // CRC covers the transmitted (encoded) bytes, decode data only after it matched
+    if (packet.params.encoding) {
+        applyKeystream(packet.data, packet.dataSize, encodingKey);
+    }
+
+    if (copyRaw) {
+        memcpy(packet.rawPacket, rawData, rawSize);
+        packet.rawSize = rawSize;
+    } else {
+        packet.rawSize = 0;
+    }
 
-    if (unstuffedSize < 8) {
-        // Minimum: params(1) + reserve(1) + dest(2) + src(2) + cmd(1) + pass/stat(4) + crc(1)
+    return true;
+}
+
+bool ProtocolUtils::unstuffFrame(const uint8_t *rawData, size_t rawSize, uint8_t *frame, size_t &frameSize) {
+    if (frame == nullptr) {
         return false;
     }
 
-    // Parse unstuffed packet
-    size_t index = 0;
+    FrameBufferSink sink;
+    sink.frame = frame;
 
-    // Parameters
-    packet.params.fromByte(unstuffedData[index++]);
+    return scanFrame(rawData, rawSize, sink, frameSize);
+}
 
-    // Reserve (skip)
-    index++;
+size_t ProtocolUtils::decodeBatch(const uint8_t *buffer, size_t bufferSize, PacketBatch &batch) {
+    batch.count = 0;
+    batch.validCount = 0;
+    batch.bytesConsumed = 0;
 
-    // Destination address
-    packet.destAddress = bytesToUint16(&unstuffedData[index]);
-    index += 2;
+    if (buffer == nullptr || batch.destAddress == nullptr || batch.srcAddress == nullptr ||
+        batch.command == nullptr || batch.passwordOrStatus == nullptr || batch.dataOffset == nullptr ||
+        batch.dataLength == nullptr || batch.valid == nullptr || batch.data == nullptr) {
+        return 0;
+    }
 
-    // Source address
-    packet.srcAddress = bytesToUint16(&unstuffedData[index]);
-    index += 2;
+    memset(batch.valid, 0, (batch.capacity + 7) / 8);
 
-    // Command
-    packet.command = unstuffedData[index++];
+    uint8_t frame[ProtocolConstants::MAX_PACKET_SIZE];
+    FrameBufferSink sink;
+    sink.frame = frame;
 
-    // Password/Status
-    packet.passwordOrStatus = bytesToUint32(&unstuffedData[index]);
-    index += 4;
+    size_t position = 0;
+    size_t row = 0;
+    size_t validCount = 0;
+    uint32_t dataOffset = 0;
 
-    // Data
-    packet.dataSize = packet.params.dataLength;
-    if (packet.dataSize > 0) {
-        if (index + packet.dataSize >= unstuffedSize) {
-            return false; // Not enough data
+    while (row < batch.capacity && position < bufferSize) {
+        size_t const rawSize = buffer[position];
+        if (rawSize > bufferSize - position - 1) {
+            break; // Truncated record, resume from its length byte
         }
-        memcpy(packet.data, &unstuffedData[index], packet.dataSize);
-        index += packet.dataSize;
+        const uint8_t *const rawData = buffer + position + 1;
+        position += rawSize + 1;
+
+        // Stale bytes of the previous frame must not leak into an invalid row
+        memset(frame, 0, sizeof(frame));
+        size_t frameSize = 0;
+        uint8_t const ok = (rawSize <= ProtocolConstants::MAX_PACKET_SIZE &&
+                            scanFrame(rawData, rawSize, sink, frameSize)) ? 1 : 0;
+
+        // Columns are written unconditionally, invalid rows are masked to zero
+        uint8_t const mask8 = static_cast<uint8_t>(0 - ok);
+        uint16_t const mask16 = static_cast<uint16_t>(0 - ok);
+        uint32_t const mask32 = static_cast<uint32_t>(0) - ok;
+
+        uint8_t const dataLength = (frame[0] & 0x1F) & mask8;
+
+        batch.destAddress[row] = bytesToUint16(&frame[2]) & mask16;
+        batch.srcAddress[row] = bytesToUint16(&frame[4]) & mask16;
+        batch.command[row] = frame[6] & mask8;
+        batch.passwordOrStatus[row] = bytesToUint32(&frame[7]) & mask32;
+        batch.dataOffset[row] = dataOffset;
+        batch.dataLength[row] = dataLength;
+        batch.valid[row >> 3] |= static_cast<uint8_t>(ok << (row & 0x07));
+
+        // Fixed-size copy: dataOffset + MAX_DATA_SIZE never exceeds capacity * MAX_DATA_SIZE
+        memcpy(batch.data + dataOffset, frame + ProtocolConstants::HEADER_SIZE, ProtocolConstants::MAX_DATA_SIZE);
+        dataOffset += dataLength;
+        validCount += ok;
+        row++;
     }
 
-    // CRC
-    if (index >= unstuffedSize) {
+    batch.count = row;
+    batch.validCount = validCount;
+    batch.bytesConsumed = position;
+    return row;
+}
+
+bool ProtocolUtils::matchHeader(const uint8_t *rawData, size_t rawSize, const PacketFilter &filter) {
+    if ((rawData == nullptr) || rawSize < ProtocolConstants::MIN_PACKET_SIZE) {
         return false;
     }
-    packet.crc = unstuffedData[index++];
 
-    // Verify CRC
-    uint8_t calculatedCRC = calculateCRC8(unstuffedData, index - 1);
-    if (calculatedCRC != packet.crc) {
+    if (rawData[0] != ProtocolConstants::START1 || rawData[1] != ProtocolConstants::START2) {
         return false;
     }
 
-    // Store raw packet
-    memcpy(packet.rawPacket, rawData, rawSize);
-    packet.rawSize = rawSize;
+    // Unstuff only params, reserve, dest, src and command (same rules as scanFrame)
+    uint8_t header[HEADER_PREFIX_SIZE];
+    size_t index = 0;
+
+    const uint8_t *in = rawData + 2;
+    const uint8_t *const end = rawData + rawSize - 1;
 
-    return true;
+    while (in < end && index < HEADER_PREFIX_SIZE) {
+        uint8_t const currentByte = *in++;
+
+        if (currentByte == ProtocolConstants::STUFF_MARKER && in < end) {
+            uint8_t const nextByte = *in++;
+
+            if (nextByte == ProtocolConstants::STUFF_0x55) {
+                header[index++] = 0x55;
+            } else if (nextByte == ProtocolConstants::STUFF_0x73) {
+                header[index++] = 0x73;
+            } else {
+                // Invalid stuffing, both bytes are kept
+                header[index++] = currentByte;
+                if (index < HEADER_PREFIX_SIZE) {
+                    header[index++] = nextByte;
+                }
+            }
+        } else {
+            header[index++] = currentByte;
+        }
+    }
+
+    if (index < HEADER_PREFIX_SIZE) {
+        return false;
+    }
+
+    return filter.matches(bytesToUint16(&header[2]), bytesToUint16(&header[4]), header[6]);
 }
 
-void ProtocolUtils::encodeData(uint8_t *data, size_t size, uint8_t key) {
-    for (size_t i = 0; i < size; i++) {
-        data[i] ^= key;
+void ProtocolUtils::applyKeystream(uint8_t *data, size_t size, uint32_t key) {
+    if (data == nullptr) {
+        return;
     }
+
+    // Keystream: key bytes (little-endian) repeated; byte order independent pattern
+    uint8_t pattern[8];
+    uint32ToBytes(key, pattern);
+    uint32ToBytes(key, pattern + 4);
+
+    size_t i = 0;
+
+#if defined(MIRLIB_KEYSTREAM_HAS_X86)
+    __m128i const keyBlock = _mm_set_epi32(static_cast<int>(key), static_cast<int>(key),
+                                           static_cast<int>(key), static_cast<int>(key));
+    for (; i + 16 <= size; i += 16) {
+        __m128i *const block = reinterpret_cast<__m128i *>(data + i);
+        _mm_storeu_si128(block, _mm_xor_si128(_mm_loadu_si128(block), keyBlock));
+    }
+#elif defined(MIRLIB_KEYSTREAM_HAS_NEON)
+    uint8x16_t const keyBlock = vcombine_u8(vld1_u8(pattern), vld1_u8(pattern));
+    for (; i + 16 <= size; i += 16) {
+        vst1q_u8(data + i, veorq_u8(vld1q_u8(data + i), keyBlock));
+    }
+#endif
+
+#if defined(MIRLIB_PLATFORM_GCC)
+    typedef uint64_t KeystreamWord;
+#else
+    typedef uint32_t KeystreamWord; // Native word on ESP32, no 64-bit emulation on AVR
+#endif
+
+    KeystreamWord keyWord;
+    memcpy(&keyWord, pattern, sizeof(keyWord));
+
+    // Every block above is a multiple of 4 bytes, so the key phase is still 0 here
+    for (; i + sizeof(KeystreamWord) <= size; i += sizeof(KeystreamWord)) {
+        KeystreamWord word;
+        memcpy(&word, data + i, sizeof(word));
+        word ^= keyWord;
+        memcpy(data + i, &word, sizeof(word));
+    }
+
+    for (; i < size; i++) {
+        data[i] ^= pattern[i & 0x03];
+    }
+}
+
+void ProtocolUtils::encodeData(uint8_t *data, size_t size, uint8_t key) {
+    applyKeystream(data, size, key * 0x01010101UL);
 }
 
 void ProtocolUtils::decodeData(uint8_t *data, size_t size, uint8_t key) {
@@ -279,37 +523,7 @@ uint32_t ProtocolUtils::bytesToUint32(const uint8_t *bytes) {
 }
 
 GenerationInfo ProtocolUtils::determineGeneration(uint8_t boardId, uint8_t role) {
-    GenerationInfo info = {0};
-    info.boardId = boardId;
-    info.role = role;
-
-    // Old generation boards
-    if (boardId == BOARD_OLD_01 || boardId == BOARD_OLD_02 || boardId == BOARD_OLD_03 ||
-        boardId == BOARD_OLD_04 || boardId == BOARD_OLD_0C || boardId == BOARD_OLD_0D ||
-        boardId == BOARD_OLD_11 || boardId == BOARD_OLD_12) {
-        info.isOldGeneration = true;
-        return info;
-    }
-
-    // For transition and new generation, also check role
-    if (role >= 0x32) {
-        // Transition generation boards
-        if (boardId == BOARD_TRANS_07 || boardId == BOARD_TRANS_08 ||
-            boardId == BOARD_TRANS_0A || boardId == BOARD_TRANS_0B) {
-            info.isTransitionGeneration = true;
-            return info;
-        }
-
-        // New generation boards
-        if (boardId == BOARD_NEW_09 || boardId == BOARD_NEW_0E || boardId == BOARD_NEW_0F ||
-            boardId == BOARD_NEW_10 || boardId == BOARD_NEW_20 || boardId == BOARD_NEW_21 ||
-            boardId == BOARD_NEW_22) {
-            info.isNewGeneration = true;
-            return info;
-        }
-    }
-
-    return info; // Unknown generation
+    return BoardCapabilities::generationInfo(BoardCapabilities::generation(boardId, role), boardId, role);
 }
 
 bool ProtocolUtils::validatePacket(const PacketData &packet) {
@@ -358,14 +572,16 @@ bool ProtocolUtils::createRequestPacket(
     uint32_t password,
     const uint8_t *data,
     uint8_t dataSize,
-    PacketData &packet
+    PacketData &packet,
+    bool encoded,
+    uint32_t encodingKey
 ) {
     packet.clear();
 
     // Set parameters
     packet.params.direction = 1; // Request
     packet.params.version = 0; // Simple devices
-    packet.params.encoding = 0; // Not encoded
+    packet.params.encoding = encoded ? 1 : 0;
     packet.params.dataLength = dataSize;
 
     // Set addresses and command
@@ -374,13 +590,62 @@ bool ProtocolUtils::createRequestPacket(
     packet.command = command;
     packet.passwordOrStatus = password;
 
+    // Data length is a 5-bit field, larger payloads do not fit packet.data
+    if (dataSize > ProtocolConstants::MAX_DATA_SIZE) {
+        return false;
+    }
+
     // Set data
     packet.dataSize = dataSize;
     if (dataSize > 0 && (data != nullptr)) {
         memcpy(packet.data, data, dataSize);
     }
 
-    return packPacket(packet);
+    return packPacket(packet, encodingKey);
+}
+
+namespace {
+    /**
+     * @brief Build a response to a request given by its header fields
+     */
+    bool buildResponsePacket(
+        const Parameters &requestParams,
+        uint16_t requestDest,
+        uint16_t requestSrc,
+        uint8_t command,
+        uint32_t status,
+        const uint8_t *data,
+        uint8_t dataSize,
+        PacketData &packet,
+        uint32_t encodingKey
+    ) {
+        packet.clear();
+
+        // Set parameters
+        packet.params.direction = 0; // Response
+        packet.params.version = requestParams.version;
+        packet.params.encoding = requestParams.encoding;
+        packet.params.dataLength = dataSize;
+
+        // Swap addresses for response
+        packet.destAddress = requestSrc;
+        packet.srcAddress = requestDest;
+        packet.command = command;
+        packet.passwordOrStatus = status;
+
+        // Data length is a 5-bit field, larger payloads do not fit packet.data
+        if (dataSize > ProtocolConstants::MAX_DATA_SIZE) {
+            return false;
+        }
+
+        // Set data
+        packet.dataSize = dataSize;
+        if (dataSize > 0 && data) {
+            memcpy(packet.data, data, dataSize);
+        }
+
+        return ProtocolUtils::packPacket(packet, encodingKey);
+    }
 }
 
 bool ProtocolUtils::createResponsePacket(
@@ -388,29 +653,24 @@ bool ProtocolUtils::createResponsePacket(
     uint32_t status,
     const uint8_t *data,
     uint8_t dataSize,
-    PacketData &packet
+    PacketData &packet,
+    uint32_t encodingKey
 ) {
-    packet.clear();
-
-    // Set parameters
-    packet.params.direction = 0; // Response
-    packet.params.version = originalRequest.params.version;
-    packet.params.encoding = originalRequest.params.encoding;
-    packet.params.dataLength = dataSize;
-
-    // Swap addresses for response
-    packet.destAddress = originalRequest.srcAddress;
-    packet.srcAddress = originalRequest.destAddress;
-    packet.command = originalRequest.command;
-    packet.passwordOrStatus = status;
-
-    // Set data
-    packet.dataSize = dataSize;
-    if (dataSize > 0 && data) {
-        memcpy(packet.data, data, dataSize);
-    }
+    return buildResponsePacket(originalRequest.params, originalRequest.destAddress, originalRequest.srcAddress,
+                               originalRequest.command, status, data, dataSize, packet, encodingKey);
+}
 
-    return packPacket(packet);
+bool ProtocolUtils::createResponsePacket(
+    const PacketView &originalRequest,
+    uint32_t status,
+    const uint8_t *data,
+    uint8_t dataSize,
+    PacketData &packet,
+    uint32_t encodingKey
+) {
+    return buildResponsePacket(originalRequest.params(), originalRequest.destAddress(),
+                               originalRequest.srcAddress(), originalRequest.command(), status, data, dataSize,
+                               packet, encodingKey);
 }
 
 const char *ProtocolUtils::getCommandName(uint8_t commandCode) {
@@ -441,30 +701,5 @@ const char *ProtocolUtils::getEnergyTypeName(uint8_t energyType) {
 }
 
 const char *ProtocolUtils::getBoardGenerationName(uint8_t boardId) {
-    switch (boardId) {
-        case BOARD_OLD_01:
-        case BOARD_OLD_02:
-        case BOARD_OLD_03:
-        case BOARD_OLD_04:
-        case BOARD_OLD_0C:
-        case BOARD_OLD_0D:
-        case BOARD_OLD_11:
-        case BOARD_OLD_12:
-            return "Old";
-        case BOARD_TRANS_07:
-        case BOARD_TRANS_08:
-        case BOARD_TRANS_0A:
-        case BOARD_TRANS_0B:
-            return "Transition";
-        case BOARD_NEW_09:
-        case BOARD_NEW_0E:
-        case BOARD_NEW_0F:
-        case BOARD_NEW_10:
-        case BOARD_NEW_20:
-        case BOARD_NEW_21:
-        case BOARD_NEW_22:
-            return "New";
-        default:
-            return "Unknown";
-    }
+    return BoardCapabilities::profile(BoardCapabilities::boardGeneration(boardId)).name;
 }
@@ -4,13 +4,20 @@
 #include <Arduino.h>
 #include "ProtocolTypes.h"
 
+class PacketView;
+struct PacketFilter;
+
 /**
  * @brief Utility functions for protocol operations
  */
 class ProtocolUtils {
 public:
+    static const size_t HEADER_PREFIX_SIZE = 7; ///< Params + reserve + dest(2) + src(2) + command
+
     /**
      * @brief Calculate CRC8 checksum
+     *
+     * Uses the table-driven Crc8Engine tier selected by MIRLIB_CRC8_TIER.
      * @param data Pointer to data
      * @param length Data length
      * @return CRC8 value
@@ -19,6 +26,8 @@ public:
 
     /**
      * @brief Perform byte stuffing on data
+     *
+     * Uses the fastest StuffingEngine kernel available (SIMD on host builds).
      * @param input Input data
      * @param inputSize Input data size
      * @param output Output buffer
@@ -30,6 +39,8 @@ public:
 
     /**
      * @brief Perform reverse byte stuffing (unstuffing)
+     *
+     * Uses the fastest StuffingEngine kernel available (SIMD on host builds).
      * @param input Input stuffed data
      * @param inputSize Input data size
      * @param output Output buffer
@@ -41,19 +52,104 @@ public:
 
     /**
      * @brief Pack packet into raw bytes
+     *
+     * Serializes the header, computes CRC and performs byte stuffing in a
+     * single pass straight into packet.rawPacket (no intermediate buffers).
+     * With params.encoding set the data field is sent XOR keystream
+     * (packet.data itself stays plaintext); CRC covers the encoded bytes.
      * @param packet Packet structure
+     * @param encodingKey Keystream key, used when params.encoding is set
      * @return true if packing successful
      */
-    static bool packPacket(PacketData &packet);
+    static bool packPacket(PacketData &packet, uint32_t encodingKey = 0);
+
+    /**
+     * @brief Worst-case raw packet size (every byte stuffed, with start/stop bytes)
+     * @param dataSize Data field size
+     * @return Maximum raw packet size
+     */
+    static constexpr size_t maxStuffedPacketSize(size_t dataSize) {
+        return 2 * (ProtocolConstants::HEADER_SIZE + dataSize + 1) + ProtocolConstants::FRAMING_SIZE;
+    }
 
     /**
      * @brief Unpack raw bytes into packet structure
      * @param rawData Raw packet data
      * @param rawSize Raw data size
      * @param packet Output packet structure
+     * @param encodingKey Keystream key, used when the frame has params.encoding set
      * @return true if unpacking successful
      */
-    static bool unpackPacket(const uint8_t *rawData, size_t rawSize, PacketData &packet);
+    static bool unpackPacket(const uint8_t *rawData, size_t rawSize, PacketData &packet, uint32_t encodingKey = 0);
+
+    /**
+     * @brief Decode raw bytes into packet structure in a single forward scan
+     *
+     * Unstuffing, CRC check and field extraction run together; only the
+     * decoded fields are written (the packet is not cleared beforehand).
+     * @param rawData Raw packet data
+     * @param rawSize Raw data size
+     * @param packet Output packet structure
+     * @param copyRaw Copy the raw frame into packet.rawPacket. Only zero-copy callers that
+     *        read the decoded fields pass false: rawSize is then 0 and isValid() fails
+     * @param encodingKey Keystream key, data of encoded frames is decoded after the CRC check
+     * @return true if decoding successful
+     */
+    static bool decodePacket(const uint8_t *rawData, size_t rawSize, PacketData &packet, bool copyRaw = true,
+                             uint32_t encodingKey = 0);
+
+    /**
+     * @brief Unstuff and CRC-check a raw frame into a flat buffer (for PacketView)
+     *
+     * Accepts exactly the frames decodePacket accepts. The output buffer may be
+     * the raw input buffer itself (in-place unstuffing).
+     * @param rawData Raw packet data
+     * @param rawSize Raw data size
+     * @param frame Output buffer (at least MAX_PACKET_SIZE bytes)
+     * @param frameSize Unstuffed size from Parameters to CRC inclusive (output)
+     * @return true if frame is valid
+     */
+    static bool unstuffFrame(const uint8_t *rawData, size_t rawSize, uint8_t *frame, size_t &frameSize);
+
+    /**
+     * @brief Decode a buffer of length-prefixed frames into column arrays
+     *
+     * Input is a sequence of records `len, raw[len]` (one length byte, then
+     * the raw frame with start/stop bytes). A frame is valid exactly when
+     * unpackPacket would accept it. Stops when the buffer is exhausted, the
+     * batch is full or a record is truncated; batch.bytesConsumed tells where
+     * to resume.
+     * @param buffer Length-prefixed frames
+     * @param bufferSize Buffer size
+     * @param batch Output columns (see PacketBatch)
+     * @return Number of frames decoded (valid or not)
+     */
+    static size_t decodeBatch(const uint8_t *buffer, size_t bufferSize, PacketBatch &batch);
+
+    /**
+     * @brief Header-first filter: unstuff only the first 7 bytes and match them
+     *
+     * Cheap pre-check before decodePacket/unstuffFrame: payload is not
+     * unstuffed and CRC is not computed. A frame that decodes successfully
+     * with matching fields always passes this check.
+     * @param rawData Raw packet data
+     * @param rawSize Raw data size
+     * @param filter Address/command filter
+     * @return true if header matches the filter (frame still has to be decoded)
+     */
+    static bool matchHeader(const uint8_t *rawData, size_t rawSize, const PacketFilter &filter);
+
+    /**
+     * @brief XOR data with the keystream (key bytes, little-endian, repeated)
+     *
+     * Symmetric: the same call encodes and decodes. Runs over machine words
+     * (16-byte SIMD blocks on host builds) instead of single bytes; define
+     * MIRLIB_KEYSTREAM_NO_SIMD to keep the machine-word path on host builds.
+     * @param data Data to encode/decode in place
+     * @param size Data size
+     * @param key 32-bit key
+     */
+    static void applyKeystream(uint8_t *data, size_t size, uint32_t key);
 
     /**
      * @brief Encode data (simple XOR encoding)
@@ -138,11 +234,13 @@ public:
      * @param data Data payload
      * @param dataSize Data size
      * @param packet Output packet
+     * @param encoded Send data field encoded (params.encoding = 1)
+     * @param encodingKey Keystream key for encoded packets
      * @return true if packet created successfully
      */
     static bool createRequestPacket(uint8_t command, uint16_t destAddr, uint16_t srcAddr,
                                     uint32_t password, const uint8_t *data, uint8_t dataSize,
-                                    PacketData &packet);
+                                    PacketData &packet, bool encoded = false, uint32_t encodingKey = 0);
 
     /**
      * @brief Create response packet
@@ -151,10 +249,26 @@ public:
      * @param data Response data
      * @param dataSize Data size
      * @param packet Output packet
+     * @param encodingKey Keystream key, used when the request was encoded
      * @return true if packet created successfully
      */
     static bool createResponsePacket(const PacketData &originalRequest, uint32_t status,
-                                     const uint8_t *data, uint8_t dataSize, PacketData &packet);
+                                     const uint8_t *data, uint8_t dataSize, PacketData &packet,
+                                     uint32_t encodingKey = 0);
+
+    /**
+     * @brief Create response packet for a request seen through a PacketView
+     * @param originalRequest Original request view
+     * @param status Status value (4 bytes)
+     * @param data Response data
+     * @param dataSize Data size
+     * @param packet Output packet
+     * @param encodingKey Keystream key, used when the request was encoded
+     * @return true if packet created successfully
+     */
+    static bool createResponsePacket(const PacketView &originalRequest, uint32_t status,
+                                     const uint8_t *data, uint8_t dataSize, PacketData &packet,
+                                     uint32_t encodingKey = 0);
 
     /**
      * @brief Get command name string
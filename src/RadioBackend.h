@@ -0,0 +1,125 @@
+#ifndef RADIO_BACKEND_H
+#define RADIO_BACKEND_H
+
+#include <Arduino.h>
+#include "ProtocolTypes.h"
+#include "MirlibDebug.h"
+
+/**
+ * @brief Receive signal callback
+ * @param context Context passed to attachReceiveSignal() / attachFifoSignal()
+ * @param frameStart true on sync word detection (FIFO signal: threshold reached), false at end of packet
+ */
+typedef void (*ReceiveSignalHandler)(void *context, bool frameStart);
+
+/**
+ * @brief CC1101 access used by MirlibBase
+ *
+ * Register addresses and strobes are raw CC1101 values as in the datasheet
+ * (e.g. 0x33 SCAL, 0xF5 MARCSTATE). ElechouseRadio drives the module via
+ * the ELECHOUSE_cc1101 driver; other backends allow several modules or a
+ * simulated radio on the host.
+ */
+class RadioBackend {
+public:
+    virtual ~RadioBackend() {
+    }
+
+    /**
+     * @brief Configure pins and check the chip responds
+     * @param gdo0Pin GDO0 pin
+     * @return false if the chip is not reachable
+     */
+    virtual bool begin(int gdo0Pin) = 0;
+
+    /**
+     * @brief Issue a command strobe (SRES, SCAL, SRX, SIDLE, SFRX, ...)
+     */
+    virtual void strobe(uint8_t command) = 0;
+
+    /**
+     * @brief Write a configuration register (or PATABLE)
+     */
+    virtual void writeRegister(uint8_t address, uint8_t value) = 0;
+
+    /**
+     * @brief Burst write consecutive registers
+     */
+    virtual void writeBurst(uint8_t address, const uint8_t *data, uint8_t size) = 0;
+
+    /**
+     * @brief Read a configuration register
+     */
+    virtual uint8_t readRegister(uint8_t address) = 0;
+
+    /**
+     * @brief Read a status register (MARCSTATE, RXBYTES, ...)
+     */
+    virtual uint8_t readStatus(uint8_t address) = 0;
+
+    /**
+     * @brief Transmit a frame in variable length mode, returns after the end of packet
+     */
+    virtual void send(const uint8_t *data, uint8_t size) = 0;
+
+    /**
+     * @brief Check for a completely received frame (polling receive)
+     */
+    virtual bool receiveReady() = 0;
+
+    /**
+     * @brief Read a frame from the RX FIFO, then flush it and re-enter RX
+     * @param buffer Output buffer (at least MAX_PACKET_SIZE bytes)
+     * @param status Appended status bytes: RSSI, LQI | CRC_OK (PKTCTRL1.APPEND_STATUS)
+     * @return Frame size, 0 if the FIFO was empty or the length byte is invalid
+     */
+    virtual int receive(uint8_t *buffer, uint8_t status[2]) = 0;
+
+    /**
+     * @brief Read one frame from the RX FIFO, leaving the FIFO and the radio state untouched
+     *
+     * Used when MCSM1 keeps the radio in RX after a packet: further frames stay
+     * in the FIFO. Call only when a complete frame is in the FIFO (GDO0 low).
+     * The frame and its appended status bytes are read in one burst.
+     * @param buffer Output buffer (at least MAX_PACKET_SIZE bytes)
+     * @param status Appended status bytes: RSSI, LQI | CRC_OK
+     * @return Frame size, 0 if the FIFO is empty, -1 if the length byte is invalid
+     *         or the frame is incomplete (the caller must flush the FIFO)
+     */
+    virtual int readFrame(uint8_t *buffer, uint8_t status[2]) = 0;
+
+    /**
+     * @brief Read raw bytes from the RX FIFO (length byte, frame bytes and status bytes as received)
+     *
+     * While a packet is being received the last byte in the FIFO must stay
+     * there (CC1101 errata), the caller limits count accordingly.
+     * @param buffer Output buffer
+     * @param count Number of bytes, not above the RXBYTES count
+     */
+    virtual void readFifo(uint8_t *buffer, uint8_t count) = 0;
+
+    /**
+     * @brief Deliver RX FIFO threshold events (GDO2 with IOCFG2 = 0x00) to a handler (interrupt context)
+     * @param gdo2Pin GDO2 pin
+     * @return false if the backend has no FIFO signal or it is owned by another handler
+     */
+    virtual bool attachFifoSignal(int gdo2Pin, ReceiveSignalHandler handler, void *context) = 0;
+
+    /**
+     * @brief Stop delivering FIFO threshold events
+     */
+    virtual void detachFifoSignal() = 0;
+
+    /**
+     * @brief Deliver frame start / end of packet events to a handler (interrupt context)
+     * @return false if the backend has no receive signal or it is owned by another handler
+     */
+    virtual bool attachReceiveSignal(ReceiveSignalHandler handler, void *context) = 0;
+
+    /**
+     * @brief Stop delivering receive events
+     */
+    virtual void detachReceiveSignal() = 0;
+};
+
+#endif // RADIO_BACKEND_H
@@ -0,0 +1,69 @@
+#include "RequestFrameCache.h"
+
+RequestFrameCache::RequestFrameCache()
+    : m_clock(0)
+      , m_hits(0)
+      , m_misses(0)
+{
+    clear();
+}
+
+uint8_t *RequestFrameCache::find(uint8_t command, uint16_t targetAddress, uint32_t password,
+                                 const uint8_t *requestData, size_t requestSize, size_t &rawSize) {
+    for (size_t i = 0; i < CAPACITY; i++) {
+        Entry &entry = m_entries[i];
+
+        if (entry.used && entry.command == command && entry.targetAddress == targetAddress &&
+            entry.password == password && entry.requestSize == requestSize &&
+            (requestSize == 0 || memcmp(entry.request, requestData, requestSize) == 0)) {
+            entry.lastUse = ++m_clock;
+            rawSize = entry.rawSize;
+            m_hits++;
+            return entry.raw;
+        }
+    }
+
+    m_misses++;
+    return nullptr;
+}
+
+void RequestFrameCache::store(uint8_t command, uint16_t targetAddress, uint32_t password,
+                              const uint8_t *requestData, size_t requestSize,
+                              const uint8_t *rawData, size_t rawSize) {
+    if (requestSize > ProtocolConstants::MAX_DATA_SIZE || rawSize > ProtocolConstants::MAX_PACKET_SIZE ||
+        (requestSize > 0 && requestData == nullptr) || rawData == nullptr) {
+        return;
+    }
+
+    // Free slot first, otherwise the least recently used one (stamps compared relative to the clock)
+    Entry *victim = &m_entries[0];
+    for (size_t i = 0; i < CAPACITY; i++) {
+        Entry &entry = m_entries[i];
+        if (!entry.used) {
+            victim = &entry;
+            break;
+        }
+        if (static_cast<uint16_t>(m_clock - entry.lastUse) > static_cast<uint16_t>(m_clock - victim->lastUse)) {
+            victim = &entry;
+        }
+    }
+
+    victim->used = true;
+    victim->command = command;
+    victim->targetAddress = targetAddress;
+    victim->password = password;
+    victim->requestSize = static_cast<uint8_t>(requestSize);
+    victim->rawSize = static_cast<uint8_t>(rawSize);
+    victim->lastUse = ++m_clock;
+    if (requestSize > 0) {
+        memcpy(victim->request, requestData, requestSize);
+    }
+    memcpy(victim->raw, rawData, rawSize);
+}
+
+void RequestFrameCache::clear() {
+    for (size_t i = 0; i < CAPACITY; i++) {
+        m_entries[i].used = false;
+        m_entries[i].lastUse = 0;
+    }
+}
@@ -0,0 +1,103 @@
+#ifndef REQUEST_FRAME_CACHE_H
+#define REQUEST_FRAME_CACHE_H
+
+#include <Arduino.h>
+#include "ProtocolTypes.h"
+#include "MirlibDebug.h"
+
+/**
+ * @brief Number of cached request frames (0 disables the cache)
+ *
+ * Each entry takes about 110 bytes of RAM; override with
+ * -DMIRLIB_REQUEST_CACHE_SIZE=...
+ */
+#ifndef MIRLIB_REQUEST_CACHE_SIZE
+  #if defined(MIRLIB_PLATFORM_AVR)
+    #define MIRLIB_REQUEST_CACHE_SIZE 2
+  #else
+    #define MIRLIB_REQUEST_CACHE_SIZE 8
+  #endif
+#endif
+
+/**
+ * @brief Fixed-capacity LRU cache of encoded request frames
+ *
+ * Keyed by command code, target address, password and request data (the
+ * output of prepareRequest). The source address is not part of the key:
+ * the owner clears the cache when it changes.
+ */
+class RequestFrameCache {
+public:
+    static const size_t CAPACITY = (MIRLIB_REQUEST_CACHE_SIZE > 0) ? MIRLIB_REQUEST_CACHE_SIZE : 1;
+
+    /**
+     * @brief Constructor (empty cache)
+     */
+    RequestFrameCache();
+
+    /**
+     * @brief Look up an encoded frame, counting a hit or a miss
+     * @param command Command code
+     * @param targetAddress Destination address
+     * @param password Password
+     * @param requestData Request data
+     * @param requestSize Request data size
+     * @param rawSize Raw frame size (output, on hit)
+     * @return Raw frame (valid until the next store/clear), nullptr on miss
+     */
+    uint8_t *find(uint8_t command, uint16_t targetAddress, uint32_t password,
+                  const uint8_t *requestData, size_t requestSize, size_t &rawSize);
+
+    /**
+     * @brief Store an encoded frame, replacing the least recently used entry
+     * @param command Command code
+     * @param targetAddress Destination address
+     * @param password Password
+     * @param requestData Request data
+     * @param requestSize Request data size
+     * @param rawData Raw frame
+     * @param rawSize Raw frame size
+     */
+    void store(uint8_t command, uint16_t targetAddress, uint32_t password,
+               const uint8_t *requestData, size_t requestSize,
+               const uint8_t *rawData, size_t rawSize);
+
+    /**
+     * @brief Drop all entries (statistics are kept)
+     */
+    void clear();
+
+    /**
+     * @brief Statistics
+     */
+    uint32_t getHits() const { return m_hits; } ///< Lookups served from the cache
+    uint32_t getMisses() const { return m_misses; } ///< Lookups that required encoding
+
+    /**
+     * @brief Reset statistics counters
+     */
+    void resetStats() {
+        m_hits = 0;
+        m_misses = 0;
+    }
+
+private:
+    struct Entry {
+        bool used;
+        uint8_t command;
+        uint16_t targetAddress;
+        uint32_t password;
+        uint8_t requestSize;
+        uint8_t rawSize;
+        uint16_t lastUse; ///< LRU stamp
+        uint8_t request[ProtocolConstants::MAX_DATA_SIZE];
+        uint8_t raw[ProtocolConstants::MAX_PACKET_SIZE];
+    };
+
+    Entry m_entries[CAPACITY];
+    uint16_t m_clock;
+    uint32_t m_hits;
+    uint32_t m_misses;
+};
+
+#endif // REQUEST_FRAME_CACHE_H
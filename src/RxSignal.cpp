@@ -0,0 +1,284 @@
+#include "RxSignal.h"
+
+#if defined(MIRLIB_PLATFORM_GCC)
+  #include <errno.h>
+  #include <time.h>
+#endif
+
+#if defined(MIRLIB_PLATFORM_ESP32)
+
+namespace {
+    // Drain runs above normal application tasks so the FIFO is emptied before the next frame
+    const uint32_t DRAIN_TASK_STACK = 3072;
+    const UBaseType_t DRAIN_TASK_PRIORITY = configMAX_PRIORITIES - 2;
+}
+
+RxSignal::RxSignal()
+    : m_drain(nullptr)
+      , m_context(nullptr)
+      , m_drainTask(nullptr)
+      , m_waiter(nullptr)
+      , m_radioMutex(xSemaphoreCreateRecursiveMutex())
+{
+}
+
+RxSignal::~RxSignal() {
+    end();
+    if (m_radioMutex != nullptr) {
+        vSemaphoreDelete(m_radioMutex);
+    }
+}
+
+bool RxSignal::begin(DrainFunc drain, void *context) {
+    end();
+    m_context = context;
+    m_drain = drain;
+
+    if (xTaskCreate(drainTask, "mirlib_rx", DRAIN_TASK_STACK, this, DRAIN_TASK_PRIORITY, &m_drainTask) != pdPASS) {
+        m_drainTask = nullptr;
+        m_drain = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void RxSignal::end() {
+    if (m_drainTask == nullptr) {
+        m_drain = nullptr;
+        return;
+    }
+
+    // Delete the task only outside a drain
+    lockRadio();
+    vTaskDelete(m_drainTask);
+    m_drainTask = nullptr;
+    m_drain = nullptr;
+    unlockRadio();
+}
+
+void MIRLIB_ISR_ATTR RxSignal::requestDrainFromIsr() {
+    if (m_drainTask == nullptr) {
+        return;
+    }
+
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(m_drainTask, &woken);
+    if (woken == pdTRUE) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+void RxSignal::drainTask(void *arg) {
+    RxSignal *const self = static_cast<RxSignal *>(arg);
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        self->lockRadio();
+        if (self->m_drain != nullptr) {
+            self->m_drain(self->m_context);
+        }
+        self->unlockRadio();
+    }
+}
+
+void RxSignal::lockRadio() {
+    xSemaphoreTakeRecursive(m_radioMutex, portMAX_DELAY);
+}
+
+void RxSignal::unlockRadio() {
+    xSemaphoreGiveRecursive(m_radioMutex);
+}
+
+void RxSignal::notify() {
+    TaskHandle_t const waiter = m_waiter;
+    if (waiter != nullptr) {
+        xTaskNotifyGive(waiter);
+    }
+}
+
+void RxSignal::prepareWait() {
+    m_waiter = xTaskGetCurrentTaskHandle();
+}
+
+bool RxSignal::wait(uint32_t timeoutMs) {
+    return ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeoutMs)) != 0;
+}
+
+#elif defined(MIRLIB_PLATFORM_GCC)
+
+RxSignal::RxSignal()
+    : m_drain(nullptr)
+      , m_context(nullptr)
+      , m_pending(false)
+{
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&m_radioMutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+
+    pthread_mutex_init(&m_waitMutex, nullptr);
+    pthread_cond_init(&m_waitCond, nullptr);
+}
+
+RxSignal::~RxSignal() {
+    pthread_cond_destroy(&m_waitCond);
+    pthread_mutex_destroy(&m_waitMutex);
+    pthread_mutex_destroy(&m_radioMutex);
+}
+
+bool RxSignal::begin(DrainFunc drain, void *context) {
+    lockRadio();
+    m_context = context;
+    m_drain = drain;
+    unlockRadio();
+    return true;
+}
+
+void RxSignal::end() {
+    lockRadio();
+    m_drain = nullptr;
+    unlockRadio();
+}
+
+void RxSignal::requestDrainFromIsr() {
+    lockRadio();
+    if (m_drain != nullptr) {
+        m_drain(m_context);
+    }
+    unlockRadio();
+}
+
+void RxSignal::lockRadio() {
+    pthread_mutex_lock(&m_radioMutex);
+}
+
+void RxSignal::unlockRadio() {
+    pthread_mutex_unlock(&m_radioMutex);
+}
+
+void RxSignal::notify() {
+    pthread_mutex_lock(&m_waitMutex);
+    m_pending = true;
+    pthread_cond_signal(&m_waitCond);
+    pthread_mutex_unlock(&m_waitMutex);
+}
+
+void RxSignal::prepareWait() {
+}
+
+bool RxSignal::wait(uint32_t timeoutMs) {
+    timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeoutMs / 1000;
+    deadline.tv_nsec += static_cast<long>(timeoutMs % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    pthread_mutex_lock(&m_waitMutex);
+    while (!m_pending) {
+        if (pthread_cond_timedwait(&m_waitCond, &m_waitMutex, &deadline) == ETIMEDOUT) {
+            break;
+        }
+    }
+    bool const notified = m_pending;
+    m_pending = false;
+    pthread_mutex_unlock(&m_waitMutex);
+
+    return notified;
+}
+
+#else
+
+RxSignal::RxSignal()
+    : m_drain(nullptr)
+      , m_context(nullptr)
+      , m_lockDepth(0)
+      , m_deferred(false)
+      , m_pending(false)
+{
+}
+
+RxSignal::~RxSignal() {
+    end();
+}
+
+bool RxSignal::begin(DrainFunc drain, void *context) {
+    noInterrupts();
+    m_context = context;
+    m_drain = drain;
+    m_deferred = false;
+    interrupts();
+    return true;
+}
+
+void RxSignal::end() {
+    noInterrupts();
+    m_drain = nullptr;
+    m_deferred = false;
+    interrupts();
+}
+
+void RxSignal::requestDrainFromIsr() {
+    if (m_drain == nullptr) {
+        return;
+    }
+
+    // Main context is talking to the radio, drain on unlockRadio()
+    if (m_lockDepth != 0) {
+        m_deferred = true;
+        return;
+    }
+
+    m_lockDepth = 1;
+    m_drain(m_context);
+    m_lockDepth = 0;
+}
+
+void RxSignal::lockRadio() {
+    noInterrupts();
+    m_lockDepth = m_lockDepth + 1;
+    interrupts();
+}
+
+void RxSignal::unlockRadio() {
+    for (;;) {
+        noInterrupts();
+        bool const drain = m_lockDepth == 1 && m_deferred && m_drain != nullptr;
+        if (drain) {
+            m_deferred = false;
+        } else {
+            m_lockDepth = m_lockDepth - 1;
+        }
+        interrupts();
+
+        if (!drain) {
+            return;
+        }
+        m_drain(m_context);
+    }
+}
+
+void RxSignal::notify() {
+    m_pending = true;
+}
+
+void RxSignal::prepareWait() {
+}
+
+bool RxSignal::wait(uint32_t timeoutMs) {
+    uint32_t const start = millis();
+    while (!m_pending && millis() - start < timeoutMs) {
+        yield();
+    }
+
+    noInterrupts();
+    bool const notified = m_pending;
+    m_pending = false;
+    interrupts();
+
+    return notified;
+}
+
+#endif
@@ -0,0 +1,118 @@
+#ifndef RX_SIGNAL_H
+#define RX_SIGNAL_H
+
+#include <Arduino.h>
+#include "ProtocolTypes.h"
+#include "MirlibDebug.h"
+
+#if defined(MIRLIB_PLATFORM_ESP32)
+  #include <freertos/FreeRTOS.h>
+  #include <freertos/task.h>
+  #include <freertos/semphr.h>
+#elif defined(MIRLIB_PLATFORM_GCC)
+  #include <pthread.h>
+#endif
+
+/**
+ * @brief Synchronization between the radio interrupt, the FIFO drain and a waiting receiver
+ *
+ * The radio interrupt calls requestDrainFromIsr(). The drain callback reads
+ * the FIFO and calls notify() for every queued frame; the receiver blocks
+ * in wait() instead of polling the radio.
+ *
+ * - ESP32: SPI is not usable from an ISR, so the ISR wakes a drain task by
+ *   task notification; the receiver sleeps on its own task notification.
+ *   Radio access is serialized with a recursive mutex.
+ * - AVR: the drain runs inside the ISR unless the main context holds the
+ *   radio (lockRadio), in which case it runs on unlockRadio(). wait() spins
+ *   on a RAM flag (no RTOS), without SPI traffic.
+ * - GCC (host): the "ISR" is the thread of a simulated radio; the drain runs
+ *   on that thread under the radio mutex, wait() uses a condition variable.
+ */
+class RxSignal {
+public:
+    /**
+     * @brief FIFO drain callback, runs with the radio locked
+     */
+    typedef void (*DrainFunc)(void *context);
+
+    RxSignal();
+    ~RxSignal();
+
+    RxSignal(const RxSignal &) = delete;
+    RxSignal &operator=(const RxSignal &) = delete;
+
+    /**
+     * @brief Start accepting drain requests
+     * @param drain Drain callback
+     * @param context Callback context
+     * @return false if the drain task could not be created (ESP32)
+     */
+    bool begin(DrainFunc drain, void *context);
+
+    /**
+     * @brief Stop accepting drain requests (drain task is deleted on ESP32)
+     */
+    void end();
+
+    /**
+     * @brief Check if begin() succeeded and end() was not called
+     */
+    bool active() const { return m_drain != nullptr; }
+
+    /**
+     * @brief Request a FIFO drain (interrupt context)
+     */
+    void requestDrainFromIsr();
+
+    /**
+     * @brief Take exclusive radio access (main context, may nest)
+     */
+    void lockRadio();
+
+    /**
+     * @brief Release radio access, running a drain deferred meanwhile (AVR)
+     */
+    void unlockRadio();
+
+    /**
+     * @brief Signal that a frame was queued (drain context)
+     */
+    void notify();
+
+    /**
+     * @brief Register the calling task as the receiver; call before checking the queue
+     */
+    void prepareWait();
+
+    /**
+     * @brief Block until notify() or timeout
+     * Wakeups may be spurious, the caller re-checks its queue
+     * @param timeoutMs Timeout in ms
+     * @return true if notified
+     */
+    bool wait(uint32_t timeoutMs);
+
+private:
+    DrainFunc m_drain;
+    void *m_context;
+
+#if defined(MIRLIB_PLATFORM_ESP32)
+    TaskHandle_t m_drainTask;
+    volatile TaskHandle_t m_waiter;
+    SemaphoreHandle_t m_radioMutex;
+
+    static void drainTask(void *arg);
+#elif defined(MIRLIB_PLATFORM_GCC)
+    pthread_mutex_t m_radioMutex;
+    pthread_mutex_t m_waitMutex;
+    pthread_cond_t m_waitCond;
+    bool m_pending;
+#else
+    volatile uint8_t m_lockDepth;
+    volatile bool m_deferred;
+    volatile bool m_pending;
+#endif
+};
+
+#endif // RX_SIGNAL_H
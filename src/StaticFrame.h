@@ -0,0 +1,203 @@
+#ifndef STATIC_FRAME_H
+#define STATIC_FRAME_H
+
+#include <Arduino.h>
+#include "ProtocolTypes.h"
+#include "Crc8Engine.h"
+
+#ifdef MIRLIB_PLATFORM_GCC
+  #ifndef memcpy_P
+    #define memcpy_P(dest, src, size) memcpy((dest), (src), (size))
+  #endif
+#endif
+
+/**
+ * @brief Ready-to-send raw frame stored in flash (PROGMEM on AVR)
+ *
+ * Produced by StaticRequestFrame; header fields are kept next to the bytes
+ * so the frame can be checked and matched against responses without decoding.
+ */
+struct FlashFrame {
+    const uint8_t *bytes; ///< Raw frame with start/stop bytes (PROGMEM on AVR)
+    uint8_t size; ///< Raw frame size
+    uint8_t command; ///< Command code
+    uint16_t destAddress; ///< Destination address
+    uint16_t srcAddress; ///< Source address
+
+    /**
+     * @brief Copy the frame into RAM
+     * @param buffer Output buffer (at least size bytes)
+     */
+    void copyTo(uint8_t *buffer) const {
+        memcpy_P(buffer, bytes, size);
+    }
+};
+
+/**
+ * @brief constexpr helpers for compile-time frame encoding (C++11 single-return style)
+ *
+ * Byte packs are the unstuffed frame from Parameters to CRC inclusive.
+ */
+class StaticFrameBuilder {
+public:
+    /**
+     * @brief CRC8 over a byte pack
+     */
+    static constexpr uint8_t crc(uint8_t value) {
+        return value;
+    }
+
+    template<typename... Rest>
+    static constexpr uint8_t crc(uint8_t value, uint8_t first, Rest... rest) {
+        return crc(Crc8Engine::tableEntry(static_cast<uint8_t>(value ^ first), 0), rest...);
+    }
+
+    /**
+     * @brief Check if a byte has to be stuffed
+     */
+    static constexpr bool isSpecial(uint8_t value) {
+        return value == 0x55 || value == 0x73;
+    }
+
+    /**
+     * @brief Stuffed size of a byte pack (without start/stop bytes)
+     */
+    static constexpr size_t stuffedSize() {
+        return 0;
+    }
+
+    template<typename... Rest>
+    static constexpr size_t stuffedSize(uint8_t first, Rest... rest) {
+        return (isSpecial(first) ? 2 : 1) + stuffedSize(rest...);
+    }
+
+    /**
+     * @brief Byte at a position of the stuffed byte pack
+     */
+    static constexpr uint8_t stuffedByte(size_t) {
+        return 0;
+    }
+
+    template<typename... Rest>
+    static constexpr uint8_t stuffedByte(size_t index, uint8_t first, Rest... rest) {
+        return !isSpecial(first)
+                   ? (index == 0 ? first : stuffedByte(index - 1, rest...))
+                   : (index == 0
+                          ? ProtocolConstants::STUFF_MARKER
+                          : index == 1
+                                ? (first == 0x55 ? ProtocolConstants::STUFF_0x55 : ProtocolConstants::STUFF_0x73)
+                                : stuffedByte(index - 2, rest...));
+    }
+
+    /**
+     * @brief Byte at a position of the raw frame (start bytes, stuffed body, stop byte)
+     */
+    template<typename... Bytes>
+    static constexpr uint8_t rawByte(size_t index, size_t rawSize, Bytes... bytes) {
+        return index == 0
+                   ? ProtocolConstants::START1
+                   : index == 1
+                         ? ProtocolConstants::START2
+                         : index == rawSize - 1
+                               ? ProtocolConstants::STOP
+                               : stuffedByte(index - 2, bytes...);
+    }
+
+    /**
+     * @brief Compile-time index list 0..N-1 (no STL)
+     */
+    template<size_t... Indices>
+    struct IndexList {
+    };
+
+    template<size_t N, size_t... Indices>
+    struct MakeIndexList : MakeIndexList<N - 1, N - 1, Indices...> {
+    };
+
+    template<size_t... Indices>
+    struct MakeIndexList<0, Indices...> {
+        typedef IndexList<Indices...> Type;
+    };
+};
+
+/**
+ * @brief Raw frame for an unstuffed byte pack, generated at compile time
+ */
+template<typename Indices, uint8_t... Bytes>
+struct StaticFrameData;
+
+template<size_t... Indices, uint8_t... Bytes>
+struct StaticFrameData<StaticFrameBuilder::IndexList<Indices...>, Bytes...> {
+    static const uint8_t BYTES[sizeof...(Indices)];
+};
+
+template<size_t... Indices, uint8_t... Bytes>
+const uint8_t StaticFrameData<StaticFrameBuilder::IndexList<Indices...>, Bytes...>::BYTES[sizeof...(Indices)] PROGMEM = {
+    StaticFrameBuilder::rawByte(Indices, sizeof...(Indices), Bytes...)...
+};
+
+/**
+ * @brief Frame from an unstuffed byte pack (Parameters..Data), CRC appended at compile time
+ */
+template<uint8_t... Bytes>
+struct StaticFrame {
+    static const uint8_t CRC = StaticFrameBuilder::crc(ProtocolConstants::CRC_INITIAL, Bytes...);
+    static const size_t SIZE = StaticFrameBuilder::stuffedSize(Bytes..., CRC) + ProtocolConstants::FRAMING_SIZE;
+
+    typedef StaticFrameData<typename StaticFrameBuilder::MakeIndexList<SIZE>::Type, Bytes..., CRC> Data;
+
+    static_assert(SIZE <= ProtocolConstants::MAX_PACKET_SIZE, "Mirlib: stuffed frame exceeds MAX_PACKET_SIZE");
+};
+
+/**
+ * @brief Request frame built entirely at compile time
+ *
+ * Encodes exactly what createRequestPacket + packPacket would produce
+ * (direction = request, version = 0, encoding = 0), e.g.
+ * @code
+ * typedef StaticRequestFrame<0x05, 0x1234, 0xFFFF, 0, ACTIVE_FORWARD> StatusRequest;
+ * client.readStatus(StatusRequest::frame(), nullptr, &response);
+ * @endcode
+ * @tparam Command Command code
+ * @tparam DestAddress Destination (meter) address
+ * @tparam SrcAddress Source (client) address
+ * @tparam Password Password
+ * @tparam Data Request data bytes
+ */
+template<uint8_t Command, uint16_t DestAddress, uint16_t SrcAddress, uint32_t Password, uint8_t... Data>
+class StaticRequestFrame {
+    static_assert(sizeof...(Data) <= ProtocolConstants::MAX_DATA_SIZE, "Mirlib: request data exceeds MAX_DATA_SIZE");
+
+    typedef StaticFrame<
+        static_cast<uint8_t>(0x20 | sizeof...(Data)), // Parameters: request, version 0, not encoded
+        0x00, // Reserve
+        static_cast<uint8_t>(DestAddress & 0xFF), static_cast<uint8_t>(DestAddress >> 8),
+        static_cast<uint8_t>(SrcAddress & 0xFF), static_cast<uint8_t>(SrcAddress >> 8),
+        Command,
+        static_cast<uint8_t>(Password & 0xFF), static_cast<uint8_t>((Password >> 8) & 0xFF),
+        static_cast<uint8_t>((Password >> 16) & 0xFF), static_cast<uint8_t>(Password >> 24),
+        Data...> Frame;
+
+public:
+    static const size_t SIZE = Frame::SIZE; ///< Raw frame size
+
+    /**
+     * @brief Raw frame bytes (PROGMEM on AVR)
+     */
+    static const uint8_t *bytes() { return Frame::Data::BYTES; }
+
+    /**
+     * @brief Frame descriptor for MirlibClient / MirlibBase
+     */
+    static FlashFrame frame() {
+        FlashFrame result;
+        result.bytes = Frame::Data::BYTES;
+        result.size = SIZE;
+        result.command = Command;
+        result.destAddress = DestAddress;
+        result.srcAddress = SrcAddress;
+        return result;
+    }
+};
+
+#endif // STATIC_FRAME_H
@@ -0,0 +1,365 @@
+#include "StuffingEngine.h"
+
+#if defined(MIRLIB_STUFFING_HAS_X86)
+  #include <immintrin.h>
+#elif defined(MIRLIB_STUFFING_HAS_NEON)
+  #include <arm_neon.h>
+#endif
+
+namespace {
+    /**
+     * @brief Scalar stuffing from a given input/output position
+     *
+     * Fails when a byte starts at or after outputMaxSize - 1 (one byte is
+     * always reserved for a potential escape pair).
+     */
+    size_t stuffFrom(const uint8_t *input, size_t inputSize, size_t inputIndex,
+                     uint8_t *output, size_t outputMaxSize, size_t outputIndex) {
+        for (size_t i = inputIndex; i < inputSize; i++) {
+            if (outputIndex >= outputMaxSize - 1) {
+                // Reserve space for potential stuffing
+                return 0; // Not enough space
+            }
+
+            uint8_t const currentByte = input[i];
+
+            if (currentByte == 0x55) {
+                // Replace 0x55 with 0x73 0x11
+                output[outputIndex++] = ProtocolConstants::STUFF_MARKER;
+                output[outputIndex++] = ProtocolConstants::STUFF_0x55;
+            } else if (currentByte == 0x73) {
+                // Replace 0x73 with 0x73 0x22
+                output[outputIndex++] = ProtocolConstants::STUFF_MARKER;
+                output[outputIndex++] = ProtocolConstants::STUFF_0x73;
+            } else {
+                // Regular byte, copy as is
+                output[outputIndex++] = currentByte;
+            }
+        }
+
+        return outputIndex;
+    }
+
+    /**
+     * @brief Unstuff one escape pair starting at input[inputIndex] (a marker byte)
+     * @return false if an invalid pair does not fit into the output
+     */
+    bool unstuffPair(const uint8_t *input, size_t inputSize, size_t &inputIndex,
+                     uint8_t *output, size_t outputMaxSize, size_t &outputIndex) {
+        uint8_t const currentByte = input[inputIndex++];
+
+        if (inputIndex >= inputSize) {
+            // Marker at the end of input, copy as is
+            output[outputIndex++] = currentByte;
+            return true;
+        }
+
+        uint8_t const nextByte = input[inputIndex++];
+
+        if (nextByte == ProtocolConstants::STUFF_0x55) {
+            // 0x73 0x11 -> 0x55
+            output[outputIndex++] = 0x55;
+        } else if (nextByte == ProtocolConstants::STUFF_0x73) {
+            // 0x73 0x22 -> 0x73
+            output[outputIndex++] = 0x73;
+        } else {
+            // Invalid stuffing, copy both bytes
+            if (outputIndex >= outputMaxSize - 1) {
+                return false;
+            }
+            output[outputIndex++] = currentByte;
+            output[outputIndex++] = nextByte;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Scalar unstuffing from a given input/output position
+     *
+     * Stops silently when the output is full; an invalid pair that does not
+     * fit is an error.
+     */
+    size_t unstuffFrom(const uint8_t *input, size_t inputSize, size_t inputIndex,
+                       uint8_t *output, size_t outputMaxSize, size_t outputIndex) {
+        while (inputIndex < inputSize && outputIndex < outputMaxSize) {
+            if (input[inputIndex] == ProtocolConstants::STUFF_MARKER) {
+                if (!unstuffPair(input, inputSize, inputIndex, output, outputMaxSize, outputIndex)) {
+                    return 0;
+                }
+            } else {
+                // Regular byte, copy as is
+                output[outputIndex++] = input[inputIndex++];
+            }
+        }
+
+        return outputIndex;
+    }
+
+#if defined(MIRLIB_STUFFING_HAS_X86) || defined(MIRLIB_STUFFING_HAS_NEON)
+    inline unsigned lowestBit(uint64_t mask) {
+        return static_cast<unsigned>(__builtin_ctzll(mask));
+    }
+
+    /**
+     * @brief Block stuffing kernel
+     *
+     * Vec provides WIDTH, LANE_SHIFT (mask bits per lane = 1 << LANE_SHIFT,
+     * one of them set per match), copy() and matchSpecial()/matchMarker()
+     * returning a lane mask.
+     */
+    template<typename Vec>
+    inline size_t stuffBlocks(const uint8_t *input, size_t inputSize, uint8_t *output, size_t outputMaxSize) {
+        if ((input == nullptr) || (output == nullptr) || inputSize == 0 || outputMaxSize == 0) {
+            return 0;
+        }
+
+        size_t i = 0;
+        size_t out = 0;
+
+        // Block copy with zero padding: runs are copied with whole-vector stores
+        uint8_t block[2 * Vec::WIDTH];
+        memset(block + Vec::WIDTH, 0, Vec::WIDTH);
+
+        // Room for a fully stuffed block plus one vector store past it, so no per-byte bounds checks
+        while (i + Vec::WIDTH <= inputSize && out + 3 * Vec::WIDTH <= outputMaxSize) {
+            uint64_t mask = Vec::matchSpecial(input + i);
+
+            if (mask == 0) {
+                Vec::copy(output + out, input + i);
+                i += Vec::WIDTH;
+                out += Vec::WIDTH;
+                continue;
+            }
+
+            Vec::copy(block, input + i);
+
+            size_t run = 0;
+            do {
+                size_t const lane = lowestBit(mask) >> Vec::LANE_SHIFT;
+                mask &= mask - 1;
+
+                // Bytes past the run are overwritten by the escape pair and the next store
+                Vec::copy(output + out, block + run);
+                out += lane - run;
+
+                output[out++] = ProtocolConstants::STUFF_MARKER;
+                output[out++] = (block[lane] == 0x55) ? ProtocolConstants::STUFF_0x55
+                                                      : ProtocolConstants::STUFF_0x73;
+                run = lane + 1;
+            } while (mask != 0);
+
+            Vec::copy(output + out, block + run);
+            out += Vec::WIDTH - run;
+            i += Vec::WIDTH;
+        }
+
+        return stuffFrom(input, inputSize, i, output, outputMaxSize, out);
+    }
+
+    /**
+     * @brief Block unstuffing kernel (output may alias input)
+     */
+    template<typename Vec>
+    inline size_t unstuffBlocks(const uint8_t *input, size_t inputSize, uint8_t *output, size_t outputMaxSize) {
+        if ((input == nullptr) || (output == nullptr) || inputSize == 0) {
+            return 0;
+        }
+
+        size_t i = 0;
+        size_t out = 0;
+
+        // Whole-vector run copies are only safe when output does not alias unread input
+        uintptr_t const inputBegin = reinterpret_cast<uintptr_t>(input);
+        uintptr_t const outputBegin = reinterpret_cast<uintptr_t>(output);
+        bool const disjoint = outputBegin + outputMaxSize <= inputBegin || inputBegin + inputSize <= outputBegin;
+
+        while (i + Vec::WIDTH <= inputSize && out + Vec::WIDTH <= outputMaxSize) {
+            uint64_t const mask = Vec::matchMarker(input + i);
+
+            if (mask == 0) {
+                // Load precedes store, safe when unstuffing in place
+                Vec::copy(output + out, input + i);
+                i += Vec::WIDTH;
+                out += Vec::WIDTH;
+                continue;
+            }
+
+            size_t const lane = lowestBit(mask) >> Vec::LANE_SHIFT;
+            if (disjoint) {
+                Vec::copy(output + out, input + i);
+            } else {
+                memmove(output + out, input + i, lane);
+            }
+            i += lane;
+            out += lane;
+
+            if (!unstuffPair(input, inputSize, i, output, outputMaxSize, out)) {
+                return 0;
+            }
+        }
+
+        return unstuffFrom(input, inputSize, i, output, outputMaxSize, out);
+    }
+#endif
+
+#ifdef MIRLIB_STUFFING_HAS_X86
+    struct Sse2Vec {
+        static const size_t WIDTH = 16;
+        static const unsigned LANE_SHIFT = 0;
+
+        static void copy(uint8_t *dst, const uint8_t *src) {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst),
+                             _mm_loadu_si128(reinterpret_cast<const __m128i *>(src)));
+        }
+
+        static uint64_t matchSpecial(const uint8_t *src) {
+            __m128i const v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+            __m128i const hit = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(0x55)),
+                                             _mm_cmpeq_epi8(v, _mm_set1_epi8(0x73)));
+            return static_cast<uint32_t>(_mm_movemask_epi8(hit));
+        }
+
+        static uint64_t matchMarker(const uint8_t *src) {
+            __m128i const v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+            return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(0x73))));
+        }
+    };
+
+    #define MIRLIB_TARGET_AVX2 __attribute__((target("avx2")))
+
+    struct Avx2Vec {
+        static const size_t WIDTH = 32;
+        static const unsigned LANE_SHIFT = 0;
+
+        MIRLIB_TARGET_AVX2 static void copy(uint8_t *dst, const uint8_t *src) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst),
+                                _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src)));
+        }
+
+        MIRLIB_TARGET_AVX2 static uint64_t matchSpecial(const uint8_t *src) {
+            __m256i const v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src));
+            __m256i const hit = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(0x55)),
+                                                _mm256_cmpeq_epi8(v, _mm256_set1_epi8(0x73)));
+            return static_cast<uint32_t>(_mm256_movemask_epi8(hit));
+        }
+
+        MIRLIB_TARGET_AVX2 static uint64_t matchMarker(const uint8_t *src) {
+            __m256i const v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src));
+            return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(0x73))));
+        }
+    };
+#endif
+
+#ifdef MIRLIB_STUFFING_HAS_NEON
+    struct NeonVec {
+        static const size_t WIDTH = 16;
+        static const unsigned LANE_SHIFT = 2;
+
+        static void copy(uint8_t *dst, const uint8_t *src) {
+            vst1q_u8(dst, vld1q_u8(src));
+        }
+
+        /**
+         * @brief Narrow a byte compare result to 4 bits per lane, lowest bit set on match
+         */
+        static uint64_t toMask(uint8x16_t hit) {
+            uint8x16_t const bits = vandq_u8(hit, vdupq_n_u8(0x11));
+            uint8x8_t const narrowed = vshrn_n_u16(vreinterpretq_u16_u8(bits), 4);
+            return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0);
+        }
+
+        static uint64_t matchSpecial(const uint8_t *src) {
+            uint8x16_t const v = vld1q_u8(src);
+            return toMask(vorrq_u8(vceqq_u8(v, vdupq_n_u8(0x55)), vceqq_u8(v, vdupq_n_u8(0x73))));
+        }
+
+        static uint64_t matchMarker(const uint8_t *src) {
+            return toMask(vceqq_u8(vld1q_u8(src), vdupq_n_u8(0x73)));
+        }
+    };
+#endif
+}
+
+size_t StuffingEngine::stuffScalar(const uint8_t *input, size_t inputSize, uint8_t *output, size_t outputMaxSize) {
+    if ((input == nullptr) || (output == nullptr) || inputSize == 0 || outputMaxSize == 0) {
+        return 0;
+    }
+
+    return stuffFrom(input, inputSize, 0, output, outputMaxSize, 0);
+}
+
+size_t StuffingEngine::unstuffScalar(const uint8_t *input, size_t inputSize, uint8_t *output, size_t outputMaxSize) {
+    if ((input == nullptr) || (output == nullptr) || inputSize == 0) {
+        return 0;
+    }
+
+    return unstuffFrom(input, inputSize, 0, output, outputMaxSize, 0);
+}
+
+#ifdef MIRLIB_STUFFING_HAS_X86
+size_t StuffingEngine::stuffSse2(const uint8_t *input, size_t inputSize, uint8_t *output, size_t outputMaxSize) {
+    return stuffBlocks<Sse2Vec>(input, inputSize, output, outputMaxSize);
+}
+
+size_t StuffingEngine::unstuffSse2(const uint8_t *input, size_t inputSize, uint8_t *output, size_t outputMaxSize) {
+    return unstuffBlocks<Sse2Vec>(input, inputSize, output, outputMaxSize);
+}
+
+// flatten inlines the generic kernel and the AVX2 helpers into an AVX2-enabled function
+MIRLIB_TARGET_AVX2 __attribute__((flatten))
+size_t StuffingEngine::stuffAvx2(const uint8_t *input, size_t inputSize, uint8_t *output, size_t outputMaxSize) {
+    return stuffBlocks<Avx2Vec>(input, inputSize, output, outputMaxSize);
+}
+
+MIRLIB_TARGET_AVX2 __attribute__((flatten))
+size_t StuffingEngine::unstuffAvx2(const uint8_t *input, size_t inputSize, uint8_t *output, size_t outputMaxSize) {
+    return unstuffBlocks<Avx2Vec>(input, inputSize, output, outputMaxSize);
+}
+
+bool StuffingEngine::hasAvx2() {
+    return __builtin_cpu_supports("avx2") != 0;
+}
+#endif
+
+#ifdef MIRLIB_STUFFING_HAS_NEON
+size_t StuffingEngine::stuffNeon(const uint8_t *input, size_t inputSize, uint8_t *output, size_t outputMaxSize) {
+    return stuffBlocks<NeonVec>(input, inputSize, output, outputMaxSize);
+}
+
+size_t StuffingEngine::unstuffNeon(const uint8_t *input, size_t inputSize, uint8_t *output, size_t outputMaxSize) {
+    return unstuffBlocks<NeonVec>(input, inputSize, output, outputMaxSize);
+}
+#endif
+
+size_t StuffingEngine::stuff(const uint8_t *input, size_t inputSize, uint8_t *output, size_t outputMaxSize) {
+#if defined(MIRLIB_STUFFING_HAS_X86)
+    // Selected once on first use
+    static const KernelFunc kernel = hasAvx2() ? stuffAvx2 : stuffSse2;
+    return kernel(input, inputSize, output, outputMaxSize);
+#elif defined(MIRLIB_STUFFING_HAS_NEON)
+    return stuffNeon(input, inputSize, output, outputMaxSize);
+#else
+    return stuffScalar(input, inputSize, output, outputMaxSize);
+#endif
+}
+
+size_t StuffingEngine::unstuff(const uint8_t *input, size_t inputSize, uint8_t *output, size_t outputMaxSize) {
+#if defined(MIRLIB_STUFFING_HAS_X86)
+    static const KernelFunc kernel = hasAvx2() ? unstuffAvx2 : unstuffSse2;
+    return kernel(input, inputSize, output, outputMaxSize);
+#elif defined(MIRLIB_STUFFING_HAS_NEON)
+    return unstuffNeon(input, inputSize, output, outputMaxSize);
+#else
+    return unstuffScalar(input, inputSize, output, outputMaxSize);
+#endif
+}
+
+const char *StuffingEngine::kernelName() {
+#if defined(MIRLIB_STUFFING_HAS_X86)
+    return hasAvx2() ? "AVX2" : "SSE2";
+#elif defined(MIRLIB_STUFFING_HAS_NEON)
+    return "NEON";
+#else
+    return "SCALAR";
+#endif
+}
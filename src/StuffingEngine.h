@@ -0,0 +1,103 @@
+#ifndef STUFFING_ENGINE_H
+#define STUFFING_ENGINE_H
+
+#include <Arduino.h>
+#include "ProtocolTypes.h"
+#include "MirlibDebug.h"
+
+/**
+ * @brief Byte stuffing kernels
+ *
+ * SCALAR - byte-at-a-time loop (AVR, ESP32 and fallback)
+ * SSE2   - 16 bytes per block (x86 host builds)
+ * AVX2   - 32 bytes per block (x86 host builds, selected at runtime)
+ * NEON   - 16 bytes per block (ARM host builds)
+ *
+ * SIMD kernels are only built for host (GCC/Clang) targets; define
+ * MIRLIB_STUFFING_NO_SIMD to force the scalar path everywhere.
+ */
+#if defined(MIRLIB_PLATFORM_GCC) && !defined(MIRLIB_STUFFING_NO_SIMD)
+  #if defined(__x86_64__) || (defined(__i386__) && defined(__SSE2__))
+    #define MIRLIB_STUFFING_HAS_X86
+  #elif defined(__ARM_NEON) || defined(__aarch64__)
+    #define MIRLIB_STUFFING_HAS_NEON
+  #endif
+#endif
+
+/**
+ * @brief Byte stuffing (0x55 -> 0x73 0x11, 0x73 -> 0x73 0x22) and unstuffing
+ *
+ * All kernels produce identical output and return values; the SIMD ones
+ * locate 0x55/0x73 a block at a time and copy the runs in between,
+ * falling back to the scalar rules near the end of input or output.
+ */
+class StuffingEngine {
+public:
+    /**
+     * @brief Kernel signature (same contract as ProtocolUtils::byteStuffing/byteUnstuffing)
+     */
+    typedef size_t (*KernelFunc)(const uint8_t *input, size_t inputSize,
+                                 uint8_t *output, size_t outputMaxSize);
+
+    /**
+     * @brief Stuff data with the best kernel for this platform
+     * @param input Input data
+     * @param inputSize Input data size
+     * @param output Output buffer
+     * @param outputMaxSize Maximum output buffer size
+     * @return Actual output size, 0 if error
+     */
+    static size_t stuff(const uint8_t *input, size_t inputSize, uint8_t *output, size_t outputMaxSize);
+
+    /**
+     * @brief Unstuff data with the best kernel for this platform
+     *
+     * Output may alias input (in-place unstuffing).
+     * @param input Input stuffed data
+     * @param inputSize Input data size
+     * @param output Output buffer
+     * @param outputMaxSize Maximum output buffer size
+     * @return Actual output size, 0 if error
+     */
+    static size_t unstuff(const uint8_t *input, size_t inputSize, uint8_t *output, size_t outputMaxSize);
+
+    /**
+     * @brief Name of the kernel used by stuff()/unstuff() ("SCALAR", "SSE2", "AVX2", "NEON")
+     */
+    static const char *kernelName();
+
+    /**
+     * @brief Byte-at-a-time kernels (reference implementation)
+     */
+    static size_t stuffScalar(const uint8_t *input, size_t inputSize, uint8_t *output, size_t outputMaxSize);
+    static size_t unstuffScalar(const uint8_t *input, size_t inputSize, uint8_t *output, size_t outputMaxSize);
+
+#ifdef MIRLIB_STUFFING_HAS_X86
+    /**
+     * @brief SSE2 kernels (16-byte blocks)
+     */
+    static size_t stuffSse2(const uint8_t *input, size_t inputSize, uint8_t *output, size_t outputMaxSize);
+    static size_t unstuffSse2(const uint8_t *input, size_t inputSize, uint8_t *output, size_t outputMaxSize);
+
+    /**
+     * @brief AVX2 kernels (32-byte blocks), only call when hasAvx2() is true
+     */
+    static size_t stuffAvx2(const uint8_t *input, size_t inputSize, uint8_t *output, size_t outputMaxSize);
+    static size_t unstuffAvx2(const uint8_t *input, size_t inputSize, uint8_t *output, size_t outputMaxSize);
+
+    /**
+     * @brief Check AVX2 support of the running CPU
+     */
+    static bool hasAvx2();
+#endif
+
+#ifdef MIRLIB_STUFFING_HAS_NEON
+    /**
+     * @brief NEON kernels (16-byte blocks)
+     */
+    static size_t stuffNeon(const uint8_t *input, size_t inputSize, uint8_t *output, size_t outputMaxSize);
+    static size_t unstuffNeon(const uint8_t *input, size_t inputSize, uint8_t *output, size_t outputMaxSize);
+#endif
+};
+
+#endif // STUFFING_ENGINE_H